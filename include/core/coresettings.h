@@ -57,6 +57,11 @@ enum CoreSettings : uint32_t
     ExternalSortScript      = 18 | Type::String,
     Shutdown                = 19 | Type::Bool,
     StopAfterCurrent        = 20 | Type::Bool,
+    ReplayGainMode          = 21 | Type::Int,
+    ReplayGainPreAmp        = 22 | Type::Double,
+    ReplayGainNoClipping    = 23 | Type::Bool,
+    DspChain                = 24 | Type::StringList,
+    EqualiserGains          = 25 | Type::Variant,
 
 };
 Q_ENUM_NS(CoreSettings)
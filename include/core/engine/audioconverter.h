@@ -30,5 +30,10 @@ namespace Audio {
 FYCORE_EXPORT AudioBuffer convert(const AudioBuffer& buffer, const AudioFormat& outputFormat);
 FYCORE_EXPORT bool convert(const AudioFormat& inputFormat, const std::byte* input, const AudioFormat& outputFormat,
                            std::byte* output, int sampleCount);
+/** Multiplies @p frameCount frames of @p data by @p gain in place, saturating integer samples. */
+FYCORE_EXPORT void applyGain(const AudioFormat& format, std::byte* data, int frameCount, float gain);
+/** Interleaves @p frameCount frames of planar audio, with one plane per channel in @p planes, into @p output. */
+FYCORE_EXPORT void interleave(const std::byte* const* planes, int channels, int bytesPerSample, int frameCount,
+                              std::byte* output);
 }; // namespace Audio
 } // namespace Fooyin
@@ -21,6 +21,7 @@
 
 #include "fycore_export.h"
 
+#include <core/engine/dspnode.h>
 #include <core/engine/outputplugin.h>
 
 #include <QLoggingCategory>
@@ -65,6 +66,14 @@ public:
     [[nodiscard]] TrackStatus trackStatus() const;
 
     virtual void changeTrack(const Track& track) = 0;
+    /*!
+     * Called with the track expected to play after the current one, once the current track has been fully
+     * decoded. Engines can use this to open the track early for gapless playback.
+     * It may be called again if the expected track changes, in which case any track already opened should be
+     * dropped.
+     * @note the base class implementation of this function does nothing.
+     */
+    virtual void prepareNextTrack(const Track& track);
 
     virtual void play()  = 0;
     virtual void pause() = 0;
@@ -76,6 +85,12 @@ public:
     virtual void setAudioOutput(const OutputCreator& output, const QString& device) = 0;
     virtual void setOutputDevice(const QString& device)                             = 0;
 
+    /*!
+     * Replaces the DSP chain with @p chain, in order.
+     * @note the base class implementation of this function does nothing.
+     */
+    virtual void setDspChain(const DspEntries& chain);
+
 signals:
     void deviceError(const QString& error);
     void stateChanged(PlaybackState state);
@@ -55,6 +55,11 @@ public:
     [[nodiscard]] bool isArchive(const QString& file) const;
     [[nodiscard]] AudioDecoder* decoderForFile(const QString& file) const;
     [[nodiscard]] AudioDecoder* decoderForTrack(const Track& track) const;
+    /*!
+     * Returns a new decoder for @p track owned by the caller, rather than the shared instance for
+     * the calling thread. Useful for decoding more than one track at a time on the same thread.
+     */
+    [[nodiscard]] std::unique_ptr<AudioDecoder> createDecoderForTrack(const Track& track) const;
     [[nodiscard]] AudioReader* readerForFile(const QString& file) const;
     [[nodiscard]] AudioReader* readerForTrack(const Track& track) const;
     [[nodiscard]] ArchiveReader* archiveReaderForFile(const QString& file) const;
@@ -114,11 +114,21 @@ public:
 
     virtual void setPaused(bool pause) = 0;
 
+    /*!
+     * Returns true if the audio driver applies volume itself through @fn setVolume.
+     * If not, volume is applied to the samples before they're passed to @fn write.
+     */
+    [[nodiscard]] virtual bool supportsVolume() const
+    {
+        return false;
+    }
+
     /*!
      * Set's the volume of the audio driver.
-     * @note this may be called regardless of the current initialised state.
+     * @note this is only called if @fn supportsVolume returns true, and may be called regardless
+     * of the current initialised state.
      */
-    virtual void setVolume(double volume) = 0;
+    virtual void setVolume(double /*volume*/) { }
 
     /*!
      * Set's the device for this driver.
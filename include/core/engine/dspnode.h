@@ -0,0 +1,103 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/engine/audioformat.h>
+
+#include <QString>
+#include <QVariant>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Fooyin {
+/*!
+ * An abstract interface for a DSP processor.
+ *
+ * Processors operate in place on interleaved float samples. Before any audio is processed, @fn prepare
+ * is called with the format and the block size negotiated for the chain, and every call to @fn process
+ * will then pass at most that many frames.
+ *
+ * All functions are called from the audio rendering thread.
+ */
+class FYCORE_EXPORT DspNode
+{
+public:
+    virtual ~DspNode() = default;
+
+    [[nodiscard]] virtual QString name() const = 0;
+
+    /*!
+     * Returns the largest block, in frames, this processor can handle in one call to @fn process.
+     * The chain uses the smallest of all processors' limits.
+     * @note the default implementation returns 0 (no limit).
+     */
+    [[nodiscard]] virtual int maxBlockFrames() const
+    {
+        return 0;
+    }
+
+    /*!
+     * Applies the settings passed with this processor's entry in the chain. Called once the processor is
+     * created, and again whenever the settings change. May be called before or after @fn prepare.
+     * @note the default implementation does nothing.
+     */
+    virtual void setSettings(const QVariant& /*settings*/) { }
+
+    /*!
+     * Prepares the processor for audio of @p format in blocks of up to @p blockFrames frames.
+     * Returns false if the format is unsupported, in which case the processor is bypassed.
+     * @note the format's sample format is always F32.
+     */
+    virtual bool prepare(const AudioFormat& format, int blockFrames) = 0;
+
+    /** Processes @p frameCount interleaved frames of @p data in place. */
+    virtual void process(float* data, int frameCount) = 0;
+
+    /*!
+     * Clears any internal state, such as filter history.
+     * Called when playback is reset, e.g. on seek or track change.
+     * @note the default implementation does nothing.
+     */
+    virtual void reset() { }
+
+    /*!
+     * Returns the delay, in frames, added to audio passing through this processor.
+     * @note the default implementation returns 0.
+     */
+    [[nodiscard]] virtual int latency() const
+    {
+        return 0;
+    }
+};
+using DspCreator = std::function<std::unique_ptr<DspNode>()>;
+
+struct DspEntry
+{
+    QString name;
+    DspCreator creator;
+    // Passed to DspNode::setSettings
+    QVariant settings;
+};
+using DspEntries = std::vector<DspEntry>;
+} // namespace Fooyin
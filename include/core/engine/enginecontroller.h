@@ -23,6 +23,7 @@
 
 #include <core/engine/audioengine.h>
 #include <core/engine/audiooutput.h>
+#include <core/engine/dspnode.h>
 
 #include <QObject>
 
@@ -30,6 +31,7 @@ namespace Fooyin {
 struct AudioOutputBuilder;
 
 using OutputNames = std::vector<QString>;
+using DspNames    = std::vector<QString>;
 
 class FYCORE_EXPORT EngineController : public QObject
 {
@@ -54,6 +56,18 @@ public:
      */
     virtual void addOutput(const QString& name, OutputCreator output) = 0;
 
+    /** Returns a list of all DSP names. */
+    [[nodiscard]] virtual DspNames getAllDsps() const = 0;
+
+    /*!
+     * Adds a DSP processor, which can then be enabled using Settings::Core::DspChain.
+     * @note name must be unique.
+     */
+    virtual void addDsp(const QString& name, DspCreator dsp) = 0;
+
+    /** Passes the track expected to play after the current one to the engine, so it can be opened early. */
+    virtual void prepareNextTrack(const Track& track) = 0;
+
 signals:
     void outputChanged(const QString& output, const QString& device);
     void deviceChanged(const QString& device);
@@ -57,6 +57,8 @@ struct ScanProgress
     int id{-1};
     int total{0};
     int current{0};
+    // Rate at which scanned tracks are being written to the database
+    int rowsPerSecond{0};
 
     [[nodiscard]] int percentage() const
     {
@@ -131,6 +133,10 @@ public:
     [[nodiscard]] virtual Track trackForId(int id) const = 0;
     /** Returns a TrackList containing each track (if) found with an id from @p ids  */
     [[nodiscard]] virtual TrackList tracksForIds(const TrackIds& ids) const = 0;
+    /** Returns all tracks stored in @p filepath (cue sheets and archives may hold several). */
+    [[nodiscard]] virtual TrackList tracksForFilepath(const QString& filepath) const = 0;
+    /** Returns all tracks belonging to the album with a hash of @p albumHash. */
+    [[nodiscard]] virtual TrackList tracksForAlbum(const QString& albumHash) const = 0;
 
     /** Updates the track @p track in the library.  */
     virtual void updateTrack(const Track& track) = 0;
@@ -63,6 +63,18 @@ public:
      */
     static TrackList sortTracks(const TrackList& tracks, Qt::SortOrder order = Qt::AscendingOrder);
 
+    /*!
+     * Inserts @p tracks into @p sortedTracks using their current sort fields.
+     * Only the inserted tracks are compared against the existing ones, so this is much
+     * cheaper than a full resort when only a small number of tracks have changed.
+     * @param sortedTracks tracks which are already sorted in @p order
+     * @param tracks the tracks to insert
+     * @param order the order in which the tracks are sorted
+     * @returns a new sorted TrackList containing both sets of tracks
+     */
+    static TrackList insertSortedTracks(const TrackList& sortedTracks, const TrackList& tracks,
+                                        Qt::SortOrder order = Qt::AscendingOrder);
+
     /*!
      * Calculates the sort fields and then sorts @p tracks
      * @param sort the sort script as a string
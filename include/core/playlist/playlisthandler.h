@@ -136,7 +136,6 @@ public slots:
     void handleTracksChanged(const Fooyin::TrackList& tracks);
     void handleTracksUpdated(const Fooyin::TrackList& tracks);
     void handleTracksRemoved(const Fooyin::TrackList& tracks);
-    void trackAboutToFinish();
 
 private:
     std::unique_ptr<PlaylistHandlerPrivate> p;
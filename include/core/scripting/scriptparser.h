@@ -26,8 +26,11 @@
 
 #include <QObject>
 
+#include <memory>
+
 namespace Fooyin {
 class ScriptParserPrivate;
+class ScriptProgram;
 
 struct ScriptError
 {
@@ -42,6 +45,8 @@ struct ParsedScript
     QString input;
     ExpressionList expressions;
     ErrorList errors;
+    // Compiled form of expressions, shared between copies
+    std::shared_ptr<const ScriptProgram> program;
 
     [[nodiscard]] bool isValid() const
     {
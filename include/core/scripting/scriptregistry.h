@@ -31,6 +31,36 @@ class LibraryManager;
 class PlayerController;
 class ScriptRegistryPrivate;
 
+/*!
+ * A variable or function looked up once in a ScriptRegistry, so it can be evaluated repeatedly without a
+ * lookup by name. Unresolved handles are evaluated by name using ScriptRegistry::value/function.
+ */
+struct ScriptHandle
+{
+    enum class Type : uint8_t
+    {
+        Unresolved = 0,
+        Metadata,
+        PlaybackVar,
+        LibraryVar,
+        ListProperty,
+        ExtraTag,
+        Function,
+        TrackFunction,
+    };
+
+    Type type{Type::Unresolved};
+    QString name;
+    QString tag;
+    const void* entry{nullptr};
+
+    /** Returns true if this is a function which only depends on its arguments. */
+    [[nodiscard]] bool isPureFunction() const
+    {
+        return type == Type::Function;
+    }
+};
+
 class FYCORE_EXPORT ScriptRegistry
 {
 public:
@@ -55,6 +85,24 @@ public:
 
     virtual void setValue(const QString& var, const FuncRet& value, Track& track);
 
+    /*!
+     * Resolves @p var to a handle for use with value.
+     * Subclasses which override value for a variable must also override this to leave it unresolved.
+     */
+    [[nodiscard]] virtual ScriptHandle resolveVariable(const QString& var) const;
+    /*!
+     * Resolves @p func to a handle for use with function.
+     * Subclasses which override function must also override this to leave it unresolved.
+     */
+    [[nodiscard]] virtual ScriptHandle resolveFunction(const QString& func) const;
+
+    [[nodiscard]] ScriptResult value(const ScriptHandle& var, const Track& track) const;
+    [[nodiscard]] ScriptResult value(const ScriptHandle& var, const TrackList& tracks) const;
+    [[nodiscard]] ScriptResult function(const ScriptHandle& func, const ScriptValueList& args,
+                                        const Track& track) const;
+    [[nodiscard]] ScriptResult function(const ScriptHandle& func, const ScriptValueList& args,
+                                        const TrackList& tracks) const;
+
 protected:
     template <typename NewCntr, typename Cntr>
     NewCntr containerCast(const Cntr& from) const
@@ -68,6 +68,7 @@ public:
     bool operator!=(const Track& other) const;
     bool operator<(const Track& other) const;
 
+    /** Generates and stores the hash. Once a hash exists, changes to hashed fields regenerate it lazily. */
     QString generateHash();
 
     [[nodiscard]] bool isValid() const;
@@ -212,6 +213,8 @@ public:
     void clearWasModified();
 
     static QString findCommonField(const TrackList& tracks);
+    /** Releases shared field values (codec, genres etc.) which are no longer used by any track. */
+    static void pruneSharedStrings();
 
     static QStringList supportedMimeTypes();
 
@@ -179,6 +179,7 @@ constexpr auto GeneralCore        = "Fooyin.Page.General.Core";
 constexpr auto Playback           = "Fooyin.Page.Playback";
 constexpr auto Output             = "Fooyin.Page.Playback.Output";
 constexpr auto Decoding           = "Fooyin.Page.Playback.Decoding";
+constexpr auto Dsp                = "Fooyin.Page.Playback.Dsp";
 constexpr auto InterfaceGeneral   = "Fooyin.Page.Interface.General";
 constexpr auto InterfaceTheme     = "Fooyin.Page.Interface.Theme";
 constexpr auto Artwork            = "Fooyin.Page.Interface.Artwork";
@@ -25,23 +25,61 @@
 
 #include <QThreadStorage>
 
+#include <chrono>
+
 namespace Fooyin {
 class DbConnectionPool;
 using DbConnectionPoolPtr = std::shared_ptr<DbConnectionPool>;
 
+/*!
+ * SQLite tuning applied to every connection created by a DbConnectionPool.
+ * The defaults favour concurrent readers (UI, scanner, plugins) over strict durability.
+ */
+struct DbConnectionProfile
+{
+    enum class Synchronous : uint8_t
+    {
+        Off = 0,
+        Normal,
+        Full,
+    };
+
+    // Use write-ahead logging so readers aren't blocked by a writer
+    bool walJournal{true};
+    // NORMAL is safe from corruption in WAL mode, but may lose the last commit on power loss
+    Synchronous synchronous{Synchronous::Normal};
+    // Bytes of the database file to memory map (0 disables)
+    int64_t mmapSize{256LL * 1024 * 1024};
+    // Page cache size per connection in KiB
+    int cacheSize{16 * 1024};
+    bool tempStoreMemory{true};
+    // How long to wait for a lock held by another connection before failing
+    std::chrono::milliseconds busyTimeout{5000};
+    // Number of pages written to the WAL before a commit triggers an automatic checkpoint
+    int autoCheckpointPages{1000};
+    // Interval between passive checkpoints for owners which call checkpoint() (0 disables)
+    std::chrono::seconds checkpointInterval{300};
+};
+
 class FYUTILS_EXPORT DbConnectionPool
 {
     struct PrivateKey;
 
 public:
-    DbConnectionPool(PrivateKey, const DbConnection::DbParams& params, const QString& connectionName);
+    DbConnectionPool(PrivateKey, const DbConnection::DbParams& params, const QString& connectionName,
+                     const DbConnectionProfile& profile);
 
     DbConnectionPool(const DbConnectionPool& other)  = delete;
     DbConnectionPool(const DbConnectionPool&& other) = delete;
 
-    static DbConnectionPoolPtr create(const DbConnection::DbParams& params, const QString& connectionName);
+    static DbConnectionPoolPtr create(const DbConnection::DbParams& params, const QString& connectionName,
+                                      const DbConnectionProfile& profile = {});
 
     [[nodiscard]] bool hasThreadConnection() const;
+    [[nodiscard]] const DbConnectionProfile& profile() const;
+
+    /** Runs a passive WAL checkpoint on the calling thread's connection. */
+    bool checkpoint();
 
 private:
     friend class DbConnectionProvider;
@@ -54,5 +92,6 @@ private:
     QThreadStorage<DbConnection*> m_threadConnections;
     std::atomic_int m_connectionCount;
     DbConnection m_prototype;
+    DbConnectionProfile m_profile;
 };
 } // namespace Fooyin
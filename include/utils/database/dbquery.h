@@ -47,6 +47,8 @@ public:
     [[nodiscard]] QSqlError lastError() const;
 
     void bindValue(const QString& placeholder, const QVariant& value);
+    /** Binds @p value to the positional ('?') placeholder at @p pos. */
+    void bindValue(int pos, const QVariant& value);
     [[nodiscard]] QString executedQuery() const;
     bool exec();
 
@@ -22,9 +22,12 @@
 #include <cmath>
 #include <cstdlib>
 
-namespace Fooyin::Math {
 #if(defined(__GNUC__) && defined(__x86_64__))
 #include <emmintrin.h>
+#endif
+
+namespace Fooyin::Math {
+#if(defined(__GNUC__) && defined(__x86_64__))
 inline int fltToInt(float flt)
 {
     return _mm_cvtss_si32(_mm_load_ss(&flt));
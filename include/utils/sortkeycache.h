@@ -0,0 +1,53 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fyutils_export.h"
+
+#include <QCollator>
+
+#include <unordered_map>
+
+namespace Fooyin {
+/*!
+ * Caches collation sort keys for strings, so each string is only collated once.
+ * Comparing two cached keys is a plain binary comparison, which is much cheaper than QCollator::compare.
+ * The cache is unbounded, so long-lived owners should clear it between sorts (never during one, as that
+ * would throw away keys the sort is still using).
+ * @note this class is not thread-safe.
+ */
+class FYUTILS_EXPORT SortKeyCache
+{
+public:
+    explicit SortKeyCache(bool numericMode = true);
+
+    /** Returns the sort key for @p str, generating and caching it if needed. */
+    const QCollatorSortKey& sortKey(const QString& str);
+    /** Compares @p lhs and @p rhs using their sort keys. */
+    int compare(const QString& lhs, const QString& rhs);
+
+    [[nodiscard]] size_t size() const;
+    void clear();
+
+private:
+    QCollator m_collator;
+    std::unordered_map<QString, QCollatorSortKey> m_keys;
+};
+} // namespace Fooyin
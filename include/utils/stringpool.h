@@ -0,0 +1,65 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fyutils_export.h"
+
+#include <QSet>
+#include <QStringList>
+
+#include <array>
+#include <mutex>
+
+namespace Fooyin {
+/*!
+ * Interns strings so that equal values share a single allocation through implicit sharing.
+ * Intended for low-cardinality values repeated across many objects (genre, codec etc.).
+ * Entries are only removed by prune or clear, so interning unique values only grows the pool.
+ * @note this class is thread-safe.
+ */
+class FYUTILS_EXPORT StringPool
+{
+public:
+    /** Returns a string equal to @p str which shares its data with every other interned copy. */
+    QString intern(const QString& str);
+    /** Interns each string in @p strs, as well as the list itself. */
+    QStringList intern(const QStringList& strs);
+
+    [[nodiscard]] size_t size() const;
+    /** Removes entries which are no longer referenced outside the pool. */
+    void prune();
+    void clear();
+
+private:
+    static constexpr size_t ShardCount = 16;
+
+    struct Shard
+    {
+        mutable std::mutex mutex;
+        QSet<QString> strings;
+        QSet<QStringList> lists;
+    };
+
+    template <typename T>
+    T internValue(const T& value, QSet<T> Shard::*set);
+
+    std::array<Shard, ShardCount> m_shards;
+};
+} // namespace Fooyin
@@ -38,6 +38,7 @@
 
 #include <core/coresettings.h>
 #include <core/engine/audioloader.h>
+#include <core/engine/dspplugin.h>
 #include <core/engine/outputplugin.h>
 #include <core/player/playercontroller.h>
 #include <core/playlist/playlisthandler.h>
@@ -97,6 +98,9 @@ public:
     void savePlaybackState() const;
     void loadPlaybackState() const;
 
+    [[nodiscard]] Track upcomingTrack() const;
+    void prepareNextTrack();
+
     Application* m_self;
 
     SettingsManager* m_settings;
@@ -229,6 +233,9 @@ void ApplicationPrivate::loadPlugins()
     m_pluginManager.initialisePlugins<OutputPlugin>(
         [this](OutputPlugin* plugin) { m_engine.addOutput(plugin->name(), plugin->creator()); });
 
+    m_pluginManager.initialisePlugins<DspPlugin>(
+        [this](DspPlugin* plugin) { m_engine.addDsp(plugin->dspName(), plugin->dspCreator()); });
+
     m_pluginManager.initialisePlugins<InputPlugin>([this](InputPlugin* plugin) {
         const auto creator = plugin->inputCreator();
         if(creator.decoder) {
@@ -300,6 +307,31 @@ void ApplicationPrivate::exportAllPlaylists()
     }
 }
 
+Track ApplicationPrivate::upcomingTrack() const
+{
+    // Mirrors PlayerController::next
+    if(m_settings->value<Settings::Core::StopAfterCurrent>()) {
+        return {};
+    }
+
+    const PlaybackQueue queue = m_playerController->playbackQueue();
+    if(!queue.empty()) {
+        return queue.track(0).track;
+    }
+
+    // PlaylistHandler::nextTrack stops playback if there's no playlist
+    if(!m_playlistHandler->activePlaylist()) {
+        return {};
+    }
+
+    return m_playlistHandler->nextTrack();
+}
+
+void ApplicationPrivate::prepareNextTrack()
+{
+    m_engine.prepareNextTrack(upcomingTrack());
+}
+
 void ApplicationPrivate::savePlaybackState() const
 {
     if(m_settings->fileValue(Settings::Core::Internal::SavePlaybackState, false).toBool()) {
@@ -377,8 +409,18 @@ Application::Application(QObject* parent)
                      &PlaylistHandler::handleTracksChanged);
     QObject::connect(p->m_library, &MusicLibrary::tracksUpdated, p->m_playlistHandler,
                      &PlaylistHandler::handleTracksUpdated);
-    QObject::connect(&p->m_engine, &EngineHandler::trackAboutToFinish, p->m_playlistHandler,
-                     &PlaylistHandler::trackAboutToFinish);
+    QObject::connect(&p->m_engine, &EngineHandler::trackAboutToFinish, this, [this]() { p->prepareNextTrack(); });
+
+    // Let the engine drop a pre-rolled track if what plays next has changed since
+    const auto nextTrackChanged = [this]() {
+        p->prepareNextTrack();
+    };
+    QObject::connect(p->m_playerController, &PlayerController::tracksQueued, this, nextTrackChanged);
+    QObject::connect(p->m_playerController, &PlayerController::tracksDequeued, this, nextTrackChanged);
+    QObject::connect(p->m_playerController, &PlayerController::trackIndexesDequeued, this, nextTrackChanged);
+    QObject::connect(p->m_playerController, &PlayerController::trackQueueChanged, this, nextTrackChanged);
+    QObject::connect(p->m_playerController, &PlayerController::playModeChanged, this, nextTrackChanged);
+    p->m_settings->subscribe<Settings::Core::StopAfterCurrent>(this, nextTrackChanged);
     QObject::connect(&p->m_engine, &EngineHandler::trackChanged, p->m_library, [this](const Track& track) {
         p->m_library->updateTrackMetadata({track});
         auto currentTrack  = p->m_playerController->currentPlaylistTrack();
@@ -429,6 +471,7 @@ void Application::shutdown()
     p->m_audioLoader->saveState();
     p->m_settings->storeSettings();
     p->m_library->cleanupTracks();
+    p->m_library->saveSnapshot();
 }
 
 void Application::quit()
@@ -27,6 +27,7 @@
 #include <utils/settings/settingsmanager.h>
 
 #include <QFileInfo>
+#include <QTimerEvent>
 
 constexpr auto CurrentSchemaVersion = 10;
 
@@ -55,7 +56,14 @@ Database::Database(QObject* parent)
         return;
     }
 
-    initSchema();
+    if(initSchema()) {
+        // Keep the WAL from growing unbounded while other connections hold long-running reads
+        const auto interval = std::chrono::duration_cast<std::chrono::milliseconds>(
+            m_dbPool->profile().checkpointInterval);
+        if(interval.count() > 0) {
+            m_checkpointTimer.start(static_cast<int>(interval.count()), this);
+        }
+    }
 }
 
 DbConnectionPoolPtr Database::connectionPool() const
@@ -108,6 +116,14 @@ bool Database::initSchema()
     }
 }
 
+void Database::timerEvent(QTimerEvent* event)
+{
+    if(event->timerId() == m_checkpointTimer.timerId()) {
+        m_dbPool->checkpoint();
+    }
+    QObject::timerEvent(event);
+}
+
 void Database::changeStatus(Status status)
 {
     m_status = status;
@@ -24,6 +24,7 @@
 #include <utils/database/dbconnectionhandler.h>
 #include <utils/database/dbconnectionpool.h>
 
+#include <QBasicTimer>
 #include <QObject>
 
 namespace Fooyin {
@@ -52,6 +53,9 @@ public:
 signals:
     void statusChanged(Status status);
 
+protected:
+    void timerEvent(QTimerEvent* event) override;
+
 private:
     bool initSchema();
     void changeStatus(Status status);
@@ -60,5 +64,6 @@ private:
     DbConnectionHandler m_connectionHandler;
     Status m_status;
     int m_previousRevision;
+    QBasicTimer m_checkpointTimer;
 };
 } // namespace Fooyin
@@ -19,9 +19,32 @@
 
 #include "playlistdatabase.h"
 
+#include "playlist/playlistdiff.h"
+
 #include <utils/database/dbquery.h>
 #include <utils/database/dbtransaction.h>
 
+#include <algorithm>
+#include <iterator>
+
+namespace {
+// Gap between the TrackIndex of consecutive rows when a playlist is written in full.
+// TrackIndex is only used for ordering, so this leaves room to insert rows without renumbering the rest.
+constexpr int64_t IndexSpacing = 1024;
+// Diffs with more insertions and removals than this are written in full
+constexpr auto MaxDiffEdits = 512;
+// Rows per multi-row statement, keeping well below SQLite's bound parameter limit
+constexpr size_t InsertBatchSize = 256;
+constexpr size_t RemoveBatchSize = 512;
+
+QString placeholders(size_t rows, qsizetype columns)
+{
+    const QString row = QStringLiteral("(") + QStringList(columns, QStringLiteral("?")).join(u", ")
+                      + QStringLiteral(")");
+    return QStringList(static_cast<qsizetype>(rows), row).join(u", ");
+}
+} // namespace
+
 namespace Fooyin {
 std::vector<PlaylistInfo> PlaylistDatabase::getAllPlaylists()
 {
@@ -91,7 +114,7 @@ bool PlaylistDatabase::savePlaylist(Playlist& playlist)
     }
 
     if(playlist.tracksModified()) {
-        updated = insertPlaylistTracks(playlist.dbId(), playlist.tracks());
+        updated = savePlaylistTracks(playlist.dbId(), playlist.tracks());
     }
 
     if(updated) {
@@ -110,7 +133,13 @@ bool PlaylistDatabase::saveModifiedPlaylists(const PlaylistList& playlists)
         savePlaylist(*playlist);
     }
 
-    return transaction.commit();
+    if(!transaction.commit()) {
+        // Rows are unknown after a rollback, so write playlists in full next time
+        m_savedRows.clear();
+        return false;
+    }
+
+    return true;
 }
 
 bool PlaylistDatabase::removePlaylist(int id)
@@ -120,6 +149,8 @@ bool PlaylistDatabase::removePlaylist(int id)
     DbQuery query{db(), statement};
     query.bindValue(QStringLiteral(":id"), id);
 
+    m_savedRows.erase(id);
+
     return query.exec();
 }
 
@@ -138,25 +169,121 @@ bool PlaylistDatabase::renamePlaylist(int id, const QString& name)
     return query.exec();
 }
 
-bool PlaylistDatabase::insertPlaylistTrack(int playlistId, const Track& track, int index)
+std::optional<PlaylistDatabase::RowChanges> PlaylistDatabase::calcRowChanges(const PlaylistRows& savedRows,
+                                                                             const TrackIds& trackIds)
 {
-    const QString statement = QStringLiteral(
-        "INSERT INTO PlaylistTracks (PlaylistID, TrackID, TrackIndex) VALUES (:playlistId, :trackId, :index);");
+    TrackIds savedIds;
+    savedIds.reserve(savedRows.size());
+    std::ranges::transform(savedRows, std::back_inserter(savedIds), [](const PlaylistRow& row) { return row.trackId; });
+
+    // A diff touching more rows than the playlist has is no cheaper than rewriting it
+    const int maxEdits = std::min(MaxDiffEdits, static_cast<int>(trackIds.size()));
+    const auto diff    = diffPlaylistTracks(savedIds, trackIds, maxEdits);
+    if(!diff) {
+        return {};
+    }
 
-    DbQuery query{db(), statement};
-    query.bindValue(QStringLiteral(":playlistId"), playlistId);
-    query.bindValue(QStringLiteral(":trackId"), track.id());
-    query.bindValue(QStringLiteral(":index"), index);
+    RowChanges changes;
 
-    return query.exec();
+    changes.removed.reserve(diff->removed.size());
+    for(const int index : diff->removed) {
+        changes.removed.push_back(savedRows.at(index).index);
+    }
+
+    const size_t count = trackIds.size();
+    changes.rows.resize(count);
+
+    size_t i{0};
+    while(i < count) {
+        if(const int savedIndex = diff->newToOld.at(i); savedIndex >= 0) {
+            changes.rows[i] = savedRows.at(savedIndex);
+            ++i;
+            continue;
+        }
+
+        // Give each run of inserted tracks an index between the kept rows either side of it
+        size_t runEnd{i};
+        while(runEnd < count && diff->newToOld.at(runEnd) < 0) {
+            ++runEnd;
+        }
+
+        const auto runSize  = static_cast<int64_t>(runEnd - i);
+        const bool hasLower = i > 0;
+        const bool hasUpper = runEnd < count;
+        const int64_t lower = hasLower ? changes.rows.at(i - 1).index : 0;
+        const int64_t upper = hasUpper ? savedRows.at(diff->newToOld.at(runEnd)).index : 0;
+
+        if(hasLower && hasUpper && upper - lower <= runSize) {
+            // No room left between the neighbouring rows
+            return {};
+        }
+
+        for(size_t j{i}; j < runEnd; ++j) {
+            const auto runPos = static_cast<int64_t>(j - i);
+
+            PlaylistRow row;
+            row.trackId = trackIds.at(j);
+
+            if(hasLower && hasUpper) {
+                row.index = lower + ((upper - lower) * (runPos + 1) / (runSize + 1));
+            }
+            else if(hasLower) {
+                row.index = lower + (IndexSpacing * (runPos + 1));
+            }
+            else if(hasUpper) {
+                row.index = upper - (IndexSpacing * (runSize - runPos));
+            }
+            else {
+                row.index = IndexSpacing * runPos;
+            }
+
+            changes.rows[j] = row;
+            changes.added.push_back(row);
+        }
+
+        i = runEnd;
+    }
+
+    return changes;
 }
 
-bool PlaylistDatabase::insertPlaylistTracks(int playlistId, const TrackList& tracks)
+bool PlaylistDatabase::savePlaylistTracks(int playlistId, const TrackList& tracks)
 {
     if(playlistId < 0) {
         return false;
     }
 
+    TrackIds trackIds;
+    trackIds.reserve(tracks.size());
+    for(const auto& track : tracks) {
+        if(track.isValid() && track.isInDatabase()) {
+            trackIds.push_back(track.id());
+        }
+    }
+
+    const auto savedIt = m_savedRows.find(playlistId);
+    if(savedIt == m_savedRows.end()) {
+        return rewritePlaylistTracks(playlistId, trackIds);
+    }
+
+    auto changes = calcRowChanges(savedIt->second, trackIds);
+    if(!changes) {
+        return rewritePlaylistTracks(playlistId, trackIds);
+    }
+
+    if(!removePlaylistRows(playlistId, changes->removed) || !insertPlaylistRows(playlistId, changes->added)) {
+        m_savedRows.erase(savedIt);
+        return false;
+    }
+
+    savedIt->second = std::move(changes->rows);
+    return true;
+}
+
+bool PlaylistDatabase::rewritePlaylistTracks(int playlistId, const TrackIds& trackIds)
+{
+    m_savedRows.erase(playlistId);
+
     // Remove current playlist tracks
     const auto statement = QStringLiteral("DELETE FROM PlaylistTracks WHERE PlaylistID = :id;");
 
@@ -167,11 +294,77 @@ bool PlaylistDatabase::insertPlaylistTracks(int playlistId, const TrackList& tra
         return false;
     }
 
-    for(int i{0}; const auto& track : tracks) {
-        if(track.isValid() && track.isInDatabase()) {
-            if(!insertPlaylistTrack(playlistId, track, i++)) {
-                return false;
-            }
+    PlaylistRows rows;
+    rows.reserve(trackIds.size());
+    for(int64_t index{0}; const int trackId : trackIds) {
+        rows.push_back({.trackId = trackId, .index = IndexSpacing * index++});
+    }
+
+    if(!insertPlaylistRows(playlistId, rows)) {
+        return false;
+    }
+
+    m_savedRows.emplace(playlistId, std::move(rows));
+    return true;
+}
+
+bool PlaylistDatabase::insertPlaylistRows(int playlistId, const PlaylistRows& rows)
+{
+    DbQuery query;
+    size_t preparedCount{0};
+
+    for(size_t start{0}; start < rows.size(); start += InsertBatchSize) {
+        const size_t count = std::min(InsertBatchSize, rows.size() - start);
+
+        // Only the final batch should need a differently sized statement
+        if(count != preparedCount) {
+            const auto statement
+                = QStringLiteral("INSERT INTO PlaylistTracks (PlaylistID, TrackID, TrackIndex) VALUES %1;")
+                      .arg(placeholders(count, 3));
+            query         = DbQuery{db(), statement};
+            preparedCount = count;
+        }
+
+        for(size_t i{0}; i < count; ++i) {
+            const auto& row = rows.at(start + i);
+            const auto pos  = static_cast<int>(i * 3);
+
+            query.bindValue(pos, playlistId);
+            query.bindValue(pos + 1, row.trackId);
+            query.bindValue(pos + 2, static_cast<qlonglong>(row.index));
+        }
+
+        if(!query.exec()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool PlaylistDatabase::removePlaylistRows(int playlistId, const std::vector<int64_t>& indexes)
+{
+    DbQuery query;
+    size_t preparedCount{0};
+
+    for(size_t start{0}; start < indexes.size(); start += RemoveBatchSize) {
+        const size_t count = std::min(RemoveBatchSize, indexes.size() - start);
+
+        if(count != preparedCount) {
+            const auto statement
+                = QStringLiteral("DELETE FROM PlaylistTracks WHERE PlaylistID = ? AND TrackIndex IN (%1);")
+                      .arg(QStringList(static_cast<qsizetype>(count), QStringLiteral("?")).join(u", "));
+            query         = DbQuery{db(), statement};
+            preparedCount = count;
+        }
+
+        query.bindValue(0, playlistId);
+        for(size_t i{0}; i < count; ++i) {
+            query.bindValue(static_cast<int>(i + 1), static_cast<qlonglong>(indexes.at(start + i)));
+        }
+
+        if(!query.exec()) {
+            return false;
         }
     }
 
@@ -181,25 +374,41 @@ bool PlaylistDatabase::insertPlaylistTracks(int playlistId, const TrackList& tra
 TrackList PlaylistDatabase::populatePlaylistTracks(const Playlist& playlist,
                                                    const std::unordered_map<int, Track>& tracks)
 {
-    const auto statement
-        = QStringLiteral("SELECT TrackID FROM PlaylistTracks WHERE PlaylistID=:playlistId ORDER BY TrackIndex;");
+    const auto statement = QStringLiteral(
+        "SELECT TrackID, TrackIndex FROM PlaylistTracks WHERE PlaylistID=:playlistId ORDER BY TrackIndex;");
 
     DbQuery query{db(), statement};
     query.bindValue(QStringLiteral(":playlistId"), playlist.dbId());
 
+    m_savedRows.erase(playlist.dbId());
+
     if(!query.exec()) {
         return {};
     }
 
     TrackList playlistTracks;
+    PlaylistRows rows;
+    bool uniqueIndexes{true};
 
     while(query.next()) {
-        const int trackId = query.value(0).toInt();
+        const int trackId   = query.value(0).toInt();
+        const int64_t index = query.value(1).toLongLong();
+
+        if(!rows.empty() && index <= rows.back().index) {
+            uniqueIndexes = false;
+        }
+        rows.push_back({.trackId = trackId, .index = index});
+
         if(tracks.contains(trackId)) {
             playlistTracks.push_back(tracks.at(trackId));
         }
     }
 
+    // Rows can only be updated individually if their indexes are unique
+    if(uniqueIndexes) {
+        m_savedRows.emplace(playlist.dbId(), std::move(rows));
+    }
+
     return playlistTracks;
 }
 } // namespace Fooyin
@@ -23,6 +23,8 @@
 #include <core/track.h>
 #include <utils/database/dbmodule.h>
 
+#include <optional>
+
 namespace Fooyin {
 struct PlaylistInfo
 {
@@ -45,8 +47,29 @@ public:
     bool renamePlaylist(int id, const QString& name);
 
 private:
-    bool insertPlaylistTrack(int playlistId, const Fooyin::Track& track, int index);
-    bool insertPlaylistTracks(int playlistId, const TrackList& tracks);
+    struct PlaylistRow
+    {
+        int trackId{-1};
+        int64_t index{0};
+    };
+    using PlaylistRows = std::vector<PlaylistRow>;
+
+    struct RowChanges
+    {
+        std::vector<int64_t> removed;
+        PlaylistRows added;
+        PlaylistRows rows;
+    };
+
+    static std::optional<RowChanges> calcRowChanges(const PlaylistRows& savedRows, const TrackIds& trackIds);
+
+    bool savePlaylistTracks(int playlistId, const TrackList& tracks);
+    bool rewritePlaylistTracks(int playlistId, const TrackIds& trackIds);
+    bool insertPlaylistRows(int playlistId, const PlaylistRows& rows);
+    bool removePlaylistRows(int playlistId, const std::vector<int64_t>& indexes);
     TrackList populatePlaylistTracks(const Playlist& playlist, const std::unordered_map<int, Track>& tracks);
+
+    // Rows as currently stored in the db, keyed by playlist id
+    std::unordered_map<int, PlaylistRows> m_savedRows;
 };
 } // namespace Fooyin
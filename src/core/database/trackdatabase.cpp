@@ -28,9 +28,9 @@
 #include <QFileInfo>
 #include <QLoggingCategory>
 
-Q_LOGGING_CATEGORY(TRK_DB, "fy.trackdb")
+#include <array>
 
-using BindingsMap = std::map<QString, QVariant>;
+Q_LOGGING_CATEGORY(TRK_DB, "fy.trackdb")
 
 namespace {
 QString fetchTrackColumns()
@@ -74,37 +74,118 @@ QString fetchTrackColumns()
     return columns;
 }
 
-BindingsMap trackBindings(const Fooyin::Track& track)
+// Columns written by inserts and updates, in binding order
+constexpr std::array WriteColumns{"FilePath",
+                                   "Subsong",
+                                   "Title",
+                                   "TrackNumber",
+                                   "TrackTotal",
+                                   "Artists",
+                                   "AlbumArtist",
+                                   "Album",
+                                   "DiscNumber",
+                                   "DiscTotal",
+                                   "Date",
+                                   "Composer",
+                                   "Performer",
+                                   "Genres",
+                                   "Comment",
+                                   "CuePath",
+                                   "Offset",
+                                   "Duration",
+                                   "FileSize",
+                                   "BitRate",
+                                   "SampleRate",
+                                   "Channels",
+                                   "BitDepth",
+                                   "Codec",
+                                   "ExtraTags",
+                                   "ExtraProperties",
+                                   "ModifiedDate",
+                                   "TrackHash",
+                                   "LibraryID"};
+constexpr auto WriteColumnCount = static_cast<int>(WriteColumns.size());
+// Older SQLite versions limit a statement to 999 bound parameters
+constexpr size_t MaxBoundParameters = 999;
+constexpr size_t InsertBatchSize    = MaxBoundParameters / WriteColumnCount;
+
+QString writeColumns()
+{
+    QStringList columns;
+    for(const char* column : WriteColumns) {
+        columns.append(QLatin1String{column});
+    }
+    return columns.join(u",");
+}
+
+QString placeholders(size_t rows, qsizetype columns)
+{
+    const QString row = QStringLiteral("(") + QStringList(columns, QStringLiteral("?")).join(u", ")
+                      + QStringLiteral(")");
+    return QStringList(static_cast<qsizetype>(rows), row).join(u", ");
+}
+
+QString insertStatement(size_t rows, Fooyin::TrackDatabase::WriteMode mode)
+{
+    QString conflict;
+    if(mode == Fooyin::TrackDatabase::WriteMode::Upsert) {
+        QStringList assignments;
+        for(const char* column : WriteColumns) {
+            assignments.append(QStringLiteral("%1 = excluded.%1").arg(QLatin1String{column}));
+        }
+        conflict = QStringLiteral("DO UPDATE SET ") + assignments.join(u",");
+    }
+    else {
+        conflict = QStringLiteral("DO NOTHING");
+    }
+
+    return QStringLiteral("INSERT INTO Tracks (%1) VALUES %2 ON CONFLICT(FilePath, Offset, Subsong) %3 "
+                          "RETURNING TrackID, FilePath, Offset, Subsong;")
+        .arg(writeColumns(), placeholders(rows, WriteColumnCount), conflict);
+}
+
+QString updateStatement()
+{
+    QStringList assignments;
+    for(const char* column : WriteColumns) {
+        assignments.append(QStringLiteral("%1 = ?").arg(QLatin1String{column}));
+    }
+    return QStringLiteral("UPDATE Tracks SET %1 WHERE TrackID = ?;").arg(assignments.join(u","));
+}
+
+// Binds the write columns of @p track starting at @p pos, returning the position after the last column
+int bindTrack(Fooyin::DbQuery& query, int pos, const Fooyin::Track& track)
 {
-    return {{QStringLiteral(":filePath"), track.filepath()},
-            {QStringLiteral(":subsong"), track.subsong()},
-            {QStringLiteral(":title"), track.title()},
-            {QStringLiteral(":trackNumber"), track.trackNumber()},
-            {QStringLiteral(":trackTotal"), track.trackTotal()},
-            {QStringLiteral(":artists"), track.artist()},
-            {QStringLiteral(":albumArtist"), track.albumArtist()},
-            {QStringLiteral(":album"), track.album()},
-            {QStringLiteral(":discNumber"), track.discNumber()},
-            {QStringLiteral(":discTotal"), track.discTotal()},
-            {QStringLiteral(":date"), track.date()},
-            {QStringLiteral(":composer"), track.composer()},
-            {QStringLiteral(":performer"), track.performer()},
-            {QStringLiteral(":genres"), track.genre()},
-            {QStringLiteral(":comment"), track.comment()},
-            {QStringLiteral(":cuePath"), track.cuePath()},
-            {QStringLiteral(":offset"), static_cast<quint64>(track.offset())},
-            {QStringLiteral(":duration"), static_cast<quint64>(track.duration())},
-            {QStringLiteral(":fileSize"), static_cast<quint64>(track.fileSize())},
-            {QStringLiteral(":bitRate"), track.bitrate()},
-            {QStringLiteral(":sampleRate"), track.sampleRate()},
-            {QStringLiteral(":channels"), track.channels()},
-            {QStringLiteral(":bitDepth"), track.bitDepth()},
-            {QStringLiteral(":codec"), track.codec()},
-            {QStringLiteral(":extraTags"), track.serialiseExtraTags()},
-            {QStringLiteral(":extraProperties"), track.serialiseExtraProperties()},
-            {QStringLiteral(":modifiedDate"), static_cast<quint64>(track.modifiedTime())},
-            {QStringLiteral(":trackHash"), track.hash()},
-            {QStringLiteral(":libraryID"), track.libraryId()}};
+    query.bindValue(pos++, track.filepath());
+    query.bindValue(pos++, track.subsong());
+    query.bindValue(pos++, track.title());
+    query.bindValue(pos++, track.trackNumber());
+    query.bindValue(pos++, track.trackTotal());
+    query.bindValue(pos++, track.artist());
+    query.bindValue(pos++, track.albumArtist());
+    query.bindValue(pos++, track.album());
+    query.bindValue(pos++, track.discNumber());
+    query.bindValue(pos++, track.discTotal());
+    query.bindValue(pos++, track.date());
+    query.bindValue(pos++, track.composer());
+    query.bindValue(pos++, track.performer());
+    query.bindValue(pos++, track.genre());
+    query.bindValue(pos++, track.comment());
+    query.bindValue(pos++, track.cuePath());
+    query.bindValue(pos++, static_cast<quint64>(track.offset()));
+    query.bindValue(pos++, static_cast<quint64>(track.duration()));
+    query.bindValue(pos++, static_cast<quint64>(track.fileSize()));
+    query.bindValue(pos++, track.bitrate());
+    query.bindValue(pos++, track.sampleRate());
+    query.bindValue(pos++, track.channels());
+    query.bindValue(pos++, track.bitDepth());
+    query.bindValue(pos++, track.codec());
+    query.bindValue(pos++, track.serialiseExtraTags());
+    query.bindValue(pos++, track.serialiseExtraProperties());
+    query.bindValue(pos++, static_cast<quint64>(track.modifiedTime()));
+    query.bindValue(pos++, track.hash());
+    query.bindValue(pos++, track.libraryId());
+    return pos;
 }
 
 Fooyin::Track readToTrack(const Fooyin::DbQuery& q)
@@ -154,9 +235,16 @@ Fooyin::Track readToTrack(const Fooyin::DbQuery& q)
 } // namespace
 
 namespace Fooyin {
-bool TrackDatabase::storeTracks(TrackList& tracks)
+bool TrackDatabase::storeTracks(TrackList& tracks, WriteMode mode)
 {
-    if(tracks.empty()) {
+    std::vector<Track*> newTracks;
+    for(auto& track : tracks) {
+        if(track.id() < 0) {
+            newTracks.push_back(&track);
+        }
+    }
+
+    if(newTracks.empty()) {
         return true;
     }
 
@@ -166,9 +254,11 @@ bool TrackDatabase::storeTracks(TrackList& tracks)
         return false;
     }
 
-    for(auto& track : tracks) {
-        if(track.id() < 0) {
-            insertTrack(track);
+    insertTracks(newTracks, mode);
+
+    for(const Track* track : newTracks) {
+        if(track->id() >= 0) {
+            insertOrUpdateStats(*track);
         }
     }
 
@@ -187,9 +277,13 @@ bool TrackDatabase::updateTracks(TrackList& tracks)
         return false;
     }
 
-    for(auto& track : tracks) {
+    DbQuery query{db(), updateStatement()};
+
+    for(const auto& track : tracks) {
         if(track.id() >= 0) {
-            updateTrack(track);
+            const int pos = bindTrack(query, 0, track);
+            query.bindValue(pos, track.id());
+            query.exec();
         }
     }
 
@@ -266,6 +360,29 @@ TrackList TrackDatabase::getAllTracks() const
     return tracks;
 }
 
+std::optional<TrackDatabase::State> TrackDatabase::state() const
+{
+    const auto statement = QStringLiteral(
+        "SELECT COUNT(*), IFNULL(MAX(TrackID), 0), TOTAL(ModifiedDate), TOTAL(LibraryID), "
+        "(SELECT TOTAL(AddedDate) + TOTAL(FirstPlayed) + TOTAL(LastPlayed) + TOTAL(PlayCount) + TOTAL(Rating) "
+        "FROM TrackStats) FROM Tracks;");
+
+    DbQuery query{db(), statement};
+
+    if(!query.exec() || !query.next()) {
+        return {};
+    }
+
+    State state;
+    state.trackCount    = query.value(0).toLongLong();
+    state.maxTrackId    = query.value(1).toLongLong();
+    state.modifiedTotal = query.value(2).toDouble();
+    state.libraryTotal  = query.value(3).toDouble();
+    state.statsTotal    = query.value(4).toDouble();
+
+    return state;
+}
+
 TrackList TrackDatabase::tracksByHash(const QString& hash) const
 {
     const auto statement
@@ -314,46 +431,10 @@ bool TrackDatabase::updateTrack(const Track& track)
         return false;
     }
 
-    const auto statement = QStringLiteral("UPDATE TRACKS SET "
-                                          "FilePath = :filePath,"
-                                          "Subsong = :subsong,"
-                                          "Title = :title, "
-                                          "TrackNumber = :trackNumber,"
-                                          "TrackTotal = :trackTotal,"
-                                          "Artists = :artists,"
-                                          "AlbumArtist = :albumArtist,"
-                                          "Album = :album,"
-                                          "DiscNumber = :discNumber,"
-                                          "DiscTotal = :discTotal,"
-                                          "Date = :date,"
-                                          "Composer = :composer,"
-                                          "Performer = :performer,"
-                                          "Genres = :genres,"
-                                          "Comment = :comment,"
-                                          "CuePath = :cuePath,"
-                                          "Offset = :offset,"
-                                          "Duration = :duration,"
-                                          "FileSize = :fileSize,"
-                                          "BitRate = :bitRate,"
-                                          "SampleRate = :sampleRate,"
-                                          "Channels = :channels,"
-                                          "BitDepth = :bitDepth,"
-                                          "Codec = :codec,"
-                                          "ExtraTags = :extraTags,"
-                                          "ExtraProperties = :extraProperties,"
-                                          "ModifiedDate = :modifiedDate,"
-                                          "TrackHash = :trackHash,"
-                                          "LibraryID = :libraryID"
-                                          " WHERE TrackID = :trackId;");
+    DbQuery query{db(), updateStatement()};
 
-    DbQuery query{db(), statement};
-
-    query.bindValue(QStringLiteral(":trackId"), track.id());
-
-    const auto bindings = trackBindings(track);
-    for(const auto& [name, value] : bindings) {
-        query.bindValue(name, value);
-    }
+    const int pos = bindTrack(query, 0, track);
+    query.bindValue(pos, track.id());
 
     return query.exec();
 }
@@ -537,85 +618,75 @@ int TrackDatabase::trackCount() const
     return -1;
 }
 
-bool TrackDatabase::insertTrack(Track& track) const
+bool TrackDatabase::insertTracks(const std::vector<Track*>& tracks, WriteMode mode) const
 {
-    const auto statement = QStringLiteral("INSERT INTO Tracks ("
-                                          "FilePath,"
-                                          "Subsong,"
-                                          "Title,"
-                                          "TrackNumber,"
-                                          "TrackTotal,"
-                                          "Artists,"
-                                          "AlbumArtist,"
-                                          "Album,"
-                                          "DiscNumber,"
-                                          "DiscTotal,"
-                                          "Date,"
-                                          "Composer,"
-                                          "Performer,"
-                                          "Genres,"
-                                          "Comment,"
-                                          "CuePath,"
-                                          "Offset,"
-                                          "Duration,"
-                                          "FileSize,"
-                                          "BitRate,"
-                                          "SampleRate,"
-                                          "Channels,"
-                                          "BitDepth,"
-                                          "Codec,"
-                                          "ExtraTags,"
-                                          "ExtraProperties,"
-                                          "ModifiedDate,"
-                                          "TrackHash,"
-                                          "LibraryID"
-                                          ") "
-                                          "VALUES ("
-                                          ":filePath,"
-                                          ":subsong,"
-                                          ":title, "
-                                          ":trackNumber,"
-                                          ":trackTotal,"
-                                          ":artists,"
-                                          ":albumArtist,"
-                                          ":album,"
-                                          ":discNumber,"
-                                          ":discTotal,"
-                                          ":date, "
-                                          ":composer,"
-                                          ":performer,"
-                                          ":genres,"
-                                          ":comment,"
-                                          ":cuePath,"
-                                          ":offset,"
-                                          ":duration,"
-                                          ":fileSize,"
-                                          ":bitRate,"
-                                          ":sampleRate,"
-                                          ":channels,"
-                                          ":bitDepth,"
-                                          ":codec,"
-                                          ":extraTags,"
-                                          ":extraProperties,"
-                                          ":modifiedDate,"
-                                          ":trackHash,"
-                                          ":libraryID"
-                                          ");");
+    bool success{true};
 
-    DbQuery query{db(), statement};
+    DbQuery query;
+    size_t preparedCount{0};
+
+    for(size_t start{0}; start < tracks.size(); start += InsertBatchSize) {
+        const size_t count = std::min(InsertBatchSize, tracks.size() - start);
+
+        // Only the final batch should need a differently sized statement
+        if(count != preparedCount) {
+            query         = DbQuery{db(), insertStatement(count, mode)};
+            preparedCount = count;
+        }
+
+        int pos{0};
+        for(size_t i{0}; i < count; ++i) {
+            pos = bindTrack(query, pos, *tracks.at(start + i));
+        }
 
-    const auto bindings = trackBindings(track);
-    for(const auto& [name, value] : bindings) {
-        query.bindValue(name, value);
+        if(!query.exec()) {
+            // Retry individually so a single bad track doesn't prevent the rest of the batch being stored
+            for(size_t i{0}; i < count; ++i) {
+                if(!insertTrack(*tracks.at(start + i), mode)) {
+                    success = false;
+                }
+            }
+            continue;
+        }
+
+        // The order of returned rows is unspecified, so match them back to tracks by the unique key
+        std::vector<bool> assigned(count, false);
+        while(query.next()) {
+            const int id          = query.value(0).toInt();
+            const QString path    = query.value(1).toString();
+            const uint64_t offset = query.value(2).toULongLong();
+            const int subsong     = query.value(3).toInt();
+
+            for(size_t i{0}; i < count; ++i) {
+                Track* track = tracks.at(start + i);
+                if(!assigned.at(i) && track->offset() == offset && track->subsong() == subsong
+                   && track->filepath() == path) {
+                    track->setId(id);
+                    assigned.at(i) = true;
+                    break;
+                }
+            }
+        }
     }
 
+    return success;
+}
+
+bool TrackDatabase::insertTrack(Track& track, WriteMode mode) const
+{
+    DbQuery query{db(), insertStatement(1, mode)};
+
+    bindTrack(query, 0, track);
+
     if(!query.exec()) {
         return false;
     }
 
-    track.setId(query.lastInsertId().toInt());
+    if(query.next()) {
+        track.setId(query.value(0).toInt());
+    }
 
-    return insertOrUpdateStats(track);
+    return true;
 }
 
 bool TrackDatabase::insertOrUpdateStats(const Track& track) const
@@ -22,18 +22,43 @@
 #include <core/track.h>
 #include <utils/database/dbmodule.h>
 
+#include <optional>
 #include <set>
 
 namespace Fooyin {
 class TrackDatabase : public DbModule
 {
 public:
-    bool storeTracks(TrackList& tracks);
+    enum class WriteMode : uint8_t
+    {
+        // Tracks which already exist (by path, offset and subsong) are skipped
+        Insert = 0,
+        // Tracks which already exist are overwritten and take the existing id
+        Upsert,
+    };
+
+    /*!
+     * Cheap summary of the track tables.
+     * Used to detect whether the tables have changed since a library snapshot was written.
+     */
+    struct State
+    {
+        int64_t trackCount{0};
+        int64_t maxTrackId{0};
+        double modifiedTotal{0};
+        double libraryTotal{0};
+        double statsTotal{0};
+
+        bool operator==(const State& other) const = default;
+    };
+
+    bool storeTracks(TrackList& tracks, WriteMode mode = WriteMode::Insert);
     bool updateTracks(TrackList& tracks);
 
     bool reloadTrack(Track& track) const;
     bool reloadTracks(TrackList& tracks) const;
     [[nodiscard]] TrackList getAllTracks() const;
+    [[nodiscard]] std::optional<State> state() const;
     [[nodiscard]] TrackList tracksByHash(const QString& hash) const;
     int idForTrack(Track& track) const;
 
@@ -52,7 +77,8 @@ public:
 
 private:
     [[nodiscard]] int trackCount() const;
-    bool insertTrack(Track& track) const;
+    bool insertTracks(const std::vector<Track*>& tracks, WriteMode mode) const;
+    bool insertTrack(Track& track, WriteMode mode) const;
     bool insertOrUpdateStats(const Track& track) const;
     void removeUnmanagedTracks() const;
     void markUnusedStatsForDelete() const;
@@ -19,9 +19,14 @@
 
 #include <core/engine/audiobuffer.h>
 
+#include "audiobufferpool.h"
+
 #include <QDebug>
 #include <QLoggingCategory>
 
+#include <algorithm>
+#include <utility>
+
 Q_LOGGING_CATEGORY(AUD_BUFF, "fy.audiobuffer")
 
 namespace Fooyin {
@@ -29,20 +34,63 @@ class AudioBufferPrivate : public QSharedData
 {
 public:
     AudioBufferPrivate(std::span<const std::byte> data, AudioFormat format, uint64_t startTime)
-        : m_format{format}
+        : m_buffer{AudioBufferPool::instance().acquire(data.size())}
+        , m_format{format}
         , m_startTime{startTime}
     {
         m_buffer.assign(data.begin(), data.end());
     }
 
     AudioBufferPrivate(const uint8_t* data, size_t size, AudioFormat format, uint64_t startTime)
-        : m_format{format}
+        : m_buffer{AudioBufferPool::instance().acquire(size)}
+        , m_format{format}
         , m_startTime{startTime}
     {
         m_buffer.resize(size);
         std::memmove(m_buffer.data(), data, size);
     }
 
+    AudioBufferPrivate(const AudioBufferPrivate& other)
+        : QSharedData{other}
+        , m_buffer{AudioBufferPool::instance().acquire(other.m_buffer.size())}
+        , m_format{other.m_format}
+        , m_startTime{other.m_startTime}
+    {
+        m_buffer.assign(other.m_buffer.cbegin(), other.m_buffer.cend());
+    }
+
+    ~AudioBufferPrivate()
+    {
+        AudioBufferPool::instance().release(std::move(m_buffer));
+    }
+
+    AudioBufferPrivate& operator=(const AudioBufferPrivate&) = delete;
+
+    static void* operator new(size_t size)
+    {
+        static_assert(sizeof(AudioBufferPrivate) <= AudioBufferPool::ObjectSize);
+        Q_ASSERT(size <= AudioBufferPool::ObjectSize);
+        return AudioBufferPool::instance().allocateObject();
+    }
+
+    static void operator delete(void* ptr)
+    {
+        AudioBufferPool::instance().freeObject(ptr);
+    }
+
+    // Swaps in pooled storage of at least @p capacity bytes, rather than letting the vector reallocate
+    void reserve(size_t capacity)
+    {
+        if(capacity <= m_buffer.capacity()) {
+            return;
+        }
+
+        auto& pool      = AudioBufferPool::instance();
+        auto newStorage = pool.acquire(std::max(capacity, m_buffer.capacity() * 2));
+        newStorage.assign(m_buffer.cbegin(), m_buffer.cend());
+        pool.release(std::exchange(m_buffer, std::move(newStorage)));
+    }
+
     void fillSilence()
     {
         const bool unsignedFormat = m_format.sampleFormat() == SampleFormat::U8;
@@ -99,13 +147,14 @@ AudioBuffer::AudioBuffer(AudioBuffer&& other) noexcept        = default;
 void AudioBuffer::reserve(size_t size)
 {
     if(isValid()) {
-        p->m_buffer.reserve(size);
+        p->reserve(size);
     }
 }
 
 void AudioBuffer::resize(size_t size)
 {
     if(isValid()) {
+        p->reserve(size);
         p->m_buffer.resize(size);
     }
 }
@@ -121,6 +170,7 @@ void AudioBuffer::append(const std::byte* data, size_t size)
 {
     if(isValid()) {
         const size_t index = p->m_buffer.size();
+        p->reserve(index + size);
         p->m_buffer.resize(index + size);
         std::memcpy(p->m_buffer.data() + index, data, size);
     }
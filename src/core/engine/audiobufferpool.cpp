@@ -0,0 +1,145 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audiobufferpool.h"
+
+#include <algorithm>
+#include <bit>
+#include <new>
+
+namespace {
+constexpr size_t classSize(size_t index)
+{
+    return size_t{1} << (index + Fooyin::AudioBufferPool::MinClassShift);
+}
+} // namespace
+
+namespace Fooyin {
+AudioBufferPool::AudioBufferPool()
+    : m_objects{}
+    , m_allocations{0}
+{ }
+
+AudioBufferPool::~AudioBufferPool()
+{
+    for(auto& object : m_objects) {
+        ::operator delete(object.load(std::memory_order_relaxed));
+    }
+}
+
+AudioBufferPool& AudioBufferPool::instance()
+{
+    // Never destroyed, as buffers may outlive other statics
+    static auto* pool = new AudioBufferPool();
+    return *pool;
+}
+
+AudioBufferPool::Storage AudioBufferPool::acquire(size_t capacity)
+{
+    if(capacity == 0) {
+        return {};
+    }
+
+    const size_t shift = std::max<size_t>(std::bit_width(capacity - 1), MinClassShift);
+
+    if(shift <= MaxClassShift) {
+        const size_t index = shift - MinClassShift;
+
+        for(auto& slot : m_classes.at(index)) {
+            auto expected = SlotState::Full;
+            if(slot.state.compare_exchange_strong(expected, SlotState::Busy, std::memory_order_acquire,
+                                                  std::memory_order_relaxed)) {
+                Storage storage = std::move(slot.storage);
+                slot.state.store(SlotState::Empty, std::memory_order_release);
+                return storage;
+            }
+        }
+
+        capacity = classSize(index);
+    }
+
+    m_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    Storage storage;
+    storage.reserve(capacity);
+    return storage;
+}
+
+void AudioBufferPool::release(Storage&& storage)
+{
+    const size_t capacity = storage.capacity();
+    if(capacity < classSize(0)) {
+        return;
+    }
+
+    // Round down, so anything taken from a class is at least that class's size
+    const size_t shift = std::bit_width(capacity) - 1;
+    if(shift > MaxClassShift) {
+        return;
+    }
+
+    storage.clear();
+
+    // Freed normally if every slot is taken
+    for(auto& slot : m_classes.at(shift - MinClassShift)) {
+        auto expected = SlotState::Empty;
+        if(slot.state.compare_exchange_strong(expected, SlotState::Busy, std::memory_order_acquire,
+                                              std::memory_order_relaxed)) {
+            slot.storage = std::move(storage);
+            slot.state.store(SlotState::Full, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+void* AudioBufferPool::allocateObject()
+{
+    for(auto& slot : m_objects) {
+        if(slot.load(std::memory_order_relaxed)) {
+            if(void* object = slot.exchange(nullptr, std::memory_order_acquire)) {
+                return object;
+            }
+        }
+    }
+
+    m_allocations.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(ObjectSize);
+}
+
+void AudioBufferPool::freeObject(void* object)
+{
+    if(!object) {
+        return;
+    }
+
+    for(auto& slot : m_objects) {
+        void* expected{nullptr};
+        if(slot.compare_exchange_strong(expected, object, std::memory_order_release, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+
+    ::operator delete(object);
+}
+
+uint64_t AudioBufferPool::allocations() const
+{
+    return m_allocations.load(std::memory_order_relaxed);
+}
+} // namespace Fooyin
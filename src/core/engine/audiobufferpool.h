@@ -0,0 +1,94 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace Fooyin {
+/*!
+ * Recycles the storage used by AudioBuffers, so buffers created and destroyed during playback
+ * reuse earlier allocations rather than hitting the heap.
+ *
+ * Storage is kept in power of two size classes, with a small number of free blocks per class, so at most
+ * a few MiB are held. Requests larger than the largest class are allocated and freed normally.
+ * Every allocation which couldn't be served from the pool is counted in @fn allocations.
+ *
+ * All functions are lock-free, as they're called from the audio threads. Each free block sits in a slot
+ * which is claimed with a compare-and-swap before its storage is moved in or out.
+ */
+class FYCORE_EXPORT AudioBufferPool
+{
+public:
+    using Storage = std::vector<std::byte>;
+
+    static constexpr size_t MinClassShift = 10; // 1 KiB
+    static constexpr size_t MaxClassShift = 20; // 1 MiB
+    static constexpr size_t MaxPerClass   = 4;
+    // Size of the blocks handed out by allocateObject
+    static constexpr size_t ObjectSize = 128;
+    static constexpr size_t MaxObjects = 32;
+
+    AudioBufferPool();
+    ~AudioBufferPool();
+
+    AudioBufferPool(const AudioBufferPool&)            = delete;
+    AudioBufferPool& operator=(const AudioBufferPool&) = delete;
+
+    static AudioBufferPool& instance();
+
+    /** Returns empty storage with a capacity of at least @p capacity bytes. */
+    Storage acquire(size_t capacity);
+    /** Returns @p storage to the pool, or frees it if its size class is full. */
+    void release(Storage&& storage);
+
+    /** Returns a block of ObjectSize bytes. */
+    void* allocateObject();
+    void freeObject(void* object);
+
+    /** Returns the number of heap allocations made since the pool was created. */
+    [[nodiscard]] uint64_t allocations() const;
+
+private:
+    static constexpr size_t ClassCount = MaxClassShift - MinClassShift + 1;
+
+    enum class SlotState : uint8_t
+    {
+        Empty,
+        Busy,
+        Full
+    };
+
+    struct Slot
+    {
+        std::atomic<SlotState> state{SlotState::Empty};
+        Storage storage;
+    };
+    using StorageClass = std::array<Slot, MaxPerClass>;
+
+    std::array<StorageClass, ClassCount> m_classes;
+    std::array<std::atomic<void*>, MaxObjects> m_objects;
+    std::atomic<uint64_t> m_allocations;
+};
+} // namespace Fooyin
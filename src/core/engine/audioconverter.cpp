@@ -22,42 +22,84 @@
 #include <core/engine/audiobuffer.h>
 #include <utils/math.h>
 
+#include <algorithm>
 #include <array>
 #include <cfenv>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if(defined(__GNUC__) && defined(__x86_64__))
+#define FY_CONVERTER_SIMD
+#include <immintrin.h>
+#endif
+
+constexpr auto MaxChannels = 32;
+// Frames converted at a time when a channel map needs samples gathered or scattered
+constexpr auto ChunkFrames = 256;
 
 namespace {
-using ChannelMap = std::array<int, 32>;
+using ChannelMap = std::array<int, MaxChannels>;
+// Converts count contiguous samples from input to output
+using Kernel = void (*)(const std::byte* input, std::byte* output, size_t count);
 
 template <typename InputType, typename OutputType, typename Func>
 void convert(const Fooyin::AudioFormat& inputFormat, const std::byte* input, const Fooyin::AudioFormat& outputFormat,
-             std::byte* output, int sampleCount, const ChannelMap& channelMap, Func&& conversionFunc)
+             std::byte* output, int frameCount, const ChannelMap& channelMap, Func&& conversionFunc)
 {
-    const int inBps  = inputFormat.bytesPerSample();
-    const int outBps = outputFormat.bytesPerSample();
-
     const int inChannels  = inputFormat.channelCount();
     const int outChannels = outputFormat.channelCount();
 
-    const int totalSamples = sampleCount * outChannels;
+    const size_t inFrameBytes  = sizeof(InputType) * inChannels;
+    const size_t outFrameBytes = sizeof(OutputType) * outChannels;
 
-    for(int i{0}; i < totalSamples; ++i) {
-        const int sampleIndex  = i / outChannels;
-        const int channelIndex = i % outChannels;
+    for(int frame{0}; frame < frameCount; ++frame) {
+        const std::byte* inFrame = input + (frame * inFrameBytes);
+        std::byte* outFrame      = output + (frame * outFrameBytes);
 
-        if(channelMap.at(channelIndex) < 0) {
-            continue;
-        }
+        for(int channel{0}; channel < outChannels; ++channel) {
+            const int inChannel = channelMap[channel];
+            if(inChannel < 0) {
+                continue;
+            }
 
-        InputType inSample;
-        const auto inOffset = (sampleIndex * inChannels + channelMap.at(channelIndex)) * inBps;
-        std::memcpy(&inSample, input + inOffset, inBps);
+            InputType inSample;
+            std::memcpy(&inSample, inFrame + (inChannel * sizeof(InputType)), sizeof(InputType));
 
-        OutputType outSample = conversionFunc(inSample);
-        const auto outOffset = i * outBps;
-        std::memcpy(output + outOffset, &outSample, outBps);
+            const OutputType outSample = conversionFunc(inSample);
+            std::memcpy(outFrame + (channel * sizeof(OutputType)), &outSample, sizeof(OutputType));
+        }
     }
 }
 
+// Float to integer conversions rely on round-to-nearest, so set it once per buffer rather than per sample
+class RoundingGuard
+{
+public:
+    explicit RoundingGuard(bool enabled)
+        : m_enabled{enabled}
+        , m_prevMode{enabled ? std::fegetround() : 0}
+    {
+        if(m_enabled) {
+            std::fesetround(FE_TONEAREST);
+        }
+    }
+
+    ~RoundingGuard()
+    {
+        if(m_enabled) {
+            std::fesetround(m_prevMode);
+        }
+    }
+
+    RoundingGuard(const RoundingGuard&)            = delete;
+    RoundingGuard& operator=(const RoundingGuard&) = delete;
+
+private:
+    bool m_enabled;
+    int m_prevMode;
+};
+
 uint8_t convertU8ToU8(const uint8_t inSample)
 {
     return inSample;
@@ -95,7 +137,8 @@ int32_t convertS16ToS32(const int16_t inSample)
 
 float convertS16ToFloat(const int16_t inSample)
 {
-    return static_cast<float>(inSample) / static_cast<float>(std::numeric_limits<int16_t>::max());
+    // Same scale as convertFloatToS16, so converting there and back is lossless
+    return static_cast<float>(inSample) / static_cast<float>(0x8000);
 }
 
 uint8_t convertS32ToU8(const int32_t inSample)
@@ -115,54 +158,39 @@ int32_t convertS32ToS32(const int32_t inSample)
 
 float convertS32ToFloat(const int32_t inSample)
 {
-    return static_cast<float>(inSample) / static_cast<float>(std::numeric_limits<int32_t>::max());
+    return static_cast<float>(inSample) / static_cast<float>(0x80000000);
 }
 
 uint8_t convertFloatToU8(const float inSample)
 {
-    const int prevRoundingMode = std::fegetround();
-    std::fesetround(FE_TONEAREST);
-
     static constexpr auto minS8 = static_cast<int>(std::numeric_limits<uint8_t>::min());
     static constexpr auto maxS8 = static_cast<int>(std::numeric_limits<uint8_t>::max());
 
     int intSample = Fooyin::Math::fltToInt(inSample * 0x80);
     intSample     = std::clamp(intSample, minS8, maxS8);
 
-    std::fesetround(prevRoundingMode);
-
     return static_cast<uint8_t>(intSample ^ 0x80);
 }
 
 int16_t convertFloatToS16(const float inSample)
 {
-    const int prevRoundingMode = std::fegetround();
-    std::fesetround(FE_TONEAREST);
-
     static constexpr auto minS16 = static_cast<int>(std::numeric_limits<int16_t>::min());
     static constexpr auto maxS16 = static_cast<int>(std::numeric_limits<int16_t>::max());
 
     int intSample = Fooyin::Math::fltToInt(inSample * 0x8000);
     intSample     = std::clamp(intSample, minS16, maxS16);
 
-    std::fesetround(prevRoundingMode);
-
     return static_cast<int16_t>(intSample);
 }
 
 int32_t convertFloatToS32(const float inSample)
 {
-    const int prevRoundingMode = std::fegetround();
-    std::fesetround(FE_TONEAREST);
-
     static constexpr int minS32 = std::numeric_limits<int32_t>::min();
     static constexpr int maxS32 = std::numeric_limits<int32_t>::max();
 
     int intSample = Fooyin::Math::fltToInt(inSample * static_cast<float>(0x80000000));
     intSample     = std::clamp(intSample, minS32, maxS32);
 
-    std::fesetround(prevRoundingMode);
-
     return intSample;
 }
 
@@ -171,20 +199,390 @@ float convertFloatToFloat(const float inSample)
     return inSample;
 }
 
+template <typename Type>
+void copyKernel(const std::byte* input, std::byte* output, size_t count)
+{
+    std::memcpy(output, input, count * sizeof(Type));
+}
+
+template <typename InputType, typename OutputType, OutputType (*Func)(InputType)>
+void scalarKernel(const std::byte* input, std::byte* output, size_t count)
+{
+    for(size_t i{0}; i < count; ++i) {
+        InputType inSample;
+        std::memcpy(&inSample, input + (i * sizeof(InputType)), sizeof(InputType));
+
+        const OutputType outSample = Func(inSample);
+        std::memcpy(output + (i * sizeof(OutputType)), &outSample, sizeof(OutputType));
+    }
+}
+
+// Converts the samples left over after the vector loop
+template <typename InputType, typename OutputType, OutputType (*Func)(InputType)>
+void convertTail(const std::byte* input, std::byte* output, size_t offset, size_t count)
+{
+    scalarKernel<InputType, OutputType, Func>(input + (offset * sizeof(InputType)),
+                                              output + (offset * sizeof(OutputType)), count - offset);
+}
+
+#ifdef FY_CONVERTER_SIMD
+// The vector kernels must produce identical output to the scalar functions above:
+// divisions are kept as divisions, and float to int conversion uses the current (round-to-nearest) mode
+// with out-of-range values saturating the same way as Math::fltToInt followed by a clamp.
+
+const __m128i* loadAddress128(const std::byte* data, size_t offset)
+{
+    return reinterpret_cast<const __m128i*>(data + offset);
+}
+
+__m128i* storeAddress128(std::byte* data, size_t offset)
+{
+    return reinterpret_cast<__m128i*>(data + offset);
+}
+
+void convertS16ToFloatSse2(const std::byte* input, std::byte* output, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(static_cast<float>(0x8000));
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const __m128i samples = _mm_loadu_si128(loadAddress128(input, i * sizeof(int16_t)));
+        const __m128i lo      = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        const __m128i hi      = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+
+        auto* out = reinterpret_cast<float*>(output + (i * sizeof(float)));
+        _mm_storeu_ps(out, _mm_div_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + 4, _mm_div_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+
+    convertTail<int16_t, float, convertS16ToFloat>(input, output, i, count);
+}
+
+void convertS16ToS32Sse2(const std::byte* input, std::byte* output, size_t count)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const __m128i samples = _mm_loadu_si128(loadAddress128(input, i * sizeof(int16_t)));
+        _mm_storeu_si128(storeAddress128(output, i * sizeof(int32_t)), _mm_unpacklo_epi16(zero, samples));
+        _mm_storeu_si128(storeAddress128(output, (i + 4) * sizeof(int32_t)), _mm_unpackhi_epi16(zero, samples));
+    }
+
+    convertTail<int16_t, int32_t, convertS16ToS32>(input, output, i, count);
+}
+
+void convertS32ToS16Sse2(const std::byte* input, std::byte* output, size_t count)
+{
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const __m128i lo = _mm_srai_epi32(_mm_loadu_si128(loadAddress128(input, i * sizeof(int32_t))), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_loadu_si128(loadAddress128(input, (i + 4) * sizeof(int32_t))), 16);
+        _mm_storeu_si128(storeAddress128(output, i * sizeof(int16_t)), _mm_packs_epi32(lo, hi));
+    }
+
+    convertTail<int32_t, int16_t, convertS32ToS16>(input, output, i, count);
+}
+
+void convertS32ToFloatSse2(const std::byte* input, std::byte* output, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(static_cast<float>(0x80000000));
+
+    size_t i{0};
+    for(; i + 4 <= count; i += 4) {
+        const __m128i samples = _mm_loadu_si128(loadAddress128(input, i * sizeof(int32_t)));
+        _mm_storeu_ps(reinterpret_cast<float*>(output + (i * sizeof(float))),
+                      _mm_div_ps(_mm_cvtepi32_ps(samples), scale));
+    }
+
+    convertTail<int32_t, float, convertS32ToFloat>(input, output, i, count);
+}
+
+void convertFloatToS16Sse2(const std::byte* input, std::byte* output, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(static_cast<float>(0x8000));
+    const auto* in     = reinterpret_cast<const float*>(input);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const __m128i lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i), scale));
+        const __m128i hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale));
+        _mm_storeu_si128(storeAddress128(output, i * sizeof(int16_t)), _mm_packs_epi32(lo, hi));
+    }
+
+    convertTail<float, int16_t, convertFloatToS16>(input, output, i, count);
+}
+
+void convertFloatToS32Sse2(const std::byte* input, std::byte* output, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(static_cast<float>(0x80000000));
+    const auto* in     = reinterpret_cast<const float*>(input);
+
+    size_t i{0};
+    for(; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(storeAddress128(output, i * sizeof(int32_t)),
+                         _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i), scale)));
+    }
+
+    convertTail<float, int32_t, convertFloatToS32>(input, output, i, count);
+}
+
+#define FY_AVX2 __attribute__((target("avx2")))
+
+FY_AVX2 void convertS16ToFloatAvx2(const std::byte* input, std::byte* output, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(static_cast<float>(0x8000));
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const __m256i samples = _mm256_cvtepi16_epi32(_mm_loadu_si128(loadAddress128(input, i * sizeof(int16_t))));
+        _mm256_storeu_ps(reinterpret_cast<float*>(output + (i * sizeof(float))),
+                         _mm256_div_ps(_mm256_cvtepi32_ps(samples), scale));
+    }
+
+    convertTail<int16_t, float, convertS16ToFloat>(input, output, i, count);
+}
+
+FY_AVX2 void convertS16ToS32Avx2(const std::byte* input, std::byte* output, size_t count)
+{
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const __m256i samples = _mm256_cvtepi16_epi32(_mm_loadu_si128(loadAddress128(input, i * sizeof(int16_t))));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + (i * sizeof(int32_t))),
+                            _mm256_slli_epi32(samples, 16));
+    }
+
+    convertTail<int16_t, int32_t, convertS16ToS32>(input, output, i, count);
+}
+
+FY_AVX2 void convertS32ToS16Avx2(const std::byte* input, std::byte* output, size_t count)
+{
+    const auto* in = reinterpret_cast<const __m256i*>(input);
+
+    size_t i{0};
+    for(; i + 16 <= count; i += 16) {
+        const __m256i lo = _mm256_srai_epi32(_mm256_loadu_si256(in + (i / 8)), 16);
+        const __m256i hi = _mm256_srai_epi32(_mm256_loadu_si256(in + (i / 8) + 1), 16);
+        // Packing works per 128-bit lane, so restore the sample order afterwards
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + (i * sizeof(int16_t))), packed);
+    }
+
+    convertTail<int32_t, int16_t, convertS32ToS16>(input, output, i, count);
+}
+
+FY_AVX2 void convertS32ToFloatAvx2(const std::byte* input, std::byte* output, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(static_cast<float>(0x80000000));
+    const auto* in     = reinterpret_cast<const __m256i*>(input);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(reinterpret_cast<float*>(output + (i * sizeof(float))),
+                         _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256(in + (i / 8))), scale));
+    }
+
+    convertTail<int32_t, float, convertS32ToFloat>(input, output, i, count);
+}
+
+FY_AVX2 void convertFloatToS16Avx2(const std::byte* input, std::byte* output, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(static_cast<float>(0x8000));
+    const auto* in     = reinterpret_cast<const float*>(input);
+
+    size_t i{0};
+    for(; i + 16 <= count; i += 16) {
+        const __m256i lo = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in + i), scale));
+        const __m256i hi = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in + i + 8), scale));
+        // Packing works per 128-bit lane, so restore the sample order afterwards
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + (i * sizeof(int16_t))), packed);
+    }
+
+    convertTail<float, int16_t, convertFloatToS16>(input, output, i, count);
+}
+
+FY_AVX2 void convertFloatToS32Avx2(const std::byte* input, std::byte* output, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(static_cast<float>(0x80000000));
+    const auto* in     = reinterpret_cast<const float*>(input);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + (i * sizeof(int32_t))),
+                            _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in + i), scale)));
+    }
+
+    convertTail<float, int32_t, convertFloatToS32>(input, output, i, count);
+}
+
+bool hasAvx2()
+{
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+
+// Picks the widest implementation supported by the running cpu
+template <typename Func>
+Func simdKernel(Func sse2, Func avx2)
+{
+    return hasAvx2() ? avx2 : sse2;
+}
+#endif
+
+using Fooyin::SampleFormat;
+
+// S24 is stored in 32 bits, so is converted as S32
+SampleFormat kernelFormat(SampleFormat format)
+{
+    return format == SampleFormat::S24 ? SampleFormat::S32 : format;
+}
+
+#ifdef FY_CONVERTER_SIMD
+#define FY_KERNEL(InputType, OutputType, Name) simdKernel(Name##Sse2, Name##Avx2)
+#else
+#define FY_KERNEL(InputType, OutputType, Name) scalarKernel<InputType, OutputType, Name>
+#endif
+
+// Returns a specialised kernel for the common format pairs, or nullptr if the generic path should be used
+Kernel findKernel(SampleFormat inFormat, SampleFormat outFormat)
+{
+    inFormat  = kernelFormat(inFormat);
+    outFormat = kernelFormat(outFormat);
+
+    switch(inFormat) {
+        case(SampleFormat::S16):
+            switch(outFormat) {
+                case(SampleFormat::S16):
+                    return copyKernel<int16_t>;
+                case(SampleFormat::S32):
+                    return FY_KERNEL(int16_t, int32_t, convertS16ToS32);
+                case(SampleFormat::F32):
+                    return FY_KERNEL(int16_t, float, convertS16ToFloat);
+                default:
+                    return nullptr;
+            }
+        case(SampleFormat::S32):
+            switch(outFormat) {
+                case(SampleFormat::S16):
+                    return FY_KERNEL(int32_t, int16_t, convertS32ToS16);
+                case(SampleFormat::S32):
+                    return copyKernel<int32_t>;
+                case(SampleFormat::F32):
+                    return FY_KERNEL(int32_t, float, convertS32ToFloat);
+                default:
+                    return nullptr;
+            }
+        case(SampleFormat::F32):
+            switch(outFormat) {
+                case(SampleFormat::S16):
+                    return FY_KERNEL(float, int16_t, convertFloatToS16);
+                case(SampleFormat::S32):
+                    return FY_KERNEL(float, int32_t, convertFloatToS32);
+                case(SampleFormat::F32):
+                    return copyKernel<float>;
+                default:
+                    return nullptr;
+            }
+        default:
+            return nullptr;
+    }
+}
+
+#undef FY_KERNEL
+
+template <size_t SampleSize>
+void copyStrided(const std::byte* input, size_t inStride, std::byte* output, size_t outStride, size_t count)
+{
+    for(size_t i{0}; i < count; ++i) {
+        std::memcpy(output + (i * outStride), input + (i * inStride), SampleSize);
+    }
+}
+
+void copyStrided(int sampleSize, const std::byte* input, size_t inStride, std::byte* output, size_t outStride,
+                 size_t count)
+{
+    if(sampleSize == 2) {
+        copyStrided<2>(input, inStride, output, outStride, count);
+    }
+    else {
+        copyStrided<4>(input, inStride, output, outStride, count);
+    }
+}
+
+// Runs kernel over the identity, N to mono (first channel) and mono to N channel maps
+bool convertWithKernel(Kernel kernel, const Fooyin::AudioFormat& inFormat, const std::byte* input,
+                       const Fooyin::AudioFormat& outFormat, std::byte* output, int frameCount)
+{
+    const int inChannels  = inFormat.channelCount();
+    const int outChannels = outFormat.channelCount();
+    const int inBps       = inFormat.bytesPerSample();
+    const int outBps      = outFormat.bytesPerSample();
+    const auto frames     = static_cast<size_t>(frameCount);
+
+    if(inChannels == outChannels) {
+        kernel(input, output, frames * inChannels);
+        return true;
+    }
+
+    alignas(32) std::array<std::byte, ChunkFrames * sizeof(int32_t)> samples;
+
+    if(outChannels == 1) {
+        const size_t inStride = static_cast<size_t>(inBps) * inChannels;
+        for(size_t frame{0}; frame < frames; frame += ChunkFrames) {
+            const size_t count = std::min<size_t>(ChunkFrames, frames - frame);
+            copyStrided(inBps, input + (frame * inStride), inStride, samples.data(), inBps, count);
+            kernel(samples.data(), output + (frame * outBps), count);
+        }
+        return true;
+    }
+
+    if(inChannels == 1) {
+        const size_t outStride = static_cast<size_t>(outBps) * outChannels;
+        for(size_t frame{0}; frame < frames; frame += ChunkFrames) {
+            const size_t count = std::min<size_t>(ChunkFrames, frames - frame);
+            kernel(input + (frame * inBps), samples.data(), count);
+            for(int channel{0}; channel < outChannels; ++channel) {
+                copyStrided(outBps, samples.data(), outBps, output + (frame * outStride) + (channel * outBps),
+                            outStride, count);
+            }
+        }
+        return true;
+    }
+
+    return false;
+}
+
 bool convertFormat(const Fooyin::AudioFormat& inFormat, const std::byte* input, const Fooyin::AudioFormat& outFormat,
                    std::byte* output, int samples)
 {
-    ChannelMap channels;
-    std::iota(channels.begin(), channels.end(), -1);
+    const int inputChannels  = inFormat.channelCount();
+    const int outputChannels = outFormat.channelCount();
+
+    if(outputChannels > MaxChannels) {
+        return false;
+    }
+
+    const RoundingGuard rounding{inFormat.sampleFormat() == SampleFormat::F32};
+
+    if(const Kernel kernel = findKernel(inFormat.sampleFormat(), outFormat.sampleFormat())) {
+        if(convertWithKernel(kernel, inFormat, input, outFormat, output, samples)) {
+            return true;
+        }
+    }
 
     // TODO: Handle channel layout of output
-    const int outputChannels = outFormat.channelCount();
+    ChannelMap channels;
+    channels.fill(-1);
     for(int i{0}; i < outputChannels; ++i) {
-        channels.at(i) = i;
+        if(i < inputChannels) {
+            channels[i] = i;
+        }
+        else if(inputChannels == 1) {
+            channels[i] = 0;
+        }
     }
 
-    using SampleFormat = Fooyin::SampleFormat;
-
     switch(inFormat.sampleFormat()) {
         case(SampleFormat::U8): {
             switch(outFormat.sampleFormat()) {
@@ -273,6 +671,355 @@ bool convertFormat(const Fooyin::AudioFormat& inFormat, const std::byte* input,
 
     return false;
 }
+template <size_t SampleSize>
+void interleavePlanes(const std::byte* const* planes, int channels, size_t offset, size_t frames, std::byte* output)
+{
+    const size_t frameBytes = SampleSize * channels;
+
+    for(size_t frame{offset}; frame < frames; ++frame) {
+        std::byte* outFrame = output + (frame * frameBytes);
+        for(int channel{0}; channel < channels; ++channel) {
+            std::memcpy(outFrame + (channel * SampleSize), planes[channel] + (frame * SampleSize), SampleSize);
+        }
+    }
+}
+
+// Interleaves frames [offset, frames) one sample at a time
+void interleaveGeneric(const std::byte* const* planes, int channels, int sampleSize, size_t offset, size_t frames,
+                       std::byte* output)
+{
+    switch(sampleSize) {
+        case(1):
+            interleavePlanes<1>(planes, channels, offset, frames, output);
+            break;
+        case(2):
+            interleavePlanes<2>(planes, channels, offset, frames, output);
+            break;
+        case(4):
+            interleavePlanes<4>(planes, channels, offset, frames, output);
+            break;
+        case(8):
+            interleavePlanes<8>(planes, channels, offset, frames, output);
+            break;
+        default: {
+            const size_t bps = static_cast<size_t>(sampleSize);
+            for(size_t frame{offset}; frame < frames; ++frame) {
+                for(int channel{0}; channel < channels; ++channel) {
+                    std::memcpy(output + ((frame * channels + channel) * bps), planes[channel] + (frame * bps), bps);
+                }
+            }
+            break;
+        }
+    }
+}
+
+// Interleaves as many whole vectors of frames as possible, returning the number of frames written
+using InterleaveKernel = size_t (*)(const std::byte* const* planes, size_t frames, std::byte* output);
+
+#ifdef FY_CONVERTER_SIMD
+// Transposes 4 rows of 4 32-bit samples, so each row holds one frame
+void transpose4x32(__m128i* rows)
+{
+    const __m128i t0 = _mm_unpacklo_epi32(rows[0], rows[1]);
+    const __m128i t1 = _mm_unpacklo_epi32(rows[2], rows[3]);
+    const __m128i t2 = _mm_unpackhi_epi32(rows[0], rows[1]);
+    const __m128i t3 = _mm_unpackhi_epi32(rows[2], rows[3]);
+
+    rows[0] = _mm_unpacklo_epi64(t0, t1);
+    rows[1] = _mm_unpackhi_epi64(t0, t1);
+    rows[2] = _mm_unpacklo_epi64(t2, t3);
+    rows[3] = _mm_unpackhi_epi64(t2, t3);
+}
+
+// Transposes 8 rows of 8 16-bit samples, so each row holds one frame
+void transpose8x16(__m128i* rows)
+{
+    const __m128i a0 = _mm_unpacklo_epi16(rows[0], rows[1]);
+    const __m128i a1 = _mm_unpacklo_epi16(rows[2], rows[3]);
+    const __m128i a2 = _mm_unpacklo_epi16(rows[4], rows[5]);
+    const __m128i a3 = _mm_unpacklo_epi16(rows[6], rows[7]);
+    const __m128i a4 = _mm_unpackhi_epi16(rows[0], rows[1]);
+    const __m128i a5 = _mm_unpackhi_epi16(rows[2], rows[3]);
+    const __m128i a6 = _mm_unpackhi_epi16(rows[4], rows[5]);
+    const __m128i a7 = _mm_unpackhi_epi16(rows[6], rows[7]);
+
+    const __m128i b0 = _mm_unpacklo_epi32(a0, a1);
+    const __m128i b1 = _mm_unpacklo_epi32(a2, a3);
+    const __m128i b2 = _mm_unpackhi_epi32(a0, a1);
+    const __m128i b3 = _mm_unpackhi_epi32(a2, a3);
+    const __m128i b4 = _mm_unpacklo_epi32(a4, a5);
+    const __m128i b5 = _mm_unpacklo_epi32(a6, a7);
+    const __m128i b6 = _mm_unpackhi_epi32(a4, a5);
+    const __m128i b7 = _mm_unpackhi_epi32(a6, a7);
+
+    rows[0] = _mm_unpacklo_epi64(b0, b1);
+    rows[1] = _mm_unpackhi_epi64(b0, b1);
+    rows[2] = _mm_unpacklo_epi64(b2, b3);
+    rows[3] = _mm_unpackhi_epi64(b2, b3);
+    rows[4] = _mm_unpacklo_epi64(b4, b5);
+    rows[5] = _mm_unpackhi_epi64(b4, b5);
+    rows[6] = _mm_unpacklo_epi64(b6, b7);
+    rows[7] = _mm_unpackhi_epi64(b6, b7);
+}
+
+size_t interleaveStereo16Sse2(const std::byte* const* planes, size_t frames, std::byte* output)
+{
+    size_t i{0};
+    for(; i + 8 <= frames; i += 8) {
+        const __m128i left  = _mm_loadu_si128(loadAddress128(planes[0], i * 2));
+        const __m128i right = _mm_loadu_si128(loadAddress128(planes[1], i * 2));
+        _mm_storeu_si128(storeAddress128(output, i * 4), _mm_unpacklo_epi16(left, right));
+        _mm_storeu_si128(storeAddress128(output, (i * 4) + 16), _mm_unpackhi_epi16(left, right));
+    }
+    return i;
+}
+
+size_t interleaveStereo32Sse2(const std::byte* const* planes, size_t frames, std::byte* output)
+{
+    size_t i{0};
+    for(; i + 4 <= frames; i += 4) {
+        const __m128i left  = _mm_loadu_si128(loadAddress128(planes[0], i * 4));
+        const __m128i right = _mm_loadu_si128(loadAddress128(planes[1], i * 4));
+        _mm_storeu_si128(storeAddress128(output, i * 8), _mm_unpacklo_epi32(left, right));
+        _mm_storeu_si128(storeAddress128(output, (i * 8) + 16), _mm_unpackhi_epi32(left, right));
+    }
+    return i;
+}
+
+template <int Channels>
+size_t interleaveSurround16Sse2(const std::byte* const* planes, size_t frames, std::byte* output)
+{
+    static_assert(Channels == 6 || Channels == 8);
+
+    size_t i{0};
+    for(; i + 8 <= frames; i += 8) {
+        // Vector types can't be used with std::array without losing their alignment attributes
+        __m128i rows[8];
+        for(int channel{0}; channel < 8; ++channel) {
+            rows[channel] = channel < Channels ? _mm_loadu_si128(loadAddress128(planes[channel], i * 2))
+                                               : _mm_setzero_si128();
+        }
+        transpose8x16(rows);
+
+        std::byte* out = output + (i * Channels * 2);
+        for(size_t frame{0}; frame < 8; ++frame) {
+            if constexpr(Channels == 8) {
+                _mm_storeu_si128(storeAddress128(out, frame * 16), rows[frame]);
+            }
+            else {
+                // Only the first 12 bytes of each row are used
+                _mm_storel_epi64(storeAddress128(out, frame * 12), rows[frame]);
+                const int last = _mm_cvtsi128_si32(_mm_srli_si128(rows[frame], 8));
+                std::memcpy(out + (frame * 12) + 8, &last, sizeof(last));
+            }
+        }
+    }
+    return i;
+}
+
+template <int Channels>
+size_t interleaveSurround32Sse2(const std::byte* const* planes, size_t frames, std::byte* output)
+{
+    static_assert(Channels == 6 || Channels == 8);
+
+    size_t i{0};
+    for(; i + 4 <= frames; i += 4) {
+        __m128i front[4];
+        for(int channel{0}; channel < 4; ++channel) {
+            front[channel] = _mm_loadu_si128(loadAddress128(planes[channel], i * 4));
+        }
+        transpose4x32(front);
+
+        std::byte* out = output + (i * Channels * 4);
+
+        if constexpr(Channels == 8) {
+            __m128i back[4];
+            for(int channel{0}; channel < 4; ++channel) {
+                back[channel] = _mm_loadu_si128(loadAddress128(planes[channel + 4], i * 4));
+            }
+            transpose4x32(back);
+
+            for(size_t frame{0}; frame < 4; ++frame) {
+                _mm_storeu_si128(storeAddress128(out, frame * 32), front[frame]);
+                _mm_storeu_si128(storeAddress128(out, (frame * 32) + 16), back[frame]);
+            }
+        }
+        else {
+            const __m128i ch4 = _mm_loadu_si128(loadAddress128(planes[4], i * 4));
+            const __m128i ch5 = _mm_loadu_si128(loadAddress128(planes[5], i * 4));
+            // Frames 0 and 1, then frames 2 and 3, of the last two channels
+            const __m128i back[2]{_mm_unpacklo_epi32(ch4, ch5), _mm_unpackhi_epi32(ch4, ch5)};
+
+            for(size_t frame{0}; frame < 4; ++frame) {
+                _mm_storeu_si128(storeAddress128(out, frame * 24), front[frame]);
+                const __m128i pair = frame % 2 == 0 ? back[frame / 2] : _mm_srli_si128(back[frame / 2], 8);
+                _mm_storel_epi64(storeAddress128(out, (frame * 24) + 16), pair);
+            }
+        }
+    }
+    return i;
+}
+
+// Unpacking works per 128-bit lane, so the halves are recombined in order before storing
+FY_AVX2 size_t interleaveStereo16Avx2(const std::byte* const* planes, size_t frames, std::byte* output)
+{
+    size_t i{0};
+    for(; i + 16 <= frames; i += 16) {
+        const __m256i left  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(planes[0] + (i * 2)));
+        const __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(planes[1] + (i * 2)));
+        const __m256i lo    = _mm256_unpacklo_epi16(left, right);
+        const __m256i hi    = _mm256_unpackhi_epi16(left, right);
+
+        auto* out = reinterpret_cast<__m256i*>(output + (i * 4));
+        _mm256_storeu_si256(out, _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    return i;
+}
+
+FY_AVX2 size_t interleaveStereo32Avx2(const std::byte* const* planes, size_t frames, std::byte* output)
+{
+    size_t i{0};
+    for(; i + 8 <= frames; i += 8) {
+        const __m256i left  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(planes[0] + (i * 4)));
+        const __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(planes[1] + (i * 4)));
+        const __m256i lo    = _mm256_unpacklo_epi32(left, right);
+        const __m256i hi    = _mm256_unpackhi_epi32(left, right);
+
+        auto* out = reinterpret_cast<__m256i*>(output + (i * 8));
+        _mm256_storeu_si256(out, _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    return i;
+}
+#endif
+
+// Returns a kernel for the common layouts (stereo, 5.1 and 7.1 with 16 or 32-bit samples), or nullptr
+InterleaveKernel findInterleaveKernel([[maybe_unused]] int channels, [[maybe_unused]] int sampleSize)
+{
+#ifdef FY_CONVERTER_SIMD
+    if(sampleSize == 2) {
+        switch(channels) {
+            case(2):
+                return simdKernel(interleaveStereo16Sse2, interleaveStereo16Avx2);
+            case(6):
+                return interleaveSurround16Sse2<6>;
+            case(8):
+                return interleaveSurround16Sse2<8>;
+            default:
+                return nullptr;
+        }
+    }
+    if(sampleSize == 4) {
+        switch(channels) {
+            case(2):
+                return simdKernel(interleaveStereo32Sse2, interleaveStereo32Avx2);
+            case(6):
+                return interleaveSurround32Sse2<6>;
+            case(8):
+                return interleaveSurround32Sse2<8>;
+            default:
+                return nullptr;
+        }
+    }
+#endif
+    return nullptr;
+}
+
+// Gain is applied in float (double for 32-bit samples to keep their precision), saturating integer samples
+template <typename Type>
+void applyGainScalar(std::byte* data, size_t offset, size_t count, float gain)
+{
+    for(size_t i{offset}; i < count; ++i) {
+        std::byte* address = data + (i * sizeof(Type));
+
+        Type sample;
+        std::memcpy(&sample, address, sizeof(Type));
+
+        if constexpr(std::is_same_v<Type, float>) {
+            sample *= gain;
+        }
+        else if constexpr(std::is_same_v<Type, uint8_t>) {
+            const int scaled = Fooyin::Math::fltToInt(static_cast<float>(sample - 0x80) * gain);
+            sample           = static_cast<uint8_t>(std::clamp(scaled, -0x80, 0x7F) + 0x80);
+        }
+        else {
+            static constexpr auto minValue = static_cast<double>(std::numeric_limits<Type>::min());
+            static constexpr auto maxValue = static_cast<double>(std::numeric_limits<Type>::max());
+
+            const double scaled = std::clamp(static_cast<double>(sample) * gain, minValue, maxValue);
+            sample              = static_cast<Type>(Fooyin::Math::fltToInt(scaled));
+        }
+
+        std::memcpy(address, &sample, sizeof(Type));
+    }
+}
+
+#ifdef FY_CONVERTER_SIMD
+void applyGainS16Sse2(std::byte* data, size_t count, float gain)
+{
+    const __m128 factor = _mm_set1_ps(gain);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        __m128i* address      = storeAddress128(data, i * sizeof(int16_t));
+        const __m128i samples = _mm_loadu_si128(address);
+        const __m128i lo      = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        const __m128i hi      = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+
+        const __m128i scaledLo = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(lo), factor));
+        const __m128i scaledHi = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(hi), factor));
+        _mm_storeu_si128(address, _mm_packs_epi32(scaledLo, scaledHi));
+    }
+
+    applyGainScalar<int16_t>(data, i, count, gain);
+}
+
+void applyGainFloatSse2(std::byte* data, size_t count, float gain)
+{
+    const __m128 factor = _mm_set1_ps(gain);
+    auto* samples       = reinterpret_cast<float*>(data);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), factor));
+        _mm_storeu_ps(samples + i + 4, _mm_mul_ps(_mm_loadu_ps(samples + i + 4), factor));
+    }
+
+    applyGainScalar<float>(data, i, count, gain);
+}
+#endif
+
+void applyGainToSamples(SampleFormat format, std::byte* data, size_t count, float gain)
+{
+    switch(kernelFormat(format)) {
+        case(SampleFormat::U8):
+            applyGainScalar<uint8_t>(data, 0, count, gain);
+            break;
+        case(SampleFormat::S16):
+#ifdef FY_CONVERTER_SIMD
+            applyGainS16Sse2(data, count, gain);
+#else
+            applyGainScalar<int16_t>(data, 0, count, gain);
+#endif
+            break;
+        case(SampleFormat::S32):
+            applyGainScalar<int32_t>(data, 0, count, gain);
+            break;
+        case(SampleFormat::F32):
+#ifdef FY_CONVERTER_SIMD
+            applyGainFloatSse2(data, count, gain);
+#else
+            applyGainScalar<float>(data, 0, count, gain);
+#endif
+            break;
+        case(SampleFormat::S24):
+        case(SampleFormat::Unknown):
+            break;
+    }
+}
+
+#undef FY_AVX2
 } // namespace
 
 namespace Fooyin::Audio {
@@ -304,4 +1051,37 @@ bool convert(const AudioFormat& inputFormat, const std::byte* input, const Audio
     return true;
 }
 
+void applyGain(const AudioFormat& format, std::byte* data, int frameCount, float gain)
+{
+    if(!format.isValid() || frameCount <= 0 || gain == 1.0F) {
+        return;
+    }
+
+    const auto count = static_cast<size_t>(frameCount) * format.channelCount();
+
+    if(gain == 0.0F && format.sampleFormat() != SampleFormat::U8) {
+        std::memset(data, 0, count * format.bytesPerSample());
+        return;
+    }
+
+    // Rounds to nearest like the conversions above
+    const RoundingGuard rounding{format.sampleFormat() != SampleFormat::F32};
+    applyGainToSamples(format.sampleFormat(), data, count, gain);
+}
+
+void interleave(const std::byte* const* planes, int channels, int bytesPerSample, int frameCount, std::byte* output)
+{
+    if(channels <= 0 || bytesPerSample <= 0 || frameCount <= 0) {
+        return;
+    }
+
+    const auto frames = static_cast<size_t>(frameCount);
+
+    size_t written{0};
+    if(const InterleaveKernel kernel = findInterleaveKernel(channels, bytesPerSample)) {
+        written = kernel(planes, frames, output);
+    }
+
+    interleaveGeneric(planes, channels, bytesPerSample, written, frames, output);
+}
 } // namespace Fooyin::Audio
@@ -0,0 +1,304 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audiodecodeworker.h"
+
+#include "audiobufferpool.h"
+#include "audioringbuffer.h"
+#include "ffmpeg/ffmpegresampler.h"
+
+#include <core/engine/audioengine.h>
+#include <core/engine/audioinput.h>
+
+#include <QThread>
+
+#include <algorithm>
+
+using namespace std::chrono_literals;
+
+// Largest chunk decoded at once, which bounds how long stop() can wait
+constexpr auto MaxDecodeLength = 200;
+// Headroom for any frames held back by the resampler
+constexpr auto ResamplerSlack = 256;
+constexpr auto StatsInterval   = 10s;
+
+namespace Fooyin {
+AudioDecodeWorker::AudioDecodeWorker(AudioRingBuffer* buffer, EndFunc endFunc)
+    : m_buffer{buffer}
+    , m_endFunc{std::move(endFunc)}
+    , m_bufferLength{0}
+    , m_generation{0}
+    , m_wakeups{0}
+    , m_statsWakeups{0}
+    , m_statsAllocations{0}
+    , m_pendingDecoder{nullptr}
+    , m_active{false}
+    , m_wakeRequested{false}
+    , m_lowWater{false}
+    , m_closing{false}
+{
+    m_buffer->setLowWaterCallback([this]() { onLowWater(); });
+
+    m_thread.reset(QThread::create([this]() { run(); }));
+    m_thread->setObjectName(QStringLiteral("Decoder"));
+    m_thread->start(QThread::HighPriority);
+}
+
+AudioDecodeWorker::~AudioDecodeWorker()
+{
+    {
+        const std::scoped_lock lock{m_mutex};
+        m_closing = true;
+        m_active  = false;
+        m_generation.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_wake.notify_one();
+
+    m_thread->wait();
+    m_buffer->disarmLowWater();
+    m_buffer->setLowWaterCallback({});
+}
+
+void AudioDecodeWorker::setBufferLength(uint64_t ms)
+{
+    m_bufferLength.store(ms, std::memory_order_relaxed);
+}
+
+void AudioDecodeWorker::setGain(float gain)
+{
+    const std::scoped_lock lock{m_mutex};
+    m_source.gain = gain;
+}
+
+void AudioDecodeWorker::start(const Source& source)
+{
+    pause();
+
+    {
+        const std::scoped_lock lock{m_mutex};
+        m_source        = source;
+        m_active        = true;
+        m_wakeRequested = true;
+        m_generation.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_wake.notify_one();
+}
+
+void AudioDecodeWorker::stop()
+{
+    pause();
+
+    const std::scoped_lock decodeLock{m_decodeMutex};
+    m_pending.reset();
+}
+
+void AudioDecodeWorker::pause()
+{
+    {
+        const std::scoped_lock lock{m_mutex};
+        m_active        = false;
+        m_wakeRequested = false;
+        m_lowWater      = false;
+        m_generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    m_buffer->disarmLowWater();
+
+    // Wait for any in-progress read to finish
+    const std::scoped_lock decodeLock{m_decodeMutex};
+}
+
+bool AudioDecodeWorker::isRunning() const
+{
+    const std::scoped_lock lock{m_mutex};
+    return m_active;
+}
+
+uint64_t AudioDecodeWorker::generation() const
+{
+    return m_generation.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioDecodeWorker::wakeups() const
+{
+    return m_wakeups.load(std::memory_order_relaxed);
+}
+
+void AudioDecodeWorker::run()
+{
+    m_statsStart       = std::chrono::steady_clock::now();
+    m_statsAllocations = AudioBufferPool::instance().allocations();
+
+    std::unique_lock lock{m_mutex};
+
+    while(!m_closing) {
+        if(m_active && !m_wakeRequested && !m_lowWater) {
+            const uint64_t lowWaterLength = m_bufferLength.load(std::memory_order_relaxed) / 2;
+            const auto lowWaterBytes      = static_cast<size_t>(m_source.format.bytesForDuration(lowWaterLength));
+            if(!m_buffer->armLowWater(lowWaterBytes)) {
+                m_lowWater = true;
+            }
+        }
+
+        m_wake.wait(lock, [this]() { return m_closing || (m_active && (m_wakeRequested || m_lowWater)); });
+
+        if(m_closing) {
+            break;
+        }
+
+        m_wakeRequested = false;
+        m_lowWater      = false;
+
+        const Source source       = m_source;
+        const uint64_t generation = m_generation.load(std::memory_order_relaxed);
+
+        lock.unlock();
+
+        m_wakeups.fetch_add(1, std::memory_order_relaxed);
+        logStats();
+        decodeAhead(source, generation);
+
+        lock.lock();
+    }
+}
+
+void AudioDecodeWorker::decodeAhead(const Source& source, uint64_t generation)
+{
+    const std::scoped_lock decodeLock{m_decodeMutex};
+
+    const auto& format = source.format;
+    uint64_t decodedPosition{0};
+
+    if(m_pending.isValid() && m_pendingDecoder != source.decoder) {
+        // Left over from a track that was replaced without stopping first
+        m_pending.reset();
+    }
+
+    while(m_generation.load(std::memory_order_relaxed) == generation) {
+        if(m_pending.isValid()) {
+            // Retry the buffer that didn't fit last time before decoding any further
+            if(!m_buffer->write(m_pending, source.gain)) {
+                return;
+            }
+            decodedPosition = m_pending.endTime();
+
+            const bool ended = source.stopAtEnd && m_pending.endTime() >= source.endPosition;
+            m_pending.reset();
+            if(ended) {
+                finish(generation);
+                return;
+            }
+            continue;
+        }
+
+        const uint64_t bufferLength = m_bufferLength.load(std::memory_order_relaxed);
+        const auto bufferedTime     = format.durationForBytes(static_cast<int>(m_buffer->bufferedBytes()));
+        const size_t freeBytes      = m_buffer->freeBytes();
+        if(bufferedTime >= bufferLength || freeBytes == 0) {
+            return;
+        }
+
+        auto maxBytes = std::min({freeBytes, static_cast<size_t>(format.bytesForDuration(bufferLength - bufferedTime)),
+                                  static_cast<size_t>(format.bytesForDuration(MaxDecodeLength))});
+        if(source.stopAtEnd && decodedPosition > 0 && decodedPosition < source.endPosition) {
+            maxBytes
+                = std::min(maxBytes, static_cast<size_t>(format.bytesForDuration(source.endPosition - decodedPosition)));
+        }
+
+        if(source.resampler) {
+            const int64_t outFrames = format.framesForBytes(static_cast<int>(maxBytes));
+            const auto inFrames     = static_cast<int>(
+                (outFrames * source.decoderFormat.sampleRate() / format.sampleRate()) - ResamplerSlack);
+            if(inFrames <= 0) {
+                return;
+            }
+            maxBytes = static_cast<size_t>(source.decoderFormat.bytesForFrames(inFrames));
+        }
+
+        auto buffer = source.decoder->readBuffer(maxBytes);
+        if(buffer.isValid() && source.resampler) {
+            const uint64_t startTime = buffer.startTime();
+            buffer                   = source.resampler->resample(buffer);
+            buffer.setStartTime(startTime);
+        }
+        if(buffer.isValid()) {
+            if(!m_buffer->write(buffer, source.gain)) {
+                // The resampler's output can exceed the space we asked for, so hold on to it until the next wake
+                m_pending        = buffer;
+                m_pendingDecoder = source.decoder;
+                return;
+            }
+            decodedPosition = buffer.endTime();
+        }
+
+        if(!buffer.isValid() || (source.stopAtEnd && buffer.endTime() >= source.endPosition)) {
+            finish(generation);
+            return;
+        }
+    }
+}
+
+void AudioDecodeWorker::finish(uint64_t generation)
+{
+    m_buffer->writeEnd();
+
+    {
+        const std::scoped_lock lock{m_mutex};
+        if(m_generation.load(std::memory_order_relaxed) != generation) {
+            return;
+        }
+        m_active = false;
+    }
+
+    if(m_endFunc) {
+        m_endFunc(generation);
+    }
+}
+
+void AudioDecodeWorker::onLowWater()
+{
+    {
+        const std::scoped_lock lock{m_mutex};
+        m_lowWater = true;
+    }
+    m_wake.notify_one();
+}
+
+void AudioDecodeWorker::logStats()
+{
+    ++m_statsWakeups;
+
+    const auto now     = std::chrono::steady_clock::now();
+    const auto elapsed = std::chrono::duration<double>(now - m_statsStart);
+    if(elapsed < StatsInterval) {
+        return;
+    }
+
+    // Should stay at 0 once playback has settled, as buffers are recycled through the pool
+    const uint64_t allocations = AudioBufferPool::instance().allocations();
+
+    qCDebug(ENGINE) << "Decoder wakeups/sec:" << static_cast<double>(m_statsWakeups) / elapsed.count();
+    qCDebug(ENGINE) << "Audio buffer allocations/sec:"
+                    << static_cast<double>(allocations - m_statsAllocations) / elapsed.count();
+
+    m_statsStart       = now;
+    m_statsWakeups     = 0;
+    m_statsAllocations = allocations;
+}
+} // namespace Fooyin
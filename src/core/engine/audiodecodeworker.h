@@ -0,0 +1,129 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <core/engine/audiobuffer.h>
+#include <core/engine/audioformat.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+class QThread;
+
+namespace Fooyin {
+class AudioDecoder;
+class AudioRingBuffer;
+class FFmpegResampler;
+
+/*!
+ * Decodes ahead into an AudioRingBuffer on a dedicated thread.
+ * The worker sleeps until the renderer drains the buffer to its low-water mark, then decodes until
+ * the configured buffer length is queued, rather than waking on a timer.
+ *
+ * The decoder (and resampler) are only used by the worker between start() and stop(). stop() waits for at most
+ * a single in-progress read, after which the caller is free to seek, stop or replace them.
+ */
+class AudioDecodeWorker
+{
+public:
+    struct Source
+    {
+        AudioDecoder* decoder{nullptr};
+        // Format written to the buffer
+        AudioFormat format;
+        // Converts decoded audio to @c format if the decoder's output differs
+        FFmpegResampler* resampler{nullptr};
+        AudioFormat decoderFormat;
+        // Stop decoding once this position is reached (used for tracks sharing a file)
+        uint64_t endPosition{0};
+        bool stopAtEnd{false};
+        // Gain applied by the renderer to every buffer written (e.g. ReplayGain)
+        float gain{1.0F};
+    };
+
+    /** Called on the worker thread once the end of a track is written, with the generation it was started with. */
+    using EndFunc = std::function<void(uint64_t generation)>;
+
+    AudioDecodeWorker(AudioRingBuffer* buffer, EndFunc endFunc);
+    ~AudioDecodeWorker();
+
+    AudioDecodeWorker(const AudioDecodeWorker&)            = delete;
+    AudioDecodeWorker& operator=(const AudioDecodeWorker&) = delete;
+
+    void setBufferLength(uint64_t ms);
+    /** Changes the gain of the current source, taking effect from the next buffer decoded. */
+    void setGain(float gain);
+
+    /** Starts decoding @p source, stopping any previous track first. */
+    void start(const Source& source);
+    /** Stops decoding, returning once the decoder is no longer in use. */
+    void stop();
+    /**
+     * As stop(), but keeps any audio already decoded that didn't fit in the buffer, so starting
+     * again with the same decoder carries on without a gap.
+     */
+    void pause();
+
+    [[nodiscard]] bool isRunning() const;
+    /** Incremented on every start(), stop() and pause(). */
+    [[nodiscard]] uint64_t generation() const;
+    /** Returns the number of times the worker has woken up to decode since it was created. */
+    [[nodiscard]] uint64_t wakeups() const;
+
+private:
+    void run();
+    void decodeAhead(const Source& source, uint64_t generation);
+    void finish(uint64_t generation);
+    void onLowWater();
+    void logStats();
+
+    AudioRingBuffer* m_buffer;
+    EndFunc m_endFunc;
+    std::unique_ptr<QThread> m_thread;
+
+    std::atomic<uint64_t> m_bufferLength;
+    std::atomic<uint64_t> m_generation;
+    std::atomic<uint64_t> m_wakeups;
+
+    // Worker thread only
+    std::chrono::steady_clock::time_point m_statsStart;
+    uint64_t m_statsWakeups;
+    uint64_t m_statsAllocations;
+    // Decoded but not yet written as the ring buffer was full, guarded by m_decodeMutex
+    AudioBuffer m_pending;
+    AudioDecoder* m_pendingDecoder;
+
+    // Guarded by m_mutex
+    Source m_source;
+    bool m_active;
+    bool m_wakeRequested;
+    bool m_lowWater;
+    bool m_closing;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    // Held while the decoder is in use
+    std::mutex m_decodeMutex;
+};
+} // namespace Fooyin
@@ -34,6 +34,10 @@ AudioEngine::TrackStatus AudioEngine::trackStatus() const
     return m_trackStatus.load(std::memory_order_acquire);
 }
 
+void AudioEngine::prepareNextTrack(const Track& /*track*/) { }
+
+void AudioEngine::setDspChain(const DspEntries& /*chain*/) { }
+
 AudioEngine::PlaybackState AudioEngine::updateState(PlaybackState state)
 {
     const PlaybackState prevState = playbackState();
@@ -229,6 +229,23 @@ AudioDecoder* AudioLoader::decoderForTrack(const Track& track) const
     return decoderForFile(track.filepath());
 }
 
+std::unique_ptr<AudioDecoder> AudioLoader::createDecoderForTrack(const Track& track) const
+{
+    const std::shared_lock lock{p->m_decoderMutex};
+
+    const QString ext      = QFileInfo{track.filepath()}.suffix().toLower();
+    const bool isInArchive = track.isInArchive();
+
+    for(const auto& loader : p->m_decoders) {
+        if(loader.enabled
+           && ((isInArchive && loader.name == u"Archive") || (!isInArchive && loader.extensions.contains(ext)))) {
+            return loader.creator();
+        }
+    }
+
+    return nullptr;
+}
+
 AudioReader* AudioLoader::readerForFile(const QString& file) const
 {
     const std::shared_lock lock{p->m_readerMutex};
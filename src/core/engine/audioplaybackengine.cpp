@@ -22,6 +22,7 @@
 #include "audioclock.h"
 #include "audiorenderer.h"
 #include "internalcoresettings.h"
+#include "replaygain.h"
 
 #include <core/coresettings.h>
 #include <core/engine/audiobuffer.h>
@@ -37,15 +38,11 @@
 using namespace std::chrono_literals;
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
-constexpr auto BufferInterval   = 5ms;
 constexpr auto PositionInterval = 50ms;
 #else
-constexpr auto BufferInterval   = 5;
 constexpr auto PositionInterval = 50;
 #endif
 
-constexpr auto MaxDecodeLength = 200;
-
 namespace Fooyin {
 AudioPlaybackEngine::AudioPlaybackEngine(std::shared_ptr<AudioLoader> audioLoader, SettingsManager* settings,
                                          QObject* parent)
@@ -57,7 +54,6 @@ AudioPlaybackEngine::AudioPlaybackEngine(std::shared_ptr<AudioLoader> audioLoade
     , m_startPosition{0}
     , m_endPosition{0}
     , m_lastPosition{0}
-    , m_totalBufferTime{0}
     , m_bufferLength{static_cast<uint64_t>(m_settings->value<Settings::Core::BufferLength>())}
     , m_duration{0}
     , m_volume{1.0}
@@ -65,19 +61,31 @@ AudioPlaybackEngine::AudioPlaybackEngine(std::shared_ptr<AudioLoader> audioLoade
     , m_decoding{false}
     , m_updatingTrack{false}
     , m_pauseNextTrack{false}
+    , m_nextTrackCancelled{false}
     , m_outputThread{new QThread(this)}
+    , m_decodeWorker{&m_ringBuffer,
+                     [this](uint64_t generation) {
+                         QMetaObject::invokeMethod(this, [this, generation]() { onDecodingFinished(generation); });
+                     }}
+    , m_renderer{&m_ringBuffer}
     , m_fadeIntervals{m_settings->value<Settings::Core::Internal::FadingIntervals>().value<FadingIntervals>()}
 {
+    m_decodeWorker.setBufferLength(m_bufferLength);
     m_renderer.moveToThread(m_outputThread);
 
-    QObject::connect(&m_renderer, &AudioRenderer::bufferProcessed, this, &AudioPlaybackEngine::onBufferProcessed);
     QObject::connect(&m_renderer, &AudioRenderer::finished, this, &AudioPlaybackEngine::onRendererFinished);
     QObject::connect(&m_renderer, &AudioRenderer::outputStateChanged, this, &AudioPlaybackEngine::handleOutputState);
     QObject::connect(&m_renderer, &AudioRenderer::error, this, &AudioPlaybackEngine::deviceError);
 
-    m_settings->subscribe<Settings::Core::BufferLength>(this, [this](int length) { m_bufferLength = length; });
+    m_settings->subscribe<Settings::Core::BufferLength>(this, [this](int length) {
+        m_bufferLength = length;
+        m_decodeWorker.setBufferLength(m_bufferLength);
+    });
     m_settings->subscribe<Settings::Core::Internal::FadingIntervals>(
         this, [this](const QVariant& fading) { m_fadeIntervals = fading.value<FadingIntervals>(); });
+    m_settings->subscribe<Settings::Core::ReplayGainMode>(this, &AudioPlaybackEngine::updateReplayGain);
+    m_settings->subscribe<Settings::Core::ReplayGainPreAmp>(this, &AudioPlaybackEngine::updateReplayGain);
+    m_settings->subscribe<Settings::Core::ReplayGainNoClipping>(this, &AudioPlaybackEngine::updateReplayGain);
 
     m_outputThread->start();
 }
@@ -108,16 +116,24 @@ void AudioPlaybackEngine::changeTrack(const Track& track)
 
     updateTrackStatus(TrackStatus::Loading);
 
-    m_decoder = m_audioLoader->decoderForTrack(track);
-    if(!m_decoder) {
+    if(m_nextTrack.decoder && track.uniqueFilepath() == m_nextTrack.track.uniqueFilepath()) {
+        switchToNextTrack();
+        return;
+    }
+
+    auto* decoder = m_audioLoader->decoderForTrack(track);
+    if(!decoder) {
+        m_decodeWorker.stop();
+        m_decoder = nullptr;
         updateTrackStatus(TrackStatus::Unreadable);
         return;
     }
 
     const Track prevTrack = std::exchange(m_currentTrack, track);
 
-    if(m_ending && track.filepath() == prevTrack.filepath() && m_endPosition == track.offset()) {
-        // Multi-track file
+    if(m_ending && !m_nextTrackCancelled && track.filepath() == prevTrack.filepath()
+       && m_endPosition == track.offset()) {
+        // Multi-track file, which the current decoder is already positioned at
         emit positionChanged(0);
         m_ending = false;
         m_clock.sync(0);
@@ -130,6 +146,10 @@ void AudioPlaybackEngine::changeTrack(const Track& track)
     }
 
     stopWorkers();
+    m_decoder = decoder;
+    m_ownedDecoder.reset();
+    m_decodeResampler.reset();
+
     emit positionChanged(0);
     m_ending = false;
     m_clock.setPaused(true);
@@ -147,6 +167,8 @@ void AudioPlaybackEngine::changeTrack(const Track& track)
         return;
     }
 
+    m_decoderFormat = format.value();
+
     if(m_decoder->trackHasChanged()) {
         m_updatingTrack = true;
         m_currentTrack  = m_decoder->changedTrack();
@@ -168,6 +190,86 @@ void AudioPlaybackEngine::changeTrack(const Track& track)
     });
 }
 
+void AudioPlaybackEngine::prepareNextTrack(const Track& track)
+{
+    if(m_nextTrack.decoder) {
+        if(track.uniqueFilepath() != m_nextTrack.track.uniqueFilepath()) {
+            cancelNextTrack();
+        }
+        return;
+    }
+
+    // Only one track can follow the end of the current one in the buffer
+    if(m_nextTrackCancelled || !m_ending || m_decodeWorker.isRunning()) {
+        return;
+    }
+
+    if(playbackState() != PlaybackState::Playing || !m_settings->value<Settings::Core::GaplessPlayback>()) {
+        return;
+    }
+
+    // Tracks in the same file are already seamless, and archives can't be opened alongside the current track
+    if(!track.isValid() || track.isInArchive() || track.filepath() == m_currentTrack.filepath()) {
+        return;
+    }
+
+    auto decoder = m_audioLoader->createDecoderForTrack(track);
+    if(!decoder) {
+        return;
+    }
+
+    auto file = std::make_unique<QFile>(track.filepath());
+    if(!file->open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    const AudioSource source{.filepath = track.filepath(), .device = file.get(), .archiveReader = nullptr};
+
+    const auto format = decoder->init(source, track, AudioDecoder::UpdateTracks);
+    if(!format) {
+        return;
+    }
+
+    std::unique_ptr<FFmpegResampler> resampler;
+    if(format.value() != m_format) {
+        resampler = std::make_unique<FFmpegResampler>(format.value(), m_format);
+        if(!resampler->canResample()) {
+            return;
+        }
+    }
+
+    qCDebug(ENGINE) << "Pre-rolling next track:" << track.filenameExt();
+
+    m_nextTrack.track     = decoder->trackHasChanged() ? decoder->changedTrack() : track;
+    m_nextTrack.file      = std::move(file);
+    m_nextTrack.source    = source;
+    m_nextTrack.format    = format.value();
+    m_nextTrack.resampler = std::move(resampler);
+    m_nextTrack.decoded   = false;
+    m_nextTrack.decoder   = std::move(decoder);
+
+    if(track.offset() > 0) {
+        m_nextTrack.decoder->seek(track.offset());
+    }
+    m_nextTrack.decoder->start();
+
+    // Decoded straight after the end of the current track, so playback continues without a gap
+    startNextTrackDecoding();
+}
+
+void AudioPlaybackEngine::startNextTrackDecoding()
+{
+    const uint64_t duration = m_nextTrack.track.duration();
+    m_decodeWorker.start({.decoder       = m_nextTrack.decoder.get(),
+                          .format        = m_format,
+                          .resampler     = m_nextTrack.resampler.get(),
+                          .decoderFormat = m_nextTrack.format,
+                          .endPosition   = duration == 0 ? std::numeric_limits<uint64_t>::max()
+                                                         : m_nextTrack.track.offset() + duration,
+                          .stopAtEnd     = m_nextTrack.track.hasCue(),
+                          .gain          = replayGain(m_nextTrack.track)});
+}
+
 void AudioPlaybackEngine::play()
 {
     if(waitForTrackLoaded(PlaybackState::Playing)) {
@@ -195,13 +297,21 @@ void AudioPlaybackEngine::play()
             m_decoding = true;
             m_decoder->start();
         }
-        m_bufferTimer.start(BufferInterval, this);
-        QMetaObject::invokeMethod(&m_renderer, &AudioRenderer::start);
 
         if(playbackState() == PlaybackState::Stopped && m_currentTrack.offset() > 0) {
+            m_decodeWorker.stop();
             m_decoder->seek(m_currentTrack.offset());
         }
 
+        if(!m_ending) {
+            startDecoding();
+        }
+        else if(m_nextTrack.decoder && !m_nextTrack.decoded) {
+            // Pausing stopped the worker part way through pre-rolling the next track
+            startNextTrackDecoding();
+        }
+        QMetaObject::invokeMethod(&m_renderer, &AudioRenderer::start);
+
         const bool canFade = m_settings->value<Settings::Core::Internal::EngineFading>()
                           && (playbackState() == PlaybackState::Paused || isFading());
         const int fadeLength = canFade ? calculateFadeLength(m_fadeIntervals.inPauseStop) : 0;
@@ -255,7 +365,7 @@ void AudioPlaybackEngine::pause()
 
     auto pauseEngine = [this](const uint64_t delay) {
         QTimer::singleShot(delay, this, [this]() {
-            m_bufferTimer.stop();
+            m_decodeWorker.pause();
             if(playbackState() != PlaybackState::Stopped) {
                 updateState(PlaybackState::Paused);
             }
@@ -340,7 +450,7 @@ void AudioPlaybackEngine::seek(uint64_t pos)
 
     if(playbackState() == PlaybackState::Playing) {
         m_clock.setPaused(false);
-        m_bufferTimer.start(BufferInterval, this);
+        startDecoding();
         QMetaObject::invokeMethod(&m_renderer, &AudioRenderer::start);
     }
     else {
@@ -413,12 +523,14 @@ void AudioPlaybackEngine::setOutputDevice(const QString& device)
     }
 }
 
+void AudioPlaybackEngine::setDspChain(const DspEntries& chain)
+{
+    QMetaObject::invokeMethod(&m_renderer, [this, chain]() { m_renderer.updateDspChain(chain); });
+}
+
 void AudioPlaybackEngine::timerEvent(QTimerEvent* event)
 {
-    if(event->timerId() == m_bufferTimer.timerId()) {
-        readNextBuffer();
-    }
-    else if(event->timerId() == m_posTimer.timerId()) {
+    if(event->timerId() == m_posTimer.timerId()) {
         updatePosition();
     }
 
@@ -434,15 +546,22 @@ AudioEngine::PlaybackState AudioPlaybackEngine::updateState(AudioEngine::Playbac
 
 void AudioPlaybackEngine::resetWorkers()
 {
-    m_bufferTimer.stop();
+    m_decodeWorker.stop();
+    clearNextTrack();
+    resetDecodeResampler();
+    m_ending = false;
+
     m_clock.setPaused(true);
+    m_ringBuffer.clear();
     QMetaObject::invokeMethod(&m_renderer, &AudioRenderer::reset);
-    m_totalBufferTime = 0;
 }
 
 void AudioPlaybackEngine::stopWorkers(bool full)
 {
-    m_bufferTimer.stop();
+    m_decodeWorker.stop();
+    clearNextTrack();
+    resetDecodeResampler();
+
     m_posTimer.stop();
 
     m_clock.setPaused(true);
@@ -450,7 +569,9 @@ void AudioPlaybackEngine::stopWorkers(bool full)
 
     m_pendingSeek = {};
     m_decoding    = false;
+    m_ending      = false;
 
+    m_ringBuffer.clear();
     QMetaObject::invokeMethod(&m_renderer, &AudioRenderer::stop);
 
     if(full) {
@@ -460,8 +581,6 @@ void AudioPlaybackEngine::stopWorkers(bool full)
     if(m_decoder && (full || playbackState() != PlaybackState::Stopped)) {
         m_decoder->stop();
     }
-
-    m_totalBufferTime = 0;
 }
 
 void AudioPlaybackEngine::handleOutputState(AudioOutput::State outState)
@@ -506,6 +625,9 @@ void AudioPlaybackEngine::updateFormat(const AudioFormat& nextFormat, const std:
 {
     const auto prevFormat = std::exchange(m_format, nextFormat);
 
+    // Applied by the renderer when it next starts
+    m_ringBuffer.clear(static_cast<size_t>(m_format.bytesForDuration(m_bufferLength)));
+
     if(m_settings->value<Settings::Core::GaplessPlayback>() && prevFormat == m_format
        && playbackState() != PlaybackState::Paused && m_outputState != AudioOutput::State::Error) {
         callback(true);
@@ -583,29 +705,126 @@ bool AudioPlaybackEngine::waitForTrackLoaded(PlaybackState state)
     return false;
 }
 
-void AudioPlaybackEngine::readNextBuffer()
+void AudioPlaybackEngine::switchToNextTrack()
 {
-    if(!m_decoder || m_totalBufferTime >= m_bufferLength) {
-        return;
+    qCDebug(ENGINE) << "Switching to pre-rolled track:" << m_nextTrack.track.filenameExt();
+
+    if(m_decoder) {
+        m_decoder->stop();
     }
 
-    const auto bytesToEnd = static_cast<size_t>(m_format.bytesForDuration(m_endPosition - m_lastPosition));
-    const auto bytesLeft
-        = std::min(bytesToEnd, static_cast<size_t>(m_format.bytesForDuration(m_bufferLength - m_totalBufferTime)));
-    const auto maxBytes = std::min(bytesLeft, static_cast<size_t>(m_format.bytesForDuration(MaxDecodeLength)));
+    m_ownedDecoder    = std::move(m_nextTrack.decoder);
+    m_decoder         = m_ownedDecoder.get();
+    m_file            = std::move(m_nextTrack.file);
+    m_source          = m_nextTrack.source;
+    m_decoderFormat   = m_nextTrack.format;
+    m_decodeResampler = std::move(m_nextTrack.resampler);
+    m_decoding        = true;
+
+    const bool decoded = m_nextTrack.decoded;
+    const Track track  = m_nextTrack.track;
+    clearNextTrack();
 
-    const auto buffer = m_decoder->readBuffer(maxBytes);
-    if(buffer.isValid()) {
-        m_totalBufferTime += buffer.duration();
-        QMetaObject::invokeMethod(&m_renderer, [this, buffer]() { m_renderer.queueBuffer(buffer); });
+    m_currentTrack = track;
+
+    emit positionChanged(0);
+    m_clock.sync(0);
+    setupDuration();
+
+    if(m_decoder->trackHasChanged()) {
+        m_updatingTrack = true;
+        emit trackChanged(m_currentTrack);
     }
 
-    if(!buffer.isValid() || (m_currentTrack.hasCue() && buffer.endTime() >= m_endPosition)) {
-        m_bufferTimer.stop();
-        QMetaObject::invokeMethod(&m_renderer, [this]() { m_renderer.queueBuffer({}); });
+    updateTrackStatus(TrackStatus::Buffered);
+
+    if(playbackState() == PlaybackState::Playing) {
+        m_clock.setPaused(false);
+    }
+
+    if(decoded) {
+        // The whole track is already buffered
         m_ending = true;
         emit trackAboutToFinish();
     }
+    else {
+        // Continue with the end position of the new track
+        m_ending = false;
+        startDecoding();
+    }
+}
+
+void AudioPlaybackEngine::clearNextTrack()
+{
+    m_nextTrack = {};
+
+    if(std::exchange(m_nextTrackCancelled, false)) {
+        m_renderer.setHoldAtEnd(false);
+    }
+}
+
+void AudioPlaybackEngine::cancelNextTrack()
+{
+    qCDebug(ENGINE) << "Upcoming track changed, cancelling pre-roll of:" << m_nextTrack.track.filenameExt();
+
+    // Audio for the pre-rolled track may already follow the end marker, so stop there until the buffer is cleared
+    m_renderer.setHoldAtEnd(true);
+    m_decodeWorker.stop();
+    m_nextTrack          = {};
+    m_nextTrackCancelled = true;
+}
+
+void AudioPlaybackEngine::resetDecodeResampler()
+{
+    // Drop any audio held back from before the reset
+    if(m_decodeResampler) {
+        m_decodeResampler = std::make_unique<FFmpegResampler>(m_decoderFormat, m_format);
+    }
+}
+
+float AudioPlaybackEngine::replayGain(const Track& track) const
+{
+    const auto mode = static_cast<ReplayGain::Mode>(m_settings->value<Settings::Core::ReplayGainMode>());
+    return ReplayGain::trackGain(track, mode, m_settings->value<Settings::Core::ReplayGainPreAmp>(),
+                                 m_settings->value<Settings::Core::ReplayGainNoClipping>());
+}
+
+void AudioPlaybackEngine::updateReplayGain()
+{
+    // Audio already in the buffer keeps the gain it was decoded with
+    m_decodeWorker.setGain(replayGain(m_nextTrack.decoder ? m_nextTrack.track : m_currentTrack));
+}
+
+void AudioPlaybackEngine::startDecoding()
+{
+    if(!m_decoder) {
+        return;
+    }
+
+    m_decodeWorker.start({.decoder       = m_decoder,
+                          .format        = m_format,
+                          .resampler     = m_decodeResampler.get(),
+                          .decoderFormat = m_decoderFormat,
+                          .endPosition   = m_endPosition,
+                          .stopAtEnd     = m_currentTrack.hasCue(),
+                          .gain          = replayGain(m_currentTrack)});
+}
+
+void AudioPlaybackEngine::onDecodingFinished(uint64_t generation)
+{
+    if(generation != m_decodeWorker.generation()) {
+        // Stopped or restarted since
+        return;
+    }
+
+    if(m_nextTrack.decoder) {
+        // Reported once the pre-rolled track becomes current
+        m_nextTrack.decoded = true;
+        return;
+    }
+
+    m_ending = true;
+    emit trackAboutToFinish();
 }
 
 void AudioPlaybackEngine::updatePosition()
@@ -622,11 +841,6 @@ void AudioPlaybackEngine::updatePosition()
     }
 }
 
-void AudioPlaybackEngine::onBufferProcessed(const AudioBuffer& buffer)
-{
-    m_totalBufferTime -= buffer.duration();
-}
-
 void AudioPlaybackEngine::onRendererFinished()
 {
     if(m_pauseNextTrack) {
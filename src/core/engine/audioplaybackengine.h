@@ -20,7 +20,9 @@
 #pragma once
 
 #include "audioclock.h"
+#include "audiodecodeworker.h"
 #include "audiorenderer.h"
+#include "audioringbuffer.h"
 #include "internalcoresettings.h"
 
 #include <core/engine/audioengine.h>
@@ -43,6 +45,7 @@ public:
     ~AudioPlaybackEngine() override;
 
     void changeTrack(const Track& track) override;
+    void prepareNextTrack(const Track& track) override;
 
     void play() override;
     void pause() override;
@@ -53,6 +56,7 @@ public:
 
     void setAudioOutput(const OutputCreator& output, const QString& device) override;
     void setOutputDevice(const QString& device) override;
+    void setDspChain(const DspEntries& chain) override;
 
 protected:
     void timerEvent(QTimerEvent* event) override;
@@ -71,9 +75,18 @@ private:
     bool checkReadyToDecode();
     bool waitForTrackLoaded(PlaybackState state);
 
-    void readNextBuffer();
+    void switchToNextTrack();
+    void clearNextTrack();
+    void cancelNextTrack();
+    void resetDecodeResampler();
+
+    [[nodiscard]] float replayGain(const Track& track) const;
+    void updateReplayGain();
+
+    void startDecoding();
+    void startNextTrackDecoding();
+    void onDecodingFinished(uint64_t generation);
     void updatePosition();
-    void onBufferProcessed(const AudioBuffer& buffer);
     void onRendererFinished();
 
     [[nodiscard]] bool trackIsValid() const;
@@ -81,8 +94,21 @@ private:
     [[nodiscard]] bool isFading() const;
     [[nodiscard]] int calculateFadeLength(int initialValue) const;
 
+    struct NextTrack
+    {
+        Track track;
+        std::unique_ptr<QFile> file;
+        AudioSource source;
+        std::unique_ptr<AudioDecoder> decoder;
+        AudioFormat format;
+        std::unique_ptr<FFmpegResampler> resampler;
+        bool decoded{false};
+    };
+
     std::shared_ptr<AudioLoader> m_audioLoader;
     AudioDecoder* m_decoder;
+    // Set if m_decoder was opened ahead of time for gapless playback
+    std::unique_ptr<AudioDecoder> m_ownedDecoder;
     SettingsManager* m_settings;
 
     AudioClock m_clock;
@@ -93,7 +119,6 @@ private:
     uint64_t m_endPosition;
     uint64_t m_lastPosition;
 
-    uint64_t m_totalBufferTime;
     uint64_t m_bufferLength;
 
     uint64_t m_duration;
@@ -102,17 +127,24 @@ private:
     bool m_decoding;
     bool m_updatingTrack;
     bool m_pauseNextTrack;
+    // Set once a pre-rolled track is dropped, until the buffer holding it is cleared
+    bool m_nextTrackCancelled;
 
     Track m_currentTrack;
     AudioSource m_source;
     std::unique_ptr<QFile> m_file;
     AudioFormat m_format;
+    AudioFormat m_decoderFormat;
+    // Converts the current track to m_format if it was spliced in with a different format
+    std::unique_ptr<FFmpegResampler> m_decodeResampler;
+    NextTrack m_nextTrack;
 
     QThread* m_outputThread;
+    AudioRingBuffer m_ringBuffer;
+    AudioDecodeWorker m_decodeWorker;
     AudioRenderer m_renderer;
 
     QBasicTimer m_posTimer;
-    QBasicTimer m_bufferTimer;
     QBasicTimer m_pauseTimer;
 
     FadingIntervals m_fadeIntervals;
@@ -19,7 +19,10 @@
 
 #include "audiorenderer.h"
 
+#include "audioringbuffer.h"
+
 #include <core/engine/audiobuffer.h>
+#include <core/engine/audioconverter.h>
 #include <core/engine/audiooutput.h>
 #include <utils/threadqueue.h>
 
@@ -35,14 +38,19 @@ using namespace std::chrono_literals;
 constexpr auto FadeInterval = 10;
 
 namespace Fooyin {
-AudioRenderer::AudioRenderer(QObject* parent)
+AudioRenderer::AudioRenderer(AudioRingBuffer* buffer, QObject* parent)
     : QObject{parent}
     , m_volume{0.0}
+    , m_softwareVolume{1.0}
     , m_bufferSize{0}
     , m_bufferPrefilled{false}
+    , m_buffer{buffer}
+    , m_resampledOffset{0}
+    , m_resampledGain{1.0F}
+    , m_resampledEnd{false}
     , m_samplePos{0}
-    , m_currentBufferOffset{0}
-    , m_currentBufferResampled{false}
+    , m_holdAtEnd{false}
+    , m_holding{false}
     , m_isRunning{false}
     , m_writeInterval{100}
     , m_fadeLength{0}
@@ -74,6 +82,8 @@ void AudioRenderer::init(const AudioFormat& format)
 
 void AudioRenderer::start()
 {
+    m_buffer->acknowledgeClear();
+
     if(std::exchange(m_isRunning, true)) {
         return;
     }
@@ -170,11 +180,6 @@ void AudioRenderer::pause(int fadeLength)
     m_fadeTimer.start(FadeInterval, this);
 }
 
-void AudioRenderer::queueBuffer(const AudioBuffer& buffer)
-{
-    m_bufferQueue.emplace(buffer);
-}
-
 bool AudioRenderer::resetResampler()
 {
     m_outputFormat = m_audioOutput->format();
@@ -235,10 +240,21 @@ void AudioRenderer::updateVolume(double volume)
     m_volume = volume;
 
     if(validOutputState()) {
-        m_audioOutput->setVolume(m_volume);
+        setOutputVolume(m_volume);
     }
 }
 
+void AudioRenderer::updateDspChain(const DspEntries& chain)
+{
+    // Applied between writes, so playback continues uninterrupted
+    m_dspChain.update(chain);
+}
+
+void AudioRenderer::setHoldAtEnd(bool hold)
+{
+    m_holdAtEnd.store(hold, std::memory_order_relaxed);
+}
+
 QString AudioRenderer::deviceError() const
 {
     return m_lastDeviceError;
@@ -258,12 +274,15 @@ void AudioRenderer::timerEvent(QTimerEvent* event)
 
 void AudioRenderer::resetBuffer()
 {
-    m_bufferPrefilled        = false;
-    m_samplePos              = 0;
-    m_currentBufferOffset    = 0;
-    m_currentBufferResampled = false;
-    m_bufferQueue            = {};
+    m_bufferPrefilled = false;
+    m_samplePos       = 0;
+    m_resampledOffset = 0;
+    m_resampledEnd    = false;
+    m_resampledBuffer.reset();
     m_tempBuffer.reset();
+    m_holding         = false;
+    m_buffer->acknowledgeClear();
+    m_dspChain.reset();
 }
 
 void AudioRenderer::resetFade(int length)
@@ -286,7 +305,7 @@ void AudioRenderer::handleFading()
 {
     auto updateOutputVolume = [this]() {
         if(m_audioOutput && m_audioOutput->initialised()) {
-            m_audioOutput->setVolume(m_fadeSteps > 0 && m_fadeVolume >= 0 ? m_fadeVolume : m_volume);
+            setOutputVolume(m_fadeSteps > 0 && m_fadeVolume >= 0 ? m_fadeVolume : m_volume);
         }
     };
 
@@ -325,6 +344,24 @@ void AudioRenderer::handleFading()
     m_fadeTimer.stop();
 }
 
+void AudioRenderer::setOutputVolume(double volume)
+{
+    if(m_audioOutput->supportsVolume()) {
+        m_softwareVolume = 1.0;
+        m_audioOutput->setVolume(volume);
+    }
+    else {
+        m_softwareVolume = volume;
+    }
+}
+
+void AudioRenderer::applyGain(int offset, int bytes, float gain)
+{
+    // ReplayGain and software volume are combined into a single pass over the samples
+    const auto totalGain = static_cast<float>(gain * m_softwareVolume);
+    Audio::applyGain(m_outputFormat, m_tempBuffer.data() + offset, m_outputFormat.framesForBytes(bytes), totalGain);
+}
+
 bool AudioRenderer::canWrite() const
 {
     return m_isRunning && m_audioOutput->initialised();
@@ -340,7 +377,13 @@ bool AudioRenderer::initOutput()
         return false;
     }
 
-    m_audioOutput->setVolume(m_volume);
+    m_dspChain.prepare(m_outputFormat);
+
+    // Formats may have changed
+    m_tempBuffer.reset();
+    m_readBuffer.reset();
+
+    setOutputVolume(m_volume);
     m_bufferSize = m_audioOutput->bufferSize();
     updateInterval();
 
@@ -379,7 +422,7 @@ void AudioRenderer::pauseOutput()
 
     if(validOutputState()) {
         const auto state       = m_audioOutput->currentState();
-        const uint64_t durLeft = m_outputFormat.durationForFrames(state.queuedSamples);
+        const uint64_t durLeft = m_outputFormat.durationForFrames(state.queuedSamples + m_dspChain.latency());
 
         emit paused(durLeft);
         drainOutput();
@@ -392,7 +435,7 @@ void AudioRenderer::pauseOutput()
 
 void AudioRenderer::writeNext()
 {
-    if(!canWrite() || m_bufferQueue.empty()) {
+    if(!canWrite()) {
         return;
     }
 
@@ -411,61 +454,122 @@ void AudioRenderer::writeNext()
 
 int AudioRenderer::writeAudioSamples(int samples)
 {
+    if(!m_tempBuffer.isValid()) {
+        m_tempBuffer = {m_outputFormat, 0};
+    }
+
+    if(m_holding) {
+        // Nothing after the end marker is played until the buffer has been cleared
+        if(!m_buffer->clearPending()) {
+            return 0;
+        }
+        m_holding = false;
+    }
+
+    const int sstride = m_outputFormat.bytesPerFrame();
+
     m_tempBuffer.clear();
+    m_tempBuffer.reserve(static_cast<size_t>(samples * sstride));
 
     int samplesBuffered{0};
+    bool endOfTrack{false};
+    bool trackEnded{false};
+
+    while(m_isRunning && samplesBuffered < samples) {
+        const int bytes     = (samples - samplesBuffered) * sstride;
+        const int bytesRead = m_resampler ? readResampledSamples(bytes, endOfTrack) : readSamples(bytes, endOfTrack);
 
-    while(m_isRunning && !m_bufferQueue.empty() && samplesBuffered < samples) {
-        AudioBuffer& buffer = m_bufferQueue.front();
+        samplesBuffered += bytesRead / sstride;
 
-        if(!buffer.isValid()) {
-            // End of file
-            m_currentBufferOffset    = 0;
-            m_currentBufferResampled = false;
-            m_bufferQueue.pop();
+        if(std::exchange(endOfTrack, false)) {
             emit finished();
-            return samplesBuffered;
+            trackEnded = true;
+            if(m_holdAtEnd.load(std::memory_order_relaxed)) {
+                m_holding = true;
+                break;
+            }
+            // Continue with any track queued after the end marker, so the two are joined without a gap
+            continue;
         }
+        if(bytesRead == 0) {
+            break;
+        }
+    }
 
-        if(m_resampler && !m_currentBufferResampled) {
-            buffer = m_resampler->resample(buffer);
+    if(samplesBuffered == 0) {
+        return 0;
+    }
 
-            m_currentBufferResampled = true;
-        }
+    if(!trackEnded) {
+        m_tempBuffer.fillRemainingWithSilence();
+    }
 
-        const int bytesLeft = buffer.byteCount() - m_currentBufferOffset;
+    return samplesBuffered;
+}
 
-        if(bytesLeft <= 0) {
-            m_currentBufferOffset    = 0;
-            m_currentBufferResampled = false;
-            emit bufferProcessed(buffer);
-            m_bufferQueue.pop();
-            continue;
-        }
+int AudioRenderer::readSamples(int bytes, bool& endOfTrack)
+{
+    const int offset = m_tempBuffer.byteCount();
+    m_tempBuffer.resize(static_cast<size_t>(offset + bytes));
 
-        const int sstride     = m_outputFormat.bytesPerFrame();
-        const int sampleCount = std::min(bytesLeft / sstride, samples - samplesBuffered);
-        const int bytes       = sampleCount * sstride;
-        const auto fdata      = buffer.constData().subspan(m_currentBufferOffset, static_cast<size_t>(bytes));
+    const auto result = m_buffer->read(m_tempBuffer.data() + offset, bytes);
+    m_tempBuffer.resize(static_cast<size_t>(offset + result.bytes));
+    applyGain(offset, result.bytes, result.gain);
 
-        if(!m_tempBuffer.isValid()) {
-            m_tempBuffer = {fdata, buffer.format(), buffer.startTime()};
+    if(offset == 0) {
+        m_tempBuffer.setStartTime(result.startTime);
+    }
+
+    endOfTrack = result.endOfTrack;
+    return result.bytes;
+}
+
+int AudioRenderer::readResampledSamples(int bytes, bool& endOfTrack)
+{
+    if(m_resampledOffset >= m_resampledBuffer.byteCount()) {
+        // Read roughly enough input to produce the requested output
+        const int64_t outFrames = m_outputFormat.framesForBytes(bytes);
+        const int64_t inRate    = m_format.sampleRate();
+        const int64_t outRate   = m_outputFormat.sampleRate();
+        const auto inFrames     = static_cast<int>((outFrames * inRate + outRate - 1) / outRate);
+        const int inBytes       = m_format.bytesForFrames(std::max(inFrames, 1));
+
+        if(!m_readBuffer.isValid()) {
+            m_readBuffer = {m_format, 0};
         }
-        else {
-            m_tempBuffer.append(fdata);
+        m_readBuffer.resize(static_cast<size_t>(inBytes));
+
+        const auto result = m_buffer->read(m_readBuffer.data(), inBytes);
+        if(result.bytes == 0) {
+            endOfTrack = result.endOfTrack;
+            return 0;
         }
 
-        samplesBuffered += sampleCount;
-        m_currentBufferOffset += bytes;
+        m_readBuffer.resize(static_cast<size_t>(result.bytes));
+        m_readBuffer.setStartTime(result.startTime);
+
+        m_resampledBuffer = m_resampler->resample(m_readBuffer);
+        m_resampledOffset = 0;
+        m_resampledGain   = result.gain;
+        m_resampledEnd    = result.endOfTrack;
     }
 
-    m_tempBuffer.fillRemainingWithSilence();
+    const int count = std::min(bytes, m_resampledBuffer.byteCount() - m_resampledOffset);
 
-    if(!m_tempBuffer.isValid()) {
-        return 0;
+    if(m_tempBuffer.byteCount() == 0) {
+        m_tempBuffer.setStartTime(m_resampledBuffer.startTime() + m_outputFormat.durationForBytes(m_resampledOffset));
     }
+    const int offset = m_tempBuffer.byteCount();
+    m_tempBuffer.append(m_resampledBuffer.constData().subspan(static_cast<size_t>(m_resampledOffset),
+                                                              static_cast<size_t>(count)));
+    applyGain(offset, count, m_resampledGain);
+    m_resampledOffset += count;
 
-    return samplesBuffered;
+    if(m_resampledOffset >= m_resampledBuffer.byteCount() && std::exchange(m_resampledEnd, false)) {
+        endOfTrack = true;
+    }
+
+    return count;
 }
 
 int AudioRenderer::renderAudio(int samples)
@@ -478,6 +582,8 @@ int AudioRenderer::renderAudio(int samples)
         return 0;
     }
 
+    m_dspChain.process(m_tempBuffer);
+
     const int samplesWritten = m_audioOutput->write(m_tempBuffer);
     m_samplePos += samplesWritten;
 
@@ -21,23 +21,25 @@
 
 #include <core/engine/audiooutput.h>
 
+#include "dsp/dspchain.h"
 #include "ffmpeg/ffmpegresampler.h"
 
 #include <QBasicTimer>
 #include <QObject>
 
-#include <queue>
+#include <atomic>
 
 namespace Fooyin {
 class AudioBuffer;
 class AudioFormat;
+class AudioRingBuffer;
 
 class AudioRenderer : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit AudioRenderer(QObject* parent = nullptr);
+    explicit AudioRenderer(AudioRingBuffer* buffer, QObject* parent = nullptr);
 
     void init(const AudioFormat& format);
     void start();
@@ -51,12 +53,16 @@ public:
     void pause();
     void pause(int fadeLength);
 
-    void queueBuffer(const AudioBuffer& buffer);
-
     bool resetResampler();
     void updateOutput(const OutputCreator& output, const QString& device);
     void updateDevice(const QString& device);
     void updateVolume(double volume);
+    void updateDspChain(const DspEntries& chain);
+    /*!
+     * While set, output stops at the next end of track marker instead of continuing with any audio
+     * written after it, until the buffer is cleared. Can be called from any thread.
+     */
+    void setHoldAtEnd(bool hold);
 
     [[nodiscard]] QString deviceError() const;
 
@@ -65,7 +71,6 @@ signals:
     void paused(uint64_t delay);
     void outputClosed();
     void outputStateChanged(AudioOutput::State state);
-    void bufferProcessed(const Fooyin::AudioBuffer& buffer);
     void error(const QString& error);
     void finished();
 
@@ -76,6 +81,8 @@ private:
     void resetBuffer();
     void resetFade(int length);
     void handleFading();
+    void setOutputVolume(double volume);
+    void applyGain(int offset, int bytes, float gain);
 
     [[nodiscard]] bool canWrite() const;
 
@@ -88,21 +95,31 @@ private:
     void pauseOutput();
     void writeNext();
     int writeAudioSamples(int samples);
+    int readSamples(int bytes, bool& endOfTrack);
+    int readResampledSamples(int bytes, bool& endOfTrack);
     int renderAudio(int samples);
 
     std::unique_ptr<AudioOutput> m_audioOutput;
     AudioFormat m_format;
     AudioFormat m_outputFormat;
     double m_volume;
+    // Applied to samples if the output doesn't support volume itself
+    double m_softwareVolume;
     int m_bufferSize;
     bool m_bufferPrefilled;
     std::unique_ptr<FFmpegResampler> m_resampler;
+    DspChain m_dspChain;
 
-    std::queue<AudioBuffer> m_bufferQueue;
+    AudioRingBuffer* m_buffer;
     AudioBuffer m_tempBuffer;
+    AudioBuffer m_readBuffer;
+    AudioBuffer m_resampledBuffer;
+    int m_resampledOffset;
+    float m_resampledGain;
+    bool m_resampledEnd;
     int m_samplePos;
-    int m_currentBufferOffset;
-    bool m_currentBufferResampled;
+    std::atomic<bool> m_holdAtEnd;
+    bool m_holding;
 
     bool m_isRunning;
     QString m_lastDeviceError;
@@ -0,0 +1,285 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audioringbuffer.h"
+
+#include <core/engine/audiobuffer.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace Fooyin {
+AudioRingBuffer::AudioRingBuffer()
+    : m_writePos{0}
+    , m_markerWritePos{0}
+    , m_clearRequests{0}
+    , m_requestedCapacity{0}
+    , m_lowWaterMark{0}
+    , m_lowWaterArmed{false}
+    , m_readPos{0}
+    , m_markerReadPos{0}
+    , m_clearsAcknowledged{0}
+    , m_segmentPos{0}
+    , m_segmentStartTime{0}
+    , m_segmentGain{1.0F}
+    , m_capacity{0}
+{ }
+
+void AudioRingBuffer::clear(size_t capacity)
+{
+    m_requestedCapacity.store(capacity, std::memory_order_relaxed);
+    m_clearRequests.fetch_add(1, std::memory_order_release);
+}
+
+void AudioRingBuffer::clear()
+{
+    clear(m_requestedCapacity.load(std::memory_order_relaxed));
+}
+
+size_t AudioRingBuffer::freeBytes() const
+{
+    if(clearPending()) {
+        return 0;
+    }
+
+    // Leave room for an end of track marker after the next buffer
+    if(freeMarkers() < 2) {
+        return 0;
+    }
+
+    const uint64_t readPos  = m_readPos.load(std::memory_order_acquire);
+    const uint64_t writePos = m_writePos.load(std::memory_order_relaxed);
+
+    return m_capacity - static_cast<size_t>(writePos - readPos);
+}
+
+bool AudioRingBuffer::write(const AudioBuffer& buffer, float gain)
+{
+    const auto data = buffer.constData();
+    if(data.empty() || data.size() > freeBytes()) {
+        return false;
+    }
+
+    const uint64_t writePos = m_writePos.load(std::memory_order_relaxed);
+
+    pushMarker({.position   = writePos,
+                .startTime  = buffer.startTime(),
+                .format     = buffer.format(),
+                .gain       = gain,
+                .endOfTrack = false});
+
+    const auto offset  = static_cast<size_t>(writePos % m_capacity);
+    const size_t first = std::min(data.size(), m_capacity - offset);
+
+    std::memcpy(m_data.data() + offset, data.data(), first);
+    std::memcpy(m_data.data(), data.data() + first, data.size() - first);
+
+    m_writePos.store(writePos + data.size(), std::memory_order_release);
+
+    return true;
+}
+
+bool AudioRingBuffer::writeEnd()
+{
+    if(clearPending() || freeMarkers() == 0) {
+        return false;
+    }
+
+    pushMarker({.position   = m_writePos.load(std::memory_order_relaxed),
+                .startTime  = 0,
+                .format     = {},
+                .gain       = 1.0F,
+                .endOfTrack = true});
+
+    return true;
+}
+
+void AudioRingBuffer::setLowWaterCallback(std::function<void()> callback)
+{
+    m_lowWaterCallback = std::move(callback);
+}
+
+bool AudioRingBuffer::armLowWater(size_t bytes)
+{
+    m_lowWaterMark.store(bytes, std::memory_order_relaxed);
+    m_lowWaterArmed.store(true, std::memory_order_relaxed);
+
+    // Pairs with the fence in checkLowWater, so either we see the consumer's read or it sees the armed flag
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if(bufferedBytes() <= bytes && freeBytes() > 0) {
+        m_lowWaterArmed.store(false, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+void AudioRingBuffer::disarmLowWater()
+{
+    m_lowWaterArmed.store(false, std::memory_order_relaxed);
+}
+
+AudioRingBuffer::ReadResult AudioRingBuffer::read(std::byte* data, int maxBytes)
+{
+    acknowledgeClear();
+
+    ReadResult result;
+
+    // Markers are published before the data they refer to, so load the write position first
+    const uint64_t writePos  = m_writePos.load(std::memory_order_acquire);
+    const uint64_t markerEnd = m_markerWritePos.load(std::memory_order_acquire);
+
+    uint64_t readPos   = m_readPos.load(std::memory_order_relaxed);
+    uint64_t markerPos = m_markerReadPos.load(std::memory_order_relaxed);
+
+    if(consumeMarkers(readPos, markerEnd, markerPos)) {
+        result.endOfTrack = true;
+        m_markerReadPos.store(markerPos, std::memory_order_release);
+        checkLowWater();
+        return result;
+    }
+
+    uint64_t limit = writePos;
+    if(markerPos != markerEnd) {
+        limit = std::min(limit, m_markers.at(markerPos % MaxMarkers).position);
+    }
+
+    const auto bytes = static_cast<size_t>(std::min<uint64_t>(std::max(maxBytes, 0), limit - readPos));
+
+    if(bytes > 0) {
+        const auto offset  = static_cast<size_t>(readPos % m_capacity);
+        const size_t first = std::min(bytes, m_capacity - offset);
+
+        std::memcpy(data, m_data.data() + offset, first);
+        std::memcpy(data + first, m_data.data(), bytes - first);
+
+        result.bytes     = static_cast<int>(bytes);
+        result.format    = m_segmentFormat;
+        result.gain      = m_segmentGain;
+        result.startTime = m_segmentStartTime
+                         + m_segmentFormat.durationForBytes(static_cast<int>(readPos - m_segmentPos));
+
+        readPos += bytes;
+        result.endOfTrack = consumeMarkers(readPos, markerEnd, markerPos);
+    }
+
+    m_markerReadPos.store(markerPos, std::memory_order_release);
+    m_readPos.store(readPos, std::memory_order_release);
+
+    checkLowWater();
+
+    return result;
+}
+
+void AudioRingBuffer::acknowledgeClear()
+{
+    const uint64_t requests = m_clearRequests.load(std::memory_order_acquire);
+    if(requests == m_clearsAcknowledged.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // The producer won't write again until the clear is acknowledged
+    const size_t capacity = m_requestedCapacity.load(std::memory_order_relaxed);
+    if(capacity != m_capacity) {
+        m_data     = std::vector<std::byte>(capacity);
+        m_capacity = capacity;
+    }
+
+    m_segmentPos       = m_writePos.load(std::memory_order_relaxed);
+    m_segmentStartTime = 0;
+    m_segmentFormat    = {};
+    m_segmentGain      = 1.0F;
+
+    m_markerReadPos.store(m_markerWritePos.load(std::memory_order_relaxed), std::memory_order_release);
+    m_readPos.store(m_segmentPos, std::memory_order_release);
+    m_clearsAcknowledged.store(requests, std::memory_order_release);
+
+    // The producer may be waiting for the clear before it can write again
+    checkLowWater();
+}
+
+size_t AudioRingBuffer::bufferedBytes() const
+{
+    // The read position can never pass a later load of the write position
+    const uint64_t readPos  = m_readPos.load(std::memory_order_acquire);
+    const uint64_t writePos = m_writePos.load(std::memory_order_acquire);
+
+    return static_cast<size_t>(writePos - readPos);
+}
+
+bool AudioRingBuffer::clearPending() const
+{
+    return m_clearRequests.load(std::memory_order_relaxed) != m_clearsAcknowledged.load(std::memory_order_acquire);
+}
+
+size_t AudioRingBuffer::freeMarkers() const
+{
+    const uint64_t markerRead  = m_markerReadPos.load(std::memory_order_acquire);
+    const uint64_t markerWrite = m_markerWritePos.load(std::memory_order_relaxed);
+
+    return MaxMarkers - static_cast<size_t>(markerWrite - markerRead);
+}
+
+void AudioRingBuffer::pushMarker(const Marker& marker)
+{
+    const uint64_t markerPos = m_markerWritePos.load(std::memory_order_relaxed);
+
+    m_markers.at(markerPos % MaxMarkers) = marker;
+    m_markerWritePos.store(markerPos + 1, std::memory_order_release);
+}
+
+void AudioRingBuffer::checkLowWater()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if(!m_lowWaterArmed.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    if(bufferedBytes() <= m_lowWaterMark.load(std::memory_order_relaxed)
+       && m_lowWaterArmed.exchange(false, std::memory_order_relaxed) && m_lowWaterCallback) {
+        m_lowWaterCallback();
+    }
+}
+
+bool AudioRingBuffer::consumeMarkers(uint64_t readPos, uint64_t markerEnd, uint64_t& markerPos)
+{
+    while(markerPos != markerEnd) {
+        const Marker& marker = m_markers.at(markerPos % MaxMarkers);
+        if(marker.position > readPos) {
+            break;
+        }
+
+        ++markerPos;
+
+        if(marker.endOfTrack) {
+            // Leave any markers for the next track until the next read
+            return true;
+        }
+
+        m_segmentPos       = marker.position;
+        m_segmentStartTime = marker.startTime;
+        m_segmentFormat    = marker.format;
+        m_segmentGain      = marker.gain;
+    }
+
+    return false;
+}
+} // namespace Fooyin
@@ -0,0 +1,152 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/engine/audioformat.h>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace Fooyin {
+class AudioBuffer;
+
+/*!
+ * A fixed-size single-producer/single-consumer queue of PCM data passed from the decoder to the renderer.
+ * The producer appends whole buffers with write() and the consumer pulls bytes with read(), without locking
+ * or allocating. Each buffer's timestamp, format and gain, as well as end of track markers, are passed
+ * alongside the data. The fill level can be queried from any thread.
+ *
+ * Storage is only (re)allocated by the consumer in response to clear(), and the producer is unable to write
+ * until the consumer has acknowledged the clear by calling read() or acknowledgeClear().
+ *
+ * Rather than polling the fill level, a producer can arm a low-water mark with armLowWater(). The consumer
+ * then calls the low-water callback once, from its own thread, when a read drains the buffer to the mark.
+ */
+class FYCORE_EXPORT AudioRingBuffer
+{
+public:
+    struct ReadResult
+    {
+        int bytes{0};
+        uint64_t startTime{0};
+        AudioFormat format;
+        float gain{1.0F};
+        bool endOfTrack{false};
+    };
+
+    AudioRingBuffer();
+
+    AudioRingBuffer(const AudioRingBuffer&)            = delete;
+    AudioRingBuffer& operator=(const AudioRingBuffer&) = delete;
+
+    // Producer
+
+    /** Discards all data, resizing the buffer to @p capacity bytes once acknowledged. */
+    void clear(size_t capacity);
+    /** Discards all data, keeping the last requested capacity. */
+    void clear();
+
+    /** Returns the number of bytes which can currently be written, or 0 if a clear is pending. */
+    [[nodiscard]] size_t freeBytes() const;
+    /*!
+     * Appends the whole of @p buffer, returning false if it doesn't fit.
+     * @p gain is passed to the consumer to be applied to the buffer on output.
+     */
+    bool write(const AudioBuffer& buffer, float gain = 1.0F);
+    /** Marks the end of the current track at the current write position. */
+    bool writeEnd();
+
+    /** Sets the function called by the consumer once an armed low-water mark is reached. */
+    void setLowWaterCallback(std::function<void()> callback);
+    /*!
+     * Arms a low-water mark of @p bytes, so the low-water callback is called once the fill level falls to it.
+     * Returns false without arming if the fill level is already at or below @p bytes and there is room to write.
+     * While nothing can be written (e.g. a clear is pending), the mark stays armed and the callback is called
+     * once the consumer has made room.
+     */
+    bool armLowWater(size_t bytes);
+    /** Disarms any low-water mark set by armLowWater(). */
+    void disarmLowWater();
+
+    // Consumer
+
+    /*!
+     * Reads up to @p maxBytes into @p data. A single read never spans more than one written buffer,
+     * so the result's timestamp, format and gain apply to every byte read. @c endOfTrack is set once the last
+     * byte of a track has been read.
+     */
+    ReadResult read(std::byte* data, int maxBytes);
+    /** Applies any pending clear. */
+    void acknowledgeClear();
+
+    // Any thread
+
+    [[nodiscard]] size_t bufferedBytes() const;
+    [[nodiscard]] bool clearPending() const;
+
+private:
+    static constexpr size_t MaxMarkers    = 256;
+    static constexpr size_t CacheLineSize = 64;
+
+    struct Marker
+    {
+        uint64_t position{0};
+        uint64_t startTime{0};
+        AudioFormat format;
+        float gain{1.0F};
+        bool endOfTrack{false};
+    };
+
+    [[nodiscard]] size_t freeMarkers() const;
+    void pushMarker(const Marker& marker);
+    bool consumeMarkers(uint64_t readPos, uint64_t markerEnd, uint64_t& markerPos);
+    void checkLowWater();
+
+    // Written by the producer
+    alignas(CacheLineSize) std::atomic<uint64_t> m_writePos;
+    std::atomic<uint64_t> m_markerWritePos;
+    std::atomic<uint64_t> m_clearRequests;
+    std::atomic<size_t> m_requestedCapacity;
+    std::atomic<size_t> m_lowWaterMark;
+    std::atomic<bool> m_lowWaterArmed;
+
+    // Written by the consumer
+    alignas(CacheLineSize) std::atomic<uint64_t> m_readPos;
+    std::atomic<uint64_t> m_markerReadPos;
+    std::atomic<uint64_t> m_clearsAcknowledged;
+
+    // Consumer only
+    uint64_t m_segmentPos;
+    uint64_t m_segmentStartTime;
+    AudioFormat m_segmentFormat;
+    float m_segmentGain;
+
+    // Only resized by the consumer while the producer is blocked
+    alignas(CacheLineSize) std::vector<std::byte> m_data;
+    size_t m_capacity;
+    std::array<Marker, MaxMarkers> m_markers;
+
+    std::function<void()> m_lowWaterCallback;
+};
+} // namespace Fooyin
@@ -0,0 +1,86 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "crossfeed.h"
+
+#include <QObject>
+
+#include <cmath>
+#include <numbers>
+
+namespace Fooyin {
+Crossfeed::Crossfeed(double cutoff, double level)
+    : m_cutoff{cutoff}
+    , m_level{level}
+    , m_coefficient{0.0F}
+    , m_feed{0.0F}
+    , m_normalise{1.0F}
+    , m_lowLeft{0.0F}
+    , m_lowRight{0.0F}
+{ }
+
+QString Crossfeed::name() const
+{
+    return QObject::tr("Crossfeed");
+}
+
+bool Crossfeed::prepare(const AudioFormat& format, int /*blockFrames*/)
+{
+    if(format.channelCount() != 2 || format.sampleRate() <= 0) {
+        return false;
+    }
+
+    // One-pole low-pass
+    const double sampleRate = format.sampleRate();
+    m_coefficient = static_cast<float>(1.0 - std::exp(-2.0 * std::numbers::pi * m_cutoff / sampleRate));
+    m_feed        = static_cast<float>(std::pow(10.0, -m_level / 20.0));
+    m_normalise   = 1.0F / (1.0F + m_feed);
+
+    reset();
+
+    return true;
+}
+
+void Crossfeed::process(float* data, int frameCount)
+{
+    float lowLeft  = m_lowLeft;
+    float lowRight = m_lowRight;
+
+    for(int frame{0}; frame < frameCount; ++frame) {
+        float* samples    = data + (static_cast<size_t>(frame) * 2);
+        const float left  = samples[0];
+        const float right = samples[1];
+
+        lowLeft += m_coefficient * (left - lowLeft);
+        lowRight += m_coefficient * (right - lowRight);
+
+        samples[0] = (left + (m_feed * lowRight)) * m_normalise;
+        samples[1] = (right + (m_feed * lowLeft)) * m_normalise;
+    }
+
+    m_lowLeft  = lowLeft;
+    m_lowRight = lowRight;
+}
+
+void Crossfeed::reset()
+{
+    m_lowLeft  = 0.0F;
+    m_lowRight = 0.0F;
+}
+} // namespace Fooyin
@@ -0,0 +1,54 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/engine/dspnode.h>
+
+namespace Fooyin {
+/*!
+ * Headphone crossfeed for stereo audio.
+ * Mixes a low-passed copy of each channel into the opposite one, approximating how low frequencies
+ * from each speaker reach both ears, then normalises so overall level is unchanged.
+ */
+class FYCORE_EXPORT Crossfeed : public DspNode
+{
+public:
+    /** @p cutoff is in Hz, and @p level is the attenuation of the crossfed signal in dB. */
+    explicit Crossfeed(double cutoff = 700.0, double level = 4.5);
+
+    [[nodiscard]] QString name() const override;
+
+    bool prepare(const AudioFormat& format, int blockFrames) override;
+    void process(float* data, int frameCount) override;
+    void reset() override;
+
+private:
+    double m_cutoff;
+    double m_level;
+
+    float m_coefficient;
+    float m_feed;
+    float m_normalise;
+    float m_lowLeft;
+    float m_lowRight;
+};
+} // namespace Fooyin
@@ -0,0 +1,199 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dspchain.h"
+
+#include <core/engine/audiobuffer.h>
+#include <core/engine/audioconverter.h>
+#include <core/engine/audioengine.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace Fooyin {
+DspChain::DspChain()
+    : m_blockFrames{DefaultBlockFrames}
+{ }
+
+void DspChain::update(const DspEntries& entries)
+{
+    std::vector<Node> nodes;
+    nodes.reserve(entries.size());
+
+    for(const auto& entry : entries) {
+        auto existing = std::ranges::find_if(m_nodes, [&entry](const Node& node) {
+            return node.node && node.name == entry.name;
+        });
+        if(existing != m_nodes.end()) {
+            if(existing->settings != entry.settings) {
+                existing->settings = entry.settings;
+                existing->node->setSettings(entry.settings);
+            }
+            nodes.push_back(std::move(*existing));
+            continue;
+        }
+
+        if(!entry.creator) {
+            continue;
+        }
+
+        Node node{.name = entry.name, .node = entry.creator(), .settings = entry.settings};
+        if(node.node) {
+            if(entry.settings.isValid()) {
+                node.node->setSettings(entry.settings);
+            }
+            nodes.push_back(std::move(node));
+        }
+    }
+
+    m_nodes = std::move(nodes);
+
+    // Prepares the new processors, and the rest only if the block size changed
+    prepare(m_format);
+}
+
+void DspChain::prepare(const AudioFormat& format)
+{
+    int blockFrames{DefaultBlockFrames};
+    for(const auto& node : m_nodes) {
+        if(const int maxFrames = node.node->maxBlockFrames(); maxFrames > 0) {
+            blockFrames = std::min(blockFrames, maxFrames);
+        }
+    }
+
+    // Preparing a processor clears its state (e.g. filter history), so only do so when needed
+    const bool changed = format != m_format || blockFrames != m_blockFrames;
+
+    m_format      = format;
+    m_floatFormat = format;
+    m_floatFormat.setSampleFormat(SampleFormat::F32);
+    m_blockFrames = blockFrames;
+
+    if(!m_format.isValid()) {
+        return;
+    }
+
+    for(auto& node : m_nodes) {
+        if(changed || !node.prepared) {
+            prepareNode(node);
+        }
+    }
+
+    if(m_format.sampleFormat() != SampleFormat::F32) {
+        m_scratch.resize(static_cast<size_t>(m_blockFrames) * m_format.channelCount());
+    }
+    else {
+        m_scratch = {};
+    }
+
+    qCDebug(ENGINE) << "DSP chain prepared:" << activeCount() << "of" << m_nodes.size() << "active, block size"
+                    << m_blockFrames << "frames, latency" << latency() << "frames";
+}
+
+void DspChain::process(AudioBuffer& buffer)
+{
+    if(activeCount() == 0 || !buffer.isValid() || buffer.format() != m_format) {
+        return;
+    }
+
+    const int frameCount = buffer.frameCount();
+    const int frameBytes = m_format.bytesPerFrame();
+    std::byte* data      = buffer.data();
+
+    const bool isFloat = m_format.sampleFormat() == SampleFormat::F32;
+
+    for(int frame{0}; frame < frameCount; frame += m_blockFrames) {
+        const int count     = std::min(m_blockFrames, frameCount - frame);
+        std::byte* blockPos = data + (static_cast<size_t>(frame) * frameBytes);
+
+        if(isFloat) {
+            processBlock(reinterpret_cast<float*>(blockPos), count);
+            continue;
+        }
+
+        auto* scratch = reinterpret_cast<std::byte*>(m_scratch.data());
+        Audio::convert(m_format, blockPos, m_floatFormat, scratch, count);
+        processBlock(m_scratch.data(), count);
+        clampBlock(count);
+        Audio::convert(m_floatFormat, scratch, m_format, blockPos, count);
+    }
+}
+
+void DspChain::reset()
+{
+    for(auto& node : m_nodes) {
+        if(node.active) {
+            node.node->reset();
+        }
+    }
+}
+
+bool DspChain::isEmpty() const
+{
+    return m_nodes.empty();
+}
+
+int DspChain::activeCount() const
+{
+    return static_cast<int>(std::ranges::count_if(m_nodes, [](const Node& node) { return node.active; }));
+}
+
+int DspChain::blockFrames() const
+{
+    return m_blockFrames;
+}
+
+int DspChain::latency() const
+{
+    return std::accumulate(m_nodes.cbegin(), m_nodes.cend(), 0, [](int total, const Node& node) {
+        return node.active ? total + node.node->latency() : total;
+    });
+}
+
+void DspChain::prepareNode(Node& node) const
+{
+    node.active   = node.node->prepare(m_floatFormat, m_blockFrames);
+    node.prepared = true;
+    if(!node.active) {
+        qCDebug(ENGINE) << "DSP" << node.name << "doesn't support format" << m_floatFormat.prettyFormat()
+                        << "and will be bypassed";
+    }
+}
+
+void DspChain::clampBlock(int frameCount)
+{
+    // Processors can push samples out of range, which would wrap when converted back to integers
+    constexpr float MaxSample = 1.0F - std::numeric_limits<float>::epsilon();
+
+    const auto sampleCount = static_cast<size_t>(frameCount) * m_format.channelCount();
+    for(size_t i{0}; i < sampleCount; ++i) {
+        m_scratch[i] = std::clamp(m_scratch[i], -1.0F, MaxSample);
+    }
+}
+
+void DspChain::processBlock(float* data, int frameCount)
+{
+    for(auto& node : m_nodes) {
+        if(node.active) {
+            node.node->process(data, frameCount);
+        }
+    }
+}
+} // namespace Fooyin
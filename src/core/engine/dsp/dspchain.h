@@ -0,0 +1,88 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/engine/audioformat.h>
+#include <core/engine/dspnode.h>
+
+#include <vector>
+
+namespace Fooyin {
+class AudioBuffer;
+
+/*!
+ * Runs audio through an ordered list of DspNodes.
+ *
+ * Audio is processed in place in blocks of the size negotiated in @fn prepare. Buffers which aren't F32
+ * are converted a block at a time through a scratch buffer, so processing never allocates.
+ * The chain can be changed with @fn update between calls to @fn process, which keeps the state of
+ * processors that remain in the chain.
+ */
+class FYCORE_EXPORT DspChain
+{
+public:
+    static constexpr int DefaultBlockFrames = 512;
+
+    DspChain();
+
+    /*!
+     * Replaces the chain with @p entries in order, reusing existing processors of the same name.
+     * Processors whose settings differ from their entry are passed the new settings.
+     */
+    void update(const DspEntries& entries);
+    /*!
+     * Prepares processors for audio of @p format. Processors which were already prepared are only prepared
+     * again if the format or block size changed, so they keep their state otherwise.
+     */
+    void prepare(const AudioFormat& format);
+    /** Processes the whole of @p buffer in place. @p buffer must be in the format passed to @fn prepare. */
+    void process(AudioBuffer& buffer);
+    void reset();
+
+    [[nodiscard]] bool isEmpty() const;
+    /** Returns the number of processors which accepted the current format. */
+    [[nodiscard]] int activeCount() const;
+    [[nodiscard]] int blockFrames() const;
+    /** Returns the total latency of all active processors in frames. */
+    [[nodiscard]] int latency() const;
+
+private:
+    struct Node
+    {
+        QString name;
+        std::unique_ptr<DspNode> node;
+        QVariant settings;
+        bool active{false};
+        bool prepared{false};
+    };
+
+    void prepareNode(Node& node) const;
+    void clampBlock(int frameCount);
+    void processBlock(float* data, int frameCount);
+
+    std::vector<Node> m_nodes;
+    AudioFormat m_format;
+    AudioFormat m_floatFormat;
+    int m_blockFrames;
+    std::vector<float> m_scratch;
+};
+} // namespace Fooyin
@@ -0,0 +1,144 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "equaliser.h"
+
+#include <QObject>
+#include <QVariant>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+// Bandwidth of roughly one octave
+constexpr double BandQ = 1.41;
+
+namespace Fooyin {
+Equaliser::Equaliser(const Gains& gains)
+    : m_gains{gains}
+    , m_sampleRate{0.0}
+    , m_activeBands{}
+    , m_activeCount{0}
+    , m_channels{0}
+{ }
+
+QString Equaliser::name() const
+{
+    return QObject::tr("Equaliser");
+}
+
+void Equaliser::setSettings(const QVariant& settings)
+{
+    const QVariantList gains = settings.toList();
+
+    for(size_t i{0}; i < BandCount; ++i) {
+        const auto index = static_cast<qsizetype>(i);
+        m_gains.at(i)    = index < gains.size() ? std::clamp(gains.at(index).toDouble(), -MaxGain, MaxGain) : 0.0;
+    }
+
+    // Keep the filter state so a change while playing doesn't click
+    if(m_sampleRate > 0.0) {
+        updateBands();
+    }
+}
+
+bool Equaliser::prepare(const AudioFormat& format, int /*blockFrames*/)
+{
+    if(format.channelCount() <= 0 || format.channelCount() > MaxChannels) {
+        return false;
+    }
+
+    m_channels   = format.channelCount();
+    m_sampleRate = static_cast<double>(format.sampleRate());
+
+    reset();
+    updateBands();
+
+    return true;
+}
+
+void Equaliser::updateBands()
+{
+    m_activeCount = 0;
+
+    for(size_t i{0}; i < BandCount; ++i) {
+        auto& band = m_bands.at(i);
+
+        // Bands at or above Nyquist can't be represented
+        if(m_gains.at(i) == 0.0 || Frequencies.at(i) >= m_sampleRate / 2.0) {
+            // Start from silence if the band is enabled again
+            band.z1.fill(0.0);
+            band.z2.fill(0.0);
+            continue;
+        }
+
+        // Peaking EQ from the Audio EQ Cookbook
+        const double a     = std::pow(10.0, m_gains.at(i) / 40.0);
+        const double w0    = 2.0 * std::numbers::pi * Frequencies.at(i) / m_sampleRate;
+        const double alpha = std::sin(w0) / (2.0 * BandQ);
+        const double cosW0 = std::cos(w0);
+        const double a0    = 1.0 + (alpha / a);
+
+        band.b0 = (1.0 + (alpha * a)) / a0;
+        band.b1 = (-2.0 * cosW0) / a0;
+        band.b2 = (1.0 - (alpha * a)) / a0;
+        band.a1 = (-2.0 * cosW0) / a0;
+        band.a2 = (1.0 - (alpha / a)) / a0;
+
+        m_activeBands.at(m_activeCount++) = i;
+    }
+}
+
+void Equaliser::process(float* data, int frameCount)
+{
+    const auto channels = static_cast<size_t>(m_channels);
+    const auto frames   = static_cast<size_t>(frameCount);
+
+    for(size_t activeBand{0}; activeBand < m_activeCount; ++activeBand) {
+        auto& band = m_bands.at(m_activeBands.at(activeBand));
+
+        for(size_t channel{0}; channel < channels; ++channel) {
+            double z1 = band.z1.at(channel);
+            double z2 = band.z2.at(channel);
+
+            for(size_t frame{0}; frame < frames; ++frame) {
+                float& sample    = data[(frame * channels) + channel];
+                const double in  = sample;
+                const double out = (band.b0 * in) + z1;
+
+                z1 = (band.b1 * in) - (band.a1 * out) + z2;
+                z2 = (band.b2 * in) - (band.a2 * out);
+
+                sample = static_cast<float>(out);
+            }
+
+            band.z1.at(channel) = z1;
+            band.z2.at(channel) = z2;
+        }
+    }
+}
+
+void Equaliser::reset()
+{
+    for(auto& band : m_bands) {
+        band.z1.fill(0.0);
+        band.z2.fill(0.0);
+    }
+}
+} // namespace Fooyin
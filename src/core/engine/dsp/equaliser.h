@@ -0,0 +1,78 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/engine/dspnode.h>
+
+#include <array>
+
+namespace Fooyin {
+/*!
+ * A graphic equaliser made up of a bank of peaking biquad filters, one per band.
+ * Bands with no gain are skipped entirely. Gains can be changed with @fn setSettings using a list of
+ * values in dB, as stored in Settings::Core::EqualiserGains.
+ */
+class FYCORE_EXPORT Equaliser : public DspNode
+{
+public:
+    static constexpr size_t BandCount = 10;
+    static constexpr std::array<double, BandCount> Frequencies{31.0,   62.0,   125.0,  250.0,  500.0,
+                                                               1000.0, 2000.0, 4000.0, 8000.0, 16000.0};
+    using Gains = std::array<double, BandCount>;
+
+    static constexpr double MaxGain = 12.0;
+
+    /** Gains are in dB for each of the bands in @c Frequencies. */
+    explicit Equaliser(const Gains& gains = {});
+
+    [[nodiscard]] QString name() const override;
+
+    void setSettings(const QVariant& settings) override;
+    bool prepare(const AudioFormat& format, int blockFrames) override;
+    void process(float* data, int frameCount) override;
+    void reset() override;
+
+private:
+    static constexpr int MaxChannels = 8;
+
+    struct Band
+    {
+        double b0{1.0};
+        double b1{0.0};
+        double b2{0.0};
+        double a1{0.0};
+        double a2{0.0};
+        // Transposed direct form II state per channel
+        std::array<double, MaxChannels> z1{};
+        std::array<double, MaxChannels> z2{};
+    };
+
+    void updateBands();
+
+    Gains m_gains;
+    double m_sampleRate;
+    std::array<Band, BandCount> m_bands;
+    std::array<size_t, BandCount> m_activeBands;
+    size_t m_activeCount;
+    int m_channels;
+};
+} // namespace Fooyin
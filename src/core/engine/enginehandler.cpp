@@ -20,6 +20,8 @@
 #include "enginehandler.h"
 
 #include "audioplaybackengine.h"
+#include "dsp/crossfeed.h"
+#include "dsp/equaliser.h"
 
 #include <core/coresettings.h>
 #include <core/engine/audioengine.h>
@@ -33,6 +35,8 @@
 
 Q_LOGGING_CATEGORY(ENG_HANDLER, "fy.engine")
 
+constexpr auto EqualiserName = "Equaliser";
+
 namespace Fooyin {
 class EngineHandlerPrivate
 {
@@ -47,6 +51,8 @@ public:
 
     void changeOutput(const QString& output);
     void updateVolume(double volume);
+    void updateDspChain(const QStringList& names);
+    [[nodiscard]] QVariant dspSettings(const QString& name) const;
 
     EngineHandler* m_self;
     PlayerController* m_playerController;
@@ -56,6 +62,7 @@ public:
     AudioEngine* m_engine;
 
     std::map<QString, OutputCreator> m_outputs;
+    std::map<QString, DspCreator> m_dsps;
 
     struct CurrentOutput
     {
@@ -202,6 +209,29 @@ void EngineHandlerPrivate::updateVolume(double volume)
     QMetaObject::invokeMethod(m_engine, [this, volume]() { m_engine->setVolume(volume); }, Qt::QueuedConnection);
 }
 
+void EngineHandlerPrivate::updateDspChain(const QStringList& names)
+{
+    DspEntries chain;
+
+    for(const QString& name : names) {
+        if(!m_dsps.contains(name)) {
+            qCWarning(ENG_HANDLER) << "DSP hasn't been registered:" << name;
+            continue;
+        }
+        chain.push_back({name, m_dsps.at(name), dspSettings(name)});
+    }
+
+    QMetaObject::invokeMethod(m_engine, [this, chain]() { m_engine->setDspChain(chain); });
+}
+
+QVariant EngineHandlerPrivate::dspSettings(const QString& name) const
+{
+    if(name == QLatin1String{EqualiserName}) {
+        return m_settings->value<Settings::Core::EqualiserGains>();
+    }
+    return {};
+}
+
 EngineHandler::EngineHandler(std::shared_ptr<AudioLoader> decoderProvider, PlayerController* playerController,
                              SettingsManager* settings, QObject* parent)
     : EngineController{parent}
@@ -222,6 +252,13 @@ EngineHandler::EngineHandler(std::shared_ptr<AudioLoader> decoderProvider, Playe
     p->m_settings->subscribe<Settings::Core::AudioOutput>(this,
                                                           [this](const QString& output) { p->changeOutput(output); });
     p->m_settings->subscribe<Settings::Core::OutputVolume>(this, [this](double volume) { p->updateVolume(volume); });
+    p->m_settings->subscribe<Settings::Core::DspChain>(
+        this, [this](const QStringList& names) { p->updateDspChain(names); });
+    p->m_settings->subscribe<Settings::Core::EqualiserGains>(
+        this, [this]() { p->updateDspChain(p->m_settings->value<Settings::Core::DspChain>()); });
+
+    addDsp(QString::fromLatin1(EqualiserName), []() { return std::make_unique<Equaliser>(); });
+    addDsp(QStringLiteral("Crossfeed"), []() { return std::make_unique<Crossfeed>(); });
 }
 
 EngineHandler::~EngineHandler()
@@ -233,6 +270,7 @@ EngineHandler::~EngineHandler()
 void EngineHandler::setup()
 {
     p->changeOutput(p->m_settings->value<Settings::Core::AudioOutput>());
+    p->updateDspChain(p->m_settings->value<Settings::Core::DspChain>());
 }
 
 AudioEngine::PlaybackState EngineHandler::engineState() const
@@ -276,6 +314,31 @@ void EngineHandler::addOutput(const QString& name, OutputCreator output)
     }
     p->m_outputs.emplace(name, std::move(output));
 }
+
+DspNames EngineHandler::getAllDsps() const
+{
+    DspNames dsps;
+
+    for(const auto& [name, dsp] : p->m_dsps) {
+        dsps.emplace_back(name);
+    }
+
+    return dsps;
+}
+
+void EngineHandler::addDsp(const QString& name, DspCreator dsp)
+{
+    if(p->m_dsps.contains(name)) {
+        qCWarning(ENG_HANDLER) << "DSP" << name << "already registered";
+        return;
+    }
+    p->m_dsps.emplace(name, std::move(dsp));
+}
+
+void EngineHandler::prepareNextTrack(const Track& track)
+{
+    QMetaObject::invokeMethod(p->m_engine, [this, track]() { p->m_engine->prepareNextTrack(track); });
+}
 } // namespace Fooyin
 
 #include "moc_enginehandler.cpp"
@@ -48,6 +48,11 @@ public:
     [[nodiscard]] OutputDevices getOutputDevices(const QString& output) const override;
     void addOutput(const QString& name, OutputCreator output) override;
 
+    [[nodiscard]] DspNames getAllDsps() const override;
+    void addDsp(const QString& name, DspCreator dsp) override;
+
+    void prepareNextTrack(const Track& track) override;
+
 private:
     std::unique_ptr<EngineHandlerPrivate> p;
 };
@@ -25,11 +25,23 @@
 #include "ffmpegutils.h"
 
 #include <core/engine/audiobuffer.h>
+#include <core/engine/audioconverter.h>
 #include <utils/worker.h>
 
 #include <QDebug>
 #include <QFile>
 #include <QIODevice>
+#include <QPointer>
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #if defined(__GNUG__)
 #pragma GCC diagnostic ignored "-Wold-style-cast"
@@ -40,6 +52,11 @@
 constexpr AVRational TimeBaseAv = {1, AV_TIME_BASE};
 constexpr AVRational TimeBaseMs = {1, 1000};
 
+// Size of the buffer FFmpeg reads into from the source
+constexpr int IOBufferSize = 64 * 1024;
+// How far ahead of the read position to ask the kernel to page in a mapped file
+constexpr int64_t ReadAheadSize = 2 * 1024 * 1024;
+
 using namespace std::chrono_literals;
 
 namespace {
@@ -181,34 +198,16 @@ void parseTag(Fooyin::Track& track, AVDictionaryEntry* tag)
     }
 };
 
-void interleaveSamples(uint8_t** in, Fooyin::AudioBuffer& buffer)
-{
-    const auto format  = buffer.format();
-    const int channels = format.channelCount();
-    const int samples  = buffer.frameCount();
-    const int bps      = format.bytesPerSample();
-    auto* out          = buffer.data();
-
-    const int totalSamples = samples * channels;
-
-    for(int i{0}; i < totalSamples; ++i) {
-        const int sampleIndex  = i / channels;
-        const int channelIndex = i % channels;
-
-        const auto inOffset  = sampleIndex * bps;
-        const auto outOffset = i * bps;
-        std::memmove(out + outOffset, in[channelIndex] + inOffset, bps);
-    }
-}
-
 void interleave(uint8_t** in, Fooyin::AudioBuffer& buffer)
 {
     if(!buffer.isValid()) {
         return;
     }
 
-    if(buffer.format().sampleFormat() != Fooyin::SampleFormat::Unknown) {
-        interleaveSamples(in, buffer);
+    const auto format = buffer.format();
+    if(format.sampleFormat() != Fooyin::SampleFormat::Unknown) {
+        Fooyin::Audio::interleave(reinterpret_cast<const std::byte* const*>(in), format.channelCount(),
+                                  format.bytesPerSample(), buffer.frameCount(), buffer.data());
     }
 }
 
@@ -254,56 +253,238 @@ struct PacketDeleter
 };
 using PacketPtr = std::unique_ptr<AVPacket, PacketDeleter>;
 
-int ffRead(void* data, uint8_t* buffer, int size)
+// Reads from a file mapped into memory where possible, or from the device otherwise
+class IOSource
 {
-    auto* device        = static_cast<QIODevice*>(data);
-    const auto sizeRead = device->read(std::bit_cast<char*>(buffer), size);
-    if(sizeRead == 0) {
-        return AVERROR_EOF;
+public:
+    IOSource(QIODevice* device, bool sequential)
+        : m_device{device}
+        , m_sequential{sequential}
+    {
+        auto* file = qobject_cast<QFileDevice*>(device);
+        if(!file || file->isSequential() || file->size() <= 0) {
+            return;
+        }
+
+        // Leave the device's position untouched, as it won't be used for reads
+        m_map = file->map(0, file->size());
+        if(!m_map) {
+            adviseFile(file);
+            return;
+        }
+
+        m_file = file;
+        m_size = file->size();
+
+#ifdef Q_OS_UNIX
+        if(m_sequential) {
+            posix_madvise(m_map, static_cast<size_t>(m_size), POSIX_MADV_SEQUENTIAL);
+            readAhead();
+        }
+#endif
     }
-    return static_cast<int>(sizeRead);
-}
 
-int64_t ffSeek(void* data, int64_t offset, int whence)
-{
-    auto* device = static_cast<QIODevice*>(data);
-    int64_t seekPos{0};
-
-    switch(whence) {
-        case(AVSEEK_SIZE):
-            return device->size();
-        case(SEEK_SET):
-            seekPos = offset;
-            break;
-        case(SEEK_CUR):
-            seekPos = device->pos() + offset;
-            break;
-        case(SEEK_END):
-            seekPos = device->size() - offset;
-            break;
-        default:
+    ~IOSource()
+    {
+        if(m_map && m_file) {
+            m_file->unmap(m_map);
+        }
+    }
+
+    IOSource(const IOSource&)            = delete;
+    IOSource& operator=(const IOSource&) = delete;
+
+    [[nodiscard]] bool isMapped() const
+    {
+        return m_map != nullptr;
+    }
+
+    int read(uint8_t* buffer, int size)
+    {
+        if(m_map && m_pos + size > m_checkedEnd && !checkMappedSize(size)) {
+            // The file has shrunk underneath us, so touching the mapping past its new end would fault
+            unmapFile();
+        }
+
+        if(!m_map) {
+            const auto sizeRead = m_device->read(std::bit_cast<char*>(buffer), size);
+            if(sizeRead == 0) {
+                return AVERROR_EOF;
+            }
+            return static_cast<int>(sizeRead);
+        }
+
+        const auto count = static_cast<int>(std::min<int64_t>(size, m_size - m_pos));
+        if(count <= 0) {
+            return AVERROR_EOF;
+        }
+
+        std::memcpy(buffer, m_map + m_pos, static_cast<size_t>(count));
+        m_pos += count;
+
+        if(m_sequential && m_pos >= m_readAheadPos - (ReadAheadSize / 2)) {
+            readAhead();
+        }
+
+        return count;
+    }
+
+    int64_t seek(int64_t offset, int whence)
+    {
+        const int64_t size = m_map ? m_size : m_device->size();
+        const int64_t pos  = m_map ? m_pos : m_device->pos();
+        int64_t seekPos{0};
+
+        switch(whence) {
+            case(AVSEEK_SIZE):
+                return size;
+            case(SEEK_SET):
+                seekPos = offset;
+                break;
+            case(SEEK_CUR):
+                seekPos = pos + offset;
+                break;
+            case(SEEK_END):
+                seekPos = size - offset;
+                break;
+            default:
+                return -1;
+        }
+
+        if(seekPos < 0 || seekPos > size) {
             return -1;
+        }
+
+        if(!m_map) {
+            return m_device->seek(seekPos);
+        }
+
+        m_pos        = seekPos;
+        m_checkedEnd = 0;
+        if(m_sequential) {
+            m_readAheadPos = m_pos;
+            readAhead();
+        }
+        return m_pos;
     }
 
-    if(seekPos < 0 || seekPos > device->size()) {
-        return -1;
+private:
+    /*!
+     * Checks the file still covers the next @p size bytes of the mapping, and if so treats the following
+     * read-ahead window as safe to read without checking again.
+     * The file could still shrink within a window, but checking before every read would cost a syscall each time.
+     */
+    bool checkMappedSize(int size)
+    {
+        if(!m_file) {
+            return false;
+        }
+
+#ifdef Q_OS_UNIX
+        struct stat info{};
+        if(fstat(m_file->handle(), &info) != 0) {
+            return false;
+        }
+        const auto fileSize = static_cast<int64_t>(info.st_size);
+#else
+        const int64_t fileSize = m_file->size();
+#endif
+
+        if(fileSize < std::min<int64_t>(m_pos + size, m_size)) {
+            return false;
+        }
+
+        m_checkedEnd = std::min({m_size, fileSize, m_pos + std::max<int64_t>(size, ReadAheadSize)});
+        return true;
+    }
+
+    // Falls back to reading from the device at the current position
+    void unmapFile()
+    {
+        qCDebug(FFMPEG) << "File size changed during playback; reading from device instead";
+
+        if(m_file) {
+            m_file->unmap(m_map);
+        }
+        m_map = nullptr;
+        m_device->seek(m_pos);
+    }
+
+    void adviseFile([[maybe_unused]] QFileDevice* file) const
+    {
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
+        if(m_sequential && file->handle() >= 0) {
+            posix_fadvise(file->handle(), 0, 0, POSIX_FADV_SEQUENTIAL);
+        }
+#endif
     }
 
-    return device->seek(seekPos);
+    // Pages in the window following the current read position
+    void readAhead()
+    {
+#ifdef Q_OS_UNIX
+        const int64_t start = std::max(m_pos, m_readAheadPos);
+        const int64_t end   = std::min(m_pos + ReadAheadSize, m_size);
+        if(start < end) {
+            // madvise requires a page aligned address
+            static const auto pageSize = static_cast<int64_t>(sysconf(_SC_PAGESIZE));
+            const int64_t alignedStart = start - (start % pageSize);
+            posix_madvise(m_map + alignedStart, static_cast<size_t>(end - alignedStart), POSIX_MADV_WILLNEED);
+            m_readAheadPos = end;
+        }
+#endif
+    }
+
+    QIODevice* m_device;
+    QPointer<QFileDevice> m_file;
+    bool m_sequential;
+
+    uchar* m_map{nullptr};
+    int64_t m_size{0};
+    int64_t m_pos{0};
+    int64_t m_readAheadPos{0};
+    // End of the range last confirmed to be within the file
+    int64_t m_checkedEnd{0};
+};
+
+int ffRead(void* data, uint8_t* buffer, int size)
+{
+    return static_cast<IOSource*>(data)->read(buffer, size);
+}
+
+int64_t ffSeek(void* data, int64_t offset, int whence)
+{
+    return static_cast<IOSource*>(data)->seek(offset, whence);
 }
 
 struct FormatContext
 {
+    // Destroyed last, as it's used by both contexts
+    std::unique_ptr<IOSource> ioSource;
     FormatContextPtr formatContext;
     AVIOContextPtr ioContext;
 };
 
-FormatContext createAVFormatContext(QIODevice* source)
+/*!
+ * Opens @p source for demuxing. Local files are read from a memory mapping, avoiding a read call
+ * per packet. If @p sequential is set, the kernel is told the file will be read from start to end
+ * and asked to read ahead of the current position.
+ */
+FormatContext createAVFormatContext(QIODevice* source, bool sequential = false)
 {
     FormatContext fc;
 
-    fc.ioContext.reset(avio_alloc_context(nullptr, 0, 0, source, ffRead, nullptr, ffSeek));
+    fc.ioSource = std::make_unique<IOSource>(source, sequential);
+
+    auto* buffer = static_cast<uint8_t*>(av_malloc(IOBufferSize));
+    if(!buffer) {
+        qCWarning(FFMPEG) << "Failed to allocate AVIO buffer";
+        return {};
+    }
+
+    fc.ioContext.reset(avio_alloc_context(buffer, IOBufferSize, 0, fc.ioSource.get(), ffRead, nullptr, ffSeek));
     if(!fc.ioContext) {
+        av_free(buffer);
         qCWarning(FFMPEG) << "Failed to allocate AVIO context";
         return {};
     }
@@ -410,8 +591,11 @@ public:
     void readNext();
     void seek(uint64_t pos);
 
+    [[nodiscard]] bool hasBufferedData() const;
+
     FFmpegDecoder* m_self;
 
+    std::unique_ptr<IOSource> m_ioSource;
     AVIOContextPtr m_ioContext;
     FormatContextPtr m_context;
     Stream m_stream;
@@ -425,6 +609,7 @@ public:
     bool m_eof{false};
     bool m_isDecoding{false};
 
+    // Holds the current decoded frame, reused between frames so it's only reallocated when a frame is larger
     AudioBuffer m_buffer;
     int m_bufferPos{0};
     int64_t m_seekPos{0};
@@ -445,6 +630,7 @@ void FFmpegInputPrivate::reset()
 
     m_context.reset();
     m_ioContext.reset();
+    m_ioSource.reset();
     m_stream = {};
     m_codec  = {};
     m_buffer = {};
@@ -454,7 +640,8 @@ bool FFmpegInputPrivate::setup(QIODevice* source)
 {
     reset();
 
-    FormatContext context = createAVFormatContext(source);
+    FormatContext context = createAVFormatContext(source, true);
+    m_ioSource            = std::move(context.ioSource);
     m_context             = std::move(context.formatContext);
     m_ioContext           = std::move(context.ioContext);
 
@@ -585,30 +772,31 @@ int FFmpegInputPrivate::receiveAVFrames()
     const auto sampleCount   = m_audioFormat.bytesPerFrame() * frame.sampleCount();
     const uint64_t startTime = m_codec.context()->codec_id == AV_CODEC_ID_APE ? m_currentPos : frame.ptsMs();
 
-    if(m_codec.isPlanar()) {
+    if(m_buffer.isValid()) {
+        m_buffer.setStartTime(startTime);
+    }
+    else {
         m_buffer = {m_audioFormat, startTime};
-        m_buffer.resize(static_cast<size_t>(sampleCount));
-        interleave(frame.avFrame()->data, m_buffer);
+    }
+    m_buffer.resize(static_cast<size_t>(sampleCount));
+    m_bufferPos = 0;
+
+    if(m_codec.isPlanar()) {
+        // extended_data also holds the planes beyond AV_NUM_DATA_POINTERS channels
+        interleave(frame.avFrame()->extended_data, m_buffer);
     }
     else {
-        m_buffer = {frame.avFrame()->data[0], static_cast<size_t>(sampleCount), m_audioFormat, startTime};
+        std::memcpy(m_buffer.data(), frame.avFrame()->data[0], static_cast<size_t>(sampleCount));
     }
 
     // Handle seeking of APE files
     if(m_skipBytes > 0) {
         const auto len = std::min(sampleCount, m_skipBytes);
         m_skipBytes -= len;
-
-        if(sampleCount - len == 0) {
-            m_buffer.clear();
-        }
-        else {
-            std::memmove(m_buffer.data(), m_buffer.data() + len, sampleCount - len);
-            m_buffer.resize(sampleCount - len);
-        }
+        m_bufferPos = len;
     }
 
-    m_currentPos += m_audioFormat.durationForBytes(m_buffer.byteCount());
+    m_currentPos += m_audioFormat.durationForBytes(m_buffer.byteCount() - m_bufferPos);
 
     return result;
 }
@@ -654,6 +842,11 @@ void FFmpegInputPrivate::readNext()
     decodeAudio(packet);
 }
 
+bool FFmpegInputPrivate::hasBufferedData() const
+{
+    return m_bufferPos < m_buffer.byteCount();
+}
+
 void FFmpegInputPrivate::seek(uint64_t pos)
 {
     if(!m_context || !m_isSeekable || m_error) {
@@ -672,8 +865,8 @@ void FFmpegInputPrivate::seek(uint64_t pos)
     }
     avcodec_flush_buffers(m_codec.context());
 
+    m_buffer.clear();
     m_bufferPos  = 0;
-    m_buffer     = {};
     m_eof        = false;
     m_draining   = false;
     m_skipBytes  = 0;
@@ -727,7 +920,7 @@ AudioBuffer FFmpegDecoder::readBuffer(size_t bytes)
         return {};
     }
 
-    while(!p->m_buffer.isValid() && !p->m_eof && !p->m_error) {
+    while(!p->hasBufferedData() && !p->m_eof && !p->m_error) {
         p->readNext();
     }
 
@@ -736,16 +929,18 @@ AudioBuffer FFmpegDecoder::readBuffer(size_t bytes)
     const int bytesRequested = static_cast<int>(bytes);
     int bytesWritten{0};
 
-    while(p->m_buffer.isValid() && bytesWritten < bytesRequested) {
+    while(p->hasBufferedData() && bytesWritten < bytesRequested) {
         if(!buffer.isValid()) {
             buffer = {p->m_buffer.format(), p->m_buffer.startTime()};
+            buffer.reserve(bytes);
         }
         const int remaining = bytesRequested - bytesWritten;
         const int count     = p->m_buffer.byteCount() - p->m_bufferPos;
         if(count <= remaining) {
             buffer.append(p->m_buffer.data() + p->m_bufferPos, count);
             bytesWritten += count;
-            p->m_buffer    = {};
+            // Keep the allocation for the next frame
+            p->m_buffer.clear();
             p->m_bufferPos = 0;
             p->readNext();
         }
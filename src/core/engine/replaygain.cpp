@@ -0,0 +1,81 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "replaygain.h"
+
+#include <core/track.h>
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+namespace {
+// Parses values such as "-6.54 dB" or "0.988553"
+std::optional<double> readTag(const Fooyin::Track& track, const QString& tag)
+{
+    const QStringList values = track.extraTag(tag);
+    if(values.empty()) {
+        return {};
+    }
+
+    QString value = values.constFirst().trimmed();
+    if(value.endsWith(u"db", Qt::CaseInsensitive)) {
+        value.chop(2);
+    }
+
+    bool ok{false};
+    const double result = value.trimmed().toDouble(&ok);
+    if(!ok || !std::isfinite(result)) {
+        return {};
+    }
+
+    return result;
+}
+} // namespace
+
+namespace Fooyin::ReplayGain {
+float trackGain(const Track& track, Mode mode, double preamp, bool preventClipping)
+{
+    if(mode == Mode::Off) {
+        return 1.0F;
+    }
+
+    const auto trackGainDb = readTag(track, QStringLiteral("REPLAYGAIN_TRACK_GAIN"));
+    const auto trackPeak   = readTag(track, QStringLiteral("REPLAYGAIN_TRACK_PEAK"));
+    const auto albumGainDb = readTag(track, QStringLiteral("REPLAYGAIN_ALBUM_GAIN"));
+    const auto albumPeak   = readTag(track, QStringLiteral("REPLAYGAIN_ALBUM_PEAK"));
+
+    const bool useAlbum = (mode == Mode::Album && albumGainDb) || !trackGainDb;
+
+    const auto gainDb = useAlbum ? albumGainDb : trackGainDb;
+    const auto peak   = useAlbum ? albumPeak : trackPeak;
+
+    if(!gainDb) {
+        return 1.0F;
+    }
+
+    double gain = std::pow(10.0, (gainDb.value() + preamp) / 20.0);
+
+    if(preventClipping && peak && peak.value() > 0.0) {
+        gain = std::min(gain, 1.0 / peak.value());
+    }
+
+    return static_cast<float>(gain);
+}
+} // namespace Fooyin::ReplayGain
@@ -0,0 +1,46 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <cstdint>
+
+namespace Fooyin {
+class Track;
+
+namespace ReplayGain {
+// Stored in Settings::Core::ReplayGainMode
+enum class Mode : uint8_t
+{
+    Off = 0,
+    Track,
+    Album,
+};
+
+/*!
+ * Returns the linear gain to apply to @p track using its REPLAYGAIN_* tags.
+ * Falls back to the track values in album mode (and vice versa) if only one set is tagged.
+ * @p preamp is in dB and is only applied to tagged tracks. If @p preventClipping is set,
+ * the gain is limited so the tagged peak doesn't exceed full scale.
+ */
+FYCORE_EXPORT float trackGain(const Track& track, Mode mode, double preamp, bool preventClipping);
+} // namespace ReplayGain
+} // namespace Fooyin
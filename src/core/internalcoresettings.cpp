@@ -61,6 +61,11 @@ CoreSettings::CoreSettings(SettingsManager* settingsManager)
     m_settings->createSetting<PlayedThreshold>(0.5, QStringLiteral("Playback/PlayedThreshold"));
     m_settings->createSetting<ExternalSortScript>(QStringLiteral("%filepath%"),
                                                   QStringLiteral("Library/ExternalSortScript"));
+    m_settings->createSetting<ReplayGainMode>(0, QStringLiteral("Engine/ReplayGainMode"));
+    m_settings->createSetting<ReplayGainPreAmp>(0.0, QStringLiteral("Engine/ReplayGainPreAmp"));
+    m_settings->createSetting<ReplayGainNoClipping>(true, QStringLiteral("Engine/ReplayGainPreventClipping"));
+    m_settings->createSetting<DspChain>(QStringList{}, QStringLiteral("Engine/DspChain"));
+    m_settings->createSetting<EqualiserGains>(QVariantList{}, QStringLiteral("Engine/EqualiserGains"));
     m_settings->createTempSetting<Shutdown>(false);
     m_settings->createTempSetting<StopAfterCurrent>(false);
 
@@ -74,6 +74,7 @@ constexpr auto LibraryRestrictTypes    = "Library/RestrictTypes";
 constexpr auto LibraryExcludeTypes     = "Library/ExcludeTypes";
 constexpr auto ExternalRestrictTypes   = "Library/ExternalRestrictTypes";
 constexpr auto ExternalExcludeTypes    = "Library/ExternalExcludeTypes";
+constexpr auto LibraryScanThreads      = "Library/ScanThreads";
 
 enum CoreInternalSettings : uint32_t
 {
@@ -23,6 +23,7 @@
 #include "internalcoresettings.h"
 #include "librarywatcher.h"
 #include "playlist/playlistloader.h"
+#include "scanreaderpool.h"
 
 #include <core/coresettings.h>
 #include <core/library/libraryinfo.h>
@@ -41,6 +42,8 @@
 #include <QFileSystemWatcher>
 #include <QLoggingCategory>
 
+#include <algorithm>
+#include <chrono>
 #include <ranges>
 
 Q_LOGGING_CATEGORY(LIB_SCANNER, "fy.scanner")
@@ -156,6 +159,10 @@ public:
     void reportProgress() const;
     void fileScanned(const QString& file);
 
+    void storeTracks(TrackList& tracks, TrackDatabase::WriteMode mode = TrackDatabase::WriteMode::Insert);
+    void updateTracks(TrackList& tracks);
+    [[nodiscard]] int rowsPerSecond() const;
+
     Track matchMissingTrack(const Track& track);
 
     void checkBatchFinished();
@@ -175,9 +182,10 @@ public:
     void setTrackProps(Track& track, const QString& file);
 
     void updateExistingTrack(Track& track, const QString& file);
-    void readNewTrack(const QString& file);
+    void addNewTracks(const QString& file, TrackList& tracks);
 
-    void readFile(const QString& file, bool onlyModified);
+    [[nodiscard]] ScanReadResult readFile(const QString& file, bool onlyModified) const;
+    void processReadResult(ScanReadResult& result);
     void populateExistingTracks(const TrackList& tracks, bool includeMissing = true);
     bool getAndSaveAllTracks(const QString& path, const TrackList& tracks, bool onlyModified);
 
@@ -210,6 +218,10 @@ public:
     std::set<QString> m_filesScanned;
     size_t m_totalFiles{0};
 
+    // Database write throughput for the current scan
+    size_t m_rowsWritten{0};
+    std::chrono::microseconds m_writeTime{0};
+
     std::unordered_map<int, LibraryWatcher> m_watchers;
 };
 
@@ -219,6 +231,9 @@ void LibraryScannerPrivate::finishScan()
         m_self->setState(LibraryScanner::Idle);
         m_totalFiles = m_filesScanned.size();
         reportProgress();
+        if(m_rowsWritten > 0) {
+            qCDebug(LIB_SCANNER) << "Wrote" << m_rowsWritten << "tracks at" << rowsPerSecond() << "tracks/s";
+        }
         cleanupScan();
         emit m_self->finished();
     }
@@ -228,7 +243,9 @@ void LibraryScannerPrivate::cleanupScan()
 {
     m_audioLoader->destroyThreadInstance();
     m_filesScanned.clear();
-    m_totalFiles = 0;
+    m_totalFiles  = 0;
+    m_rowsWritten = 0;
+    m_writeTime   = {};
     m_tracksToStore.clear();
     m_tracksToUpdate.clear();
     m_trackPaths.clear();
@@ -259,7 +276,8 @@ void LibraryScannerPrivate::addWatcher(const LibraryInfo& library)
 
 void LibraryScannerPrivate::reportProgress() const
 {
-    emit m_self->progressChanged(static_cast<int>(m_filesScanned.size()), static_cast<int>(m_totalFiles));
+    emit m_self->progressChanged(static_cast<int>(m_filesScanned.size()), static_cast<int>(m_totalFiles),
+                                 rowsPerSecond());
 }
 
 void LibraryScannerPrivate::fileScanned(const QString& file)
@@ -268,6 +286,50 @@ void LibraryScannerPrivate::fileScanned(const QString& file)
     reportProgress();
 }
 
+void LibraryScannerPrivate::storeTracks(TrackList& tracks, TrackDatabase::WriteMode mode)
+{
+    // Tracks which already have an id aren't written, and those skipped as existing are left without one
+    std::vector<size_t> newTracks;
+    for(size_t i{0}; i < tracks.size(); ++i) {
+        if(tracks.at(i).id() < 0) {
+            newTracks.push_back(i);
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    const bool stored = m_trackDatabase.storeTracks(tracks, mode);
+
+    m_writeTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    if(stored) {
+        m_rowsWritten += static_cast<size_t>(
+            std::ranges::count_if(newTracks, [&tracks](size_t i) { return tracks.at(i).id() >= 0; }));
+    }
+}
+
+void LibraryScannerPrivate::updateTracks(TrackList& tracks)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    const bool updated = m_trackDatabase.updateTracks(tracks);
+
+    m_writeTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    if(updated) {
+        m_rowsWritten
+            += static_cast<size_t>(std::ranges::count_if(tracks, [](const Track& track) { return track.id() >= 0; }));
+    }
+}
+
+int LibraryScannerPrivate::rowsPerSecond() const
+{
+    if(m_writeTime.count() <= 0) {
+        return 0;
+    }
+    return static_cast<int>(static_cast<double>(m_rowsWritten) * 1'000'000 / static_cast<double>(m_writeTime.count()));
+}
+
 Track LibraryScannerPrivate::matchMissingTrack(const Track& track)
 {
     const QString filename = track.filename();
@@ -286,17 +348,17 @@ Track LibraryScannerPrivate::matchMissingTrack(const Track& track)
 
 void LibraryScannerPrivate::checkBatchFinished()
 {
-    if(m_tracksToStore.size() >= BatchSize || m_tracksToUpdate.size() > BatchSize) {
-        if(m_tracksToStore.size() >= BatchSize) {
-            m_trackDatabase.storeTracks(m_tracksToStore);
-        }
-        if(m_tracksToUpdate.size() >= BatchSize) {
-            m_trackDatabase.updateTracks(m_tracksToUpdate);
-        }
-        emit m_self->scanUpdate({.addedTracks = m_tracksToStore, .updatedTracks = {}});
-        m_tracksToStore.clear();
-        m_tracksToUpdate.clear();
+    if(m_tracksToStore.size() < BatchSize && m_tracksToUpdate.size() < BatchSize) {
+        return;
     }
+
+    storeTracks(m_tracksToStore, TrackDatabase::WriteMode::Upsert);
+    updateTracks(m_tracksToUpdate);
+
+    emit m_self->scanUpdate({.addedTracks = m_tracksToStore, .updatedTracks = m_tracksToUpdate});
+
+    m_tracksToStore.clear();
+    m_tracksToUpdate.clear();
 }
 
 void LibraryScannerPrivate::readFileProperties(Track& track)
@@ -611,13 +673,8 @@ void LibraryScannerPrivate::updateExistingTrack(Track& track, const QString& fil
     }
 }
 
-void LibraryScannerPrivate::readNewTrack(const QString& file)
+void LibraryScannerPrivate::addNewTracks(const QString& file, TrackList& tracks)
 {
-    TrackList tracks = readTracks(file);
-    if(tracks.empty()) {
-        return;
-    }
-
     for(Track& track : tracks) {
         Track refoundTrack = matchMissingTrack(track);
         if(refoundTrack.isInLibrary() || refoundTrack.isInDatabase()) {
@@ -645,14 +702,18 @@ void LibraryScannerPrivate::readNewTrack(const QString& file)
     }
 }
 
-void LibraryScannerPrivate::readFile(const QString& file, bool onlyModified)
+ScanReadResult LibraryScannerPrivate::readFile(const QString& file, bool onlyModified) const
 {
+    // Called concurrently from the reader pool, so must only read from the existing track maps
+    ScanReadResult result;
+    result.filepath = file;
+
     if(!m_self->mayRun()) {
-        return;
+        return result;
     }
 
     if(m_cueFilesScanned.contains(file)) {
-        return;
+        return result;
     }
 
     const QFileInfo info{file};
@@ -663,36 +724,60 @@ void LibraryScannerPrivate::readFile(const QString& file, bool onlyModified)
         lastModified = static_cast<uint64_t>(lastModifiedTime.toMSecsSinceEpoch());
     }
 
+    const auto requiresUpdate = [this, lastModified, onlyModified](const Track& libraryTrack) {
+        return !libraryTrack.isEnabled() || libraryTrack.libraryId() != m_currentLibrary.id
+            || libraryTrack.modifiedTime() < lastModified || !onlyModified;
+    };
+
     if(m_trackPaths.contains(file)) {
         const Track& libraryTrack = m_trackPaths.at(file).front();
 
-        if(!libraryTrack.isEnabled() || libraryTrack.libraryId() != m_currentLibrary.id
-           || libraryTrack.modifiedTime() < lastModified || !onlyModified) {
+        if(requiresUpdate(libraryTrack)) {
             Track changedTrack{libraryTrack};
             if(!m_audioLoader->readTrackMetadata(changedTrack)) {
-                return;
+                return result;
             }
 
             if(lastModifiedTime.isValid()) {
                 changedTrack.setModifiedTime(lastModified);
             }
 
-            updateExistingTrack(changedTrack, file);
+            result.type = ScanReadResult::Type::Existing;
+            result.tracks.push_back(changedTrack);
         }
     }
     else if(m_existingArchives.contains(file)) {
         const Track& libraryTrack = m_existingArchives.at(file).front();
 
-        if(!libraryTrack.isEnabled() || libraryTrack.libraryId() != m_currentLibrary.id
-           || libraryTrack.modifiedTime() < lastModified || !onlyModified) {
-            TrackList tracks = readArchiveTracks(file);
-            for(Track& track : tracks) {
-                updateExistingTrack(track, track.filepath());
-            }
+        if(requiresUpdate(libraryTrack)) {
+            result.type   = ScanReadResult::Type::Archive;
+            result.tracks = readArchiveTracks(file);
         }
     }
     else {
-        readNewTrack(file);
+        result.type   = ScanReadResult::Type::New;
+        result.tracks = readTracks(file);
+    }
+
+    return result;
+}
+
+void LibraryScannerPrivate::processReadResult(ScanReadResult& result)
+{
+    switch(result.type) {
+        case(ScanReadResult::Type::Existing):
+            updateExistingTrack(result.tracks.front(), result.filepath);
+            break;
+        case(ScanReadResult::Type::Archive):
+            for(Track& track : result.tracks) {
+                updateExistingTrack(track, track.filepath());
+            }
+            break;
+        case(ScanReadResult::Type::New):
+            addNewTracks(result.filepath, result.tracks);
+            break;
+        case(ScanReadResult::Type::Skipped):
+            break;
     }
 }
 
@@ -749,6 +834,9 @@ bool LibraryScannerPrivate::getAndSaveAllTracks(const QString& path, const Track
     m_totalFiles = files.size();
     reportProgress();
 
+    QStringList trackFiles;
+
+    // Cue sheets are sorted first and are read here, as they determine which files can be skipped
     for(const auto& file : files) {
         if(!m_self->mayRun()) {
             return false;
@@ -758,15 +846,35 @@ bool LibraryScannerPrivate::getAndSaveAllTracks(const QString& path, const Track
 
         if(file.suffix() == u"cue") {
             readCue(filepath, onlyModified);
+            fileScanned(filepath);
+            checkBatchFinished();
         }
         else {
-            readFile(filepath, onlyModified);
+            trackFiles.append(filepath);
         }
+    }
 
-        fileScanned(filepath);
+    // Tags are read on the pool's threads, results are then processed and saved in order on this thread
+    ScanReaderPool readerPool{
+        m_settings.value(QLatin1String{LibraryScanThreads}, 0).toInt(),
+        [this, onlyModified](const QString& filepath) { return readFile(filepath, onlyModified); },
+        [this]() { m_audioLoader->destroyThreadInstance(); }};
+    readerPool.start(trackFiles);
+
+    while(auto result = readerPool.next()) {
+        if(!m_self->mayRun()) {
+            return false;
+        }
+
+        processReadResult(result.value());
+        fileScanned(result->filepath);
         checkBatchFinished();
     }
 
+    if(!m_self->mayRun()) {
+        return false;
+    }
+
     for(auto& track : m_missingFiles | std::views::values) {
         if(track.isInLibrary() || track.isEnabled()) {
             track.setLibraryId(-1);
@@ -775,8 +883,8 @@ bool LibraryScannerPrivate::getAndSaveAllTracks(const QString& path, const Track
         }
     }
 
-    m_trackDatabase.storeTracks(m_tracksToStore);
-    m_trackDatabase.updateTracks(m_tracksToUpdate);
+    storeTracks(m_tracksToStore, TrackDatabase::WriteMode::Upsert);
+    updateTracks(m_tracksToUpdate);
 
     if(!m_tracksToStore.empty() || !m_tracksToUpdate.empty()) {
         emit m_self->scanUpdate({m_tracksToStore, m_tracksToUpdate});
@@ -813,7 +921,10 @@ void LibraryScanner::stopThread()
     if(state() == Running) {
         QMetaObject::invokeMethod(
             this,
-            [this]() { emit progressChanged(static_cast<int>(p->m_totalFiles), static_cast<int>(p->m_totalFiles)); },
+            [this]() {
+                emit progressChanged(static_cast<int>(p->m_totalFiles), static_cast<int>(p->m_totalFiles),
+                                     p->rowsPerSecond());
+            },
             Qt::QueuedConnection);
     }
 
@@ -947,7 +1058,7 @@ void LibraryScanner::scanTracks(const TrackList& /*libraryTracks*/, const TrackL
     }
 
     if(!tracksToUpdate.empty()) {
-        p->m_trackDatabase.updateTracks(tracksToUpdate);
+        p->updateTracks(tracksToUpdate);
         p->m_trackDatabase.updateTrackStats(tracksToUpdate);
 
         emit scanUpdate({{}, tracksToUpdate});
@@ -1043,12 +1154,12 @@ void LibraryScanner::scanFiles(const TrackList& libraryTracks, const QList<QUrl>
     }
 
     if(!playlistTracksScanned.empty()) {
-        p->m_trackDatabase.storeTracks(playlistTracksScanned);
+        p->storeTracks(playlistTracksScanned);
         emit playlistLoaded(playlistTracksScanned);
     }
 
     if(!tracksScanned.empty()) {
-        p->m_trackDatabase.storeTracks(tracksScanned);
+        p->storeTracks(tracksScanned);
         emit scannedTracks(tracksScanned);
     }
 
@@ -1082,7 +1193,7 @@ void LibraryScanner::scanPlaylist(const TrackList& libraryTracks, const QList<QU
     }
 
     if(!tracksScanned.empty()) {
-        p->m_trackDatabase.storeTracks(tracksScanned);
+        p->storeTracks(tracksScanned);
         emit playlistLoaded(tracksScanned);
     }
 
@@ -0,0 +1,330 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "librarysnapshot.h"
+
+#include <utils/paths.h>
+
+#include <QDataStream>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QSaveFile>
+
+#include <tuple>
+#include <unordered_map>
+
+Q_LOGGING_CATEGORY(LIB_SNAPSHOT, "fy.snapshot")
+
+constexpr quint32 SnapshotMagic = 0x46594C53; // FYLS
+// Increment when the layout of a track changes
+constexpr quint32 SnapshotVersion = 1;
+
+namespace {
+auto storedFields(const Fooyin::Track& track)
+{
+    return std::make_tuple(
+        track.id(), track.libraryId(), track.isEnabled(), track.filepath(), track.subsong(), track.title(),
+        track.artists(), track.albumArtists(), track.album(), track.trackNumber(), track.trackTotal(),
+        track.discNumber(), track.discTotal(), track.date(), track.composer(), track.performer(), track.genres(),
+        track.comment(), track.cuePath(), track.offset(), track.duration(), track.fileSize(), track.bitrate(),
+        track.sampleRate(), track.channels(), track.bitDepth(), track.codec(), track.extraTags(),
+        track.extraProperties(), track.modifiedTime(), track.addedTime(), track.firstPlayed(), track.lastPlayed(),
+        track.playCount(), track.rating(), track.hash());
+}
+
+void writeState(QDataStream& stream, const Fooyin::TrackDatabase::State& state)
+{
+    stream << static_cast<qint64>(state.trackCount) << static_cast<qint64>(state.maxTrackId) << state.modifiedTotal
+           << state.libraryTotal << state.statsTotal;
+}
+
+Fooyin::TrackDatabase::State readState(QDataStream& stream)
+{
+    qint64 trackCount{0};
+    qint64 maxTrackId{0};
+    Fooyin::TrackDatabase::State state;
+
+    stream >> trackCount >> maxTrackId >> state.modifiedTotal >> state.libraryTotal >> state.statsTotal;
+
+    state.trackCount = trackCount;
+    state.maxTrackId = maxTrackId;
+
+    return state;
+}
+
+void writeTrack(QDataStream& stream, const Fooyin::Track& track)
+{
+    stream << track.id() << track.libraryId() << track.filepath() << track.subsong() << track.title()
+           << track.artists() << track.albumArtists() << track.album() << track.trackNumber() << track.trackTotal()
+           << track.discNumber() << track.discTotal() << track.date() << track.composer() << track.performer()
+           << track.genres() << track.comment() << track.cuePath() << static_cast<quint64>(track.offset())
+           << static_cast<quint64>(track.duration()) << static_cast<quint64>(track.fileSize()) << track.bitrate()
+           << track.sampleRate() << track.channels() << track.bitDepth() << track.codec()
+           << track.serialiseExtraTags() << track.serialiseExtraProperties()
+           << static_cast<quint64>(track.modifiedTime()) << static_cast<quint64>(track.addedTime())
+           << static_cast<quint64>(track.firstPlayed()) << static_cast<quint64>(track.lastPlayed())
+           << track.playCount() << track.rating() << track.hash() << track.sort();
+}
+
+Fooyin::Track readTrack(QDataStream& stream)
+{
+    int id{-1};
+    int libraryId{-1};
+    QString filepath;
+    int subsong{0};
+    QString title;
+    QStringList artists;
+    QStringList albumArtists;
+    QString album;
+    QString trackNumber;
+    QString trackTotal;
+    QString discNumber;
+    QString discTotal;
+    QString date;
+    QString composer;
+    QString performer;
+    QStringList genres;
+    QString comment;
+    QString cuePath;
+    quint64 offset{0};
+    quint64 duration{0};
+    quint64 fileSize{0};
+    int bitrate{0};
+    int sampleRate{0};
+    int channels{0};
+    int bitDepth{0};
+    QString codec;
+    QByteArray extraTags;
+    QByteArray extraProperties;
+    quint64 modifiedTime{0};
+    quint64 addedTime{0};
+    quint64 firstPlayed{0};
+    quint64 lastPlayed{0};
+    int playCount{0};
+    float rating{0};
+    QString hash;
+    QString sort;
+
+    stream >> id >> libraryId >> filepath >> subsong >> title >> artists >> albumArtists >> album >> trackNumber
+        >> trackTotal >> discNumber >> discTotal >> date >> composer >> performer >> genres >> comment >> cuePath
+        >> offset >> duration >> fileSize >> bitrate >> sampleRate >> channels >> bitDepth >> codec >> extraTags
+        >> extraProperties >> modifiedTime >> addedTime >> firstPlayed >> lastPlayed >> playCount >> rating >> hash
+        >> sort;
+
+    Fooyin::Track track{filepath, subsong};
+
+    track.setId(id);
+    track.setLibraryId(libraryId);
+    track.setTitle(title);
+    track.setArtists(artists);
+    track.setAlbumArtists(albumArtists);
+    track.setAlbum(album);
+    track.setTrackNumber(trackNumber);
+    track.setTrackTotal(trackTotal);
+    track.setDiscNumber(discNumber);
+    track.setDiscTotal(discTotal);
+    track.setDate(date);
+    track.setComposer(composer);
+    track.setPerformer(performer);
+    track.setGenres(genres);
+    track.setComment(comment);
+    track.setCuePath(cuePath);
+    track.setOffset(offset);
+    track.setDuration(duration);
+    track.setFileSize(fileSize);
+    track.setBitrate(bitrate);
+    track.setSampleRate(sampleRate);
+    track.setChannels(channels);
+    track.setBitDepth(bitDepth);
+    track.setCodec(codec);
+    track.storeExtraTags(extraTags);
+    track.storeExtraProperties(extraProperties);
+    track.setModifiedTime(modifiedTime);
+    track.setAddedTime(addedTime);
+    track.setFirstPlayed(firstPlayed);
+    track.setLastPlayed(lastPlayed);
+    track.setPlayCount(playCount);
+    track.setRating(rating);
+    // Set last, as some setters regenerate the hash if one has already been set
+    track.setHash(hash);
+    track.setSort(sort);
+
+    return track;
+}
+} // namespace
+
+namespace Fooyin {
+LibrarySnapshot::LibrarySnapshot()
+    : LibrarySnapshot{Utils::cachePath() + QStringLiteral("/library.snapshot")}
+{ }
+
+LibrarySnapshot::LibrarySnapshot(QString filepath)
+    : m_filepath{std::move(filepath)}
+{ }
+
+QString LibrarySnapshot::filepath() const
+{
+    return m_filepath;
+}
+
+bool LibrarySnapshot::save(const TrackList& tracks, const QString& sortScript,
+                           const TrackDatabase& trackDatabase) const
+{
+    // A differing count means the library is still being updated, so the snapshot would be rejected on load anyway
+    const auto state = trackDatabase.state();
+    if(state && state->trackCount == static_cast<int64_t>(tracks.size())) {
+        if(write(tracks, sortScript, state.value())) {
+            return true;
+        }
+    }
+
+    remove();
+    return false;
+}
+
+bool LibrarySnapshot::write(const TrackList& tracks, const QString& sortScript,
+                            const TrackDatabase::State& state) const
+{
+    QSaveFile file{m_filepath};
+    if(!file.open(QIODevice::WriteOnly)) {
+        qCWarning(LIB_SNAPSHOT) << "Could not open" << m_filepath << "for writing:" << file.errorString();
+        return false;
+    }
+
+    QDataStream stream{&file};
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    stream << SnapshotMagic << SnapshotVersion << sortScript;
+    writeState(stream, state);
+    stream << static_cast<quint64>(tracks.size());
+
+    for(const Track& track : tracks) {
+        writeTrack(stream, track);
+    }
+
+    if(stream.status() != QDataStream::Ok || !file.commit()) {
+        qCWarning(LIB_SNAPSHOT) << "Failed to write library snapshot:" << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<TrackList> LibrarySnapshot::read(const QString& sortScript, const TrackDatabase::State& state) const
+{
+    QFile file{m_filepath};
+    if(!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    const qint64 size = file.size();
+    uchar* data       = file.map(0, size);
+    if(!data) {
+        qCDebug(LIB_SNAPSHOT) << "Could not map" << m_filepath << ":" << file.errorString();
+        return {};
+    }
+
+    // Read straight from the mapping rather than copying the file into memory first
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(data), size);
+    QDataStream stream{bytes};
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic{0};
+    quint32 version{0};
+    QString storedSort;
+
+    stream >> magic >> version;
+    if(magic != SnapshotMagic || version != SnapshotVersion) {
+        qCDebug(LIB_SNAPSHOT) << "Ignoring snapshot with unsupported version" << version;
+        return {};
+    }
+
+    stream >> storedSort;
+    const TrackDatabase::State storedState = readState(stream);
+
+    if(storedSort != sortScript || storedState != state) {
+        qCDebug(LIB_SNAPSHOT) << "Library snapshot is out of date";
+        return {};
+    }
+
+    quint64 count{0};
+    stream >> count;
+
+    if(stream.status() != QDataStream::Ok || static_cast<int64_t>(count) != state.trackCount) {
+        return {};
+    }
+
+    TrackList tracks;
+    tracks.reserve(count);
+
+    for(quint64 i{0}; i < count; ++i) {
+        tracks.push_back(readTrack(stream));
+    }
+
+    if(stream.status() != QDataStream::Ok) {
+        qCWarning(LIB_SNAPSHOT) << "Library snapshot is corrupt";
+        return {};
+    }
+
+    return tracks;
+}
+
+void LibrarySnapshot::remove() const
+{
+    QFile::remove(m_filepath);
+}
+
+bool LibrarySnapshot::tracksEqual(const Track& lhs, const Track& rhs)
+{
+    return storedFields(lhs) == storedFields(rhs);
+}
+
+LibrarySnapshot::Changes LibrarySnapshot::changes(const TrackList& snapshotTracks, const TrackList& dbTracks)
+{
+    Changes changes;
+
+    std::unordered_map<int, const Track*> snapshotIds;
+    snapshotIds.reserve(snapshotTracks.size());
+    for(const Track& track : snapshotTracks) {
+        snapshotIds.emplace(track.id(), &track);
+    }
+
+    for(const Track& track : dbTracks) {
+        const auto snapshotIt = snapshotIds.find(track.id());
+        if(snapshotIt == snapshotIds.cend()) {
+            changes.added.push_back(track);
+            continue;
+        }
+
+        if(!tracksEqual(*snapshotIt->second, track)) {
+            changes.updated.push_back(track);
+        }
+        snapshotIds.erase(snapshotIt);
+    }
+
+    // Preserve library order for removed tracks
+    for(const Track& track : snapshotTracks) {
+        if(snapshotIds.contains(track.id())) {
+            changes.removed.push_back(track);
+        }
+    }
+
+    return changes;
+}
+} // namespace Fooyin
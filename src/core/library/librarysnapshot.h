@@ -0,0 +1,68 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include "core/database/trackdatabase.h"
+
+#include <core/track.h>
+
+#include <optional>
+
+namespace Fooyin {
+/*!
+ * A binary copy of the sorted library track list, used to show the library at startup
+ * without waiting for the database to be read and the tracks sorted.
+ * A snapshot is only valid for the sort script and database state it was written with.
+ */
+class FYCORE_EXPORT LibrarySnapshot
+{
+public:
+    struct Changes
+    {
+        TrackList added;
+        TrackList updated;
+        TrackList removed;
+    };
+
+    LibrarySnapshot();
+    explicit LibrarySnapshot(QString filepath);
+
+    [[nodiscard]] QString filepath() const;
+
+    /** Writes @p tracks with the current state of @p trackDatabase, removing any existing snapshot on failure. */
+    bool save(const TrackList& tracks, const QString& sortScript, const TrackDatabase& trackDatabase) const;
+
+    /** Writes @p tracks, which must already be sorted using @p sortScript. */
+    bool write(const TrackList& tracks, const QString& sortScript, const TrackDatabase::State& state) const;
+    /** Returns the stored tracks if the snapshot exists and matches @p sortScript and @p state. */
+    [[nodiscard]] std::optional<TrackList> read(const QString& sortScript, const TrackDatabase::State& state) const;
+    void remove() const;
+
+    /** Returns true if every field stored in a snapshot is equal between @p lhs and @p rhs. */
+    static bool tracksEqual(const Track& lhs, const Track& rhs);
+    /** Returns the changes needed to bring @p snapshotTracks in line with @p dbTracks, matched by id. */
+    static Changes changes(const TrackList& snapshotTracks, const TrackList& dbTracks);
+
+private:
+    QString m_filepath;
+};
+} // namespace Fooyin
@@ -73,7 +73,7 @@ public:
     [[nodiscard]] std::optional<LibraryScanRequest> currentRequest() const;
     void execNextRequest();
 
-    void updateProgress(int current, int total);
+    void updateProgress(int current, int total, int rowsPerSecond);
     void finishScanRequest();
     void cancelScanRequest(int id);
 
@@ -323,12 +323,13 @@ void LibraryThreadHandlerPrivate::execNextRequest()
     }
 }
 
-void LibraryThreadHandlerPrivate::updateProgress(int current, int total)
+void LibraryThreadHandlerPrivate::updateProgress(int current, int total, int rowsPerSecond)
 {
     ScanProgress progress;
-    progress.id      = m_currentRequestId;
-    progress.total   = total;
-    progress.current = current;
+    progress.id            = m_currentRequestId;
+    progress.total         = total;
+    progress.current       = current;
+    progress.rowsPerSecond = rowsPerSecond;
 
     if(!m_scanRequests.empty()) {
         const auto& request = m_scanRequests.front();
@@ -375,6 +376,8 @@ LibraryThreadHandler::LibraryThreadHandler(DbConnectionPoolPtr dbPool, MusicLibr
     , p{std::make_unique<LibraryThreadHandlerPrivate>(this, std::move(dbPool), library, std::move(playlistLoader),
                                                       std::move(audioLoader), settings)}
 {
+    QObject::connect(&p->m_trackDatabaseManager, &TrackDatabaseManager::gotSnapshotTracks, this,
+                     &LibraryThreadHandler::gotSnapshotTracks);
     QObject::connect(&p->m_trackDatabaseManager, &TrackDatabaseManager::gotTracks, this,
                      &LibraryThreadHandler::gotTracks);
     QObject::connect(&p->m_trackDatabaseManager, &TrackDatabaseManager::updatedTracks, this,
@@ -383,7 +386,9 @@ LibraryThreadHandler::LibraryThreadHandler(DbConnectionPoolPtr dbPool, MusicLibr
                      &LibraryThreadHandler::tracksStatsUpdated);
     QObject::connect(&p->m_scanner, &Worker::finished, this, [this]() { p->finishScanRequest(); });
     QObject::connect(&p->m_scanner, &LibraryScanner::progressChanged, this,
-                     [this](int current, int total) { p->updateProgress(current, total); });
+                     [this](int current, int total, int rowsPerSecond) {
+                         p->updateProgress(current, total, rowsPerSecond);
+                     });
     QObject::connect(&p->m_scanner, &LibraryScanner::scannedTracks, this,
                      [this](const TrackList& tracks) { emit scannedTracks(p->m_currentRequestId, tracks); });
     QObject::connect(&p->m_scanner, &LibraryScanner::playlistLoaded, this,
@@ -476,9 +481,11 @@ void LibraryThreadHandler::saveUpdatedTrackStats(const TrackList& track)
                               [this, track]() { p->m_trackDatabaseManager.updateTrackStats(track); });
 }
 
-void LibraryThreadHandler::cleanupTracks()
+void LibraryThreadHandler::saveSnapshot(const TrackList& tracks, const QString& sortScript)
 {
-    QMetaObject::invokeMethod(&p->m_trackDatabaseManager, &TrackDatabaseManager::cleanupTracks);
+    QMetaObject::invokeMethod(&p->m_trackDatabaseManager, [this, tracks, sortScript]() {
+        p->m_trackDatabaseManager.saveSnapshot(tracks, sortScript);
+    });
 }
 } // namespace Fooyin
 
@@ -59,7 +59,7 @@ public:
     void saveUpdatedTracks(const TrackList& tracks);
     void writeUpdatedTracks(const TrackList& tracks);
     void saveUpdatedTrackStats(const TrackList& track);
-    void cleanupTracks();
+    void saveSnapshot(const TrackList& tracks, const QString& sortScript);
 
     void libraryRemoved(int id);
 
@@ -72,6 +72,7 @@ signals:
     void tracksUpdated(const Fooyin::TrackList& tracks);
     void tracksStatsUpdated(const Fooyin::TrackList& tracks);
 
+    void gotSnapshotTracks(const Fooyin::TrackList& result);
     void gotTracks(const Fooyin::TrackList& result);
 
 private:
@@ -0,0 +1,155 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "librarytrackindex.h"
+
+#include <algorithm>
+
+namespace Fooyin {
+void LibraryTrackIndex::rebuild(const TrackList& tracks)
+{
+    clear();
+
+    m_positions.reserve(tracks.size());
+    m_hashes.reserve(tracks.size());
+    m_filepaths.reserve(tracks.size());
+
+    for(size_t i{0}; i < tracks.size(); ++i) {
+        addTrack(tracks[i], i);
+    }
+}
+
+void LibraryTrackIndex::clear()
+{
+    m_positions.clear();
+    m_hashes.clear();
+    m_filepaths.clear();
+    m_albumHashes.clear();
+}
+
+void LibraryTrackIndex::addTrack(const Track& track, size_t position)
+{
+    const int id = track.id();
+
+    m_positions[id] = position;
+    addKey(m_hashes, track.hash(), id);
+    addKey(m_filepaths, track.filepath(), id);
+    addKey(m_albumHashes, track.albumHash(), id);
+}
+
+void LibraryTrackIndex::removeTrack(const Track& track)
+{
+    const int id = track.id();
+
+    m_positions.erase(id);
+    removeKey(m_hashes, track.hash(), id);
+    removeKey(m_filepaths, track.filepath(), id);
+    removeKey(m_albumHashes, track.albumHash(), id);
+}
+
+void LibraryTrackIndex::replaceTrack(const Track& oldTrack, const Track& newTrack)
+{
+    const int id = newTrack.id();
+
+    const QString oldHash = oldTrack.hash();
+    const QString newHash = newTrack.hash();
+    if(oldHash != newHash) {
+        removeKey(m_hashes, oldHash, id);
+        addKey(m_hashes, newHash, id);
+    }
+
+    const QString oldPath = oldTrack.filepath();
+    const QString newPath = newTrack.filepath();
+    if(oldPath != newPath) {
+        removeKey(m_filepaths, oldPath, id);
+        addKey(m_filepaths, newPath, id);
+    }
+
+    const QString oldAlbumHash = oldTrack.albumHash();
+    const QString newAlbumHash = newTrack.albumHash();
+    if(oldAlbumHash != newAlbumHash) {
+        removeKey(m_albumHashes, oldAlbumHash, id);
+        addKey(m_albumHashes, newAlbumHash, id);
+    }
+}
+
+void LibraryTrackIndex::updatePositions(const TrackList& tracks, size_t from)
+{
+    for(size_t i{from}; i < tracks.size(); ++i) {
+        m_positions[tracks[i].id()] = i;
+    }
+}
+
+size_t LibraryTrackIndex::size() const
+{
+    return m_positions.size();
+}
+
+std::optional<size_t> LibraryTrackIndex::position(int id) const
+{
+    if(const auto posIt = m_positions.find(id); posIt != m_positions.cend()) {
+        return posIt->second;
+    }
+    return {};
+}
+
+TrackIds LibraryTrackIndex::idsForHash(const QString& hash) const
+{
+    return idsForKey(m_hashes, hash);
+}
+
+TrackIds LibraryTrackIndex::idsForFilepath(const QString& filepath) const
+{
+    return idsForKey(m_filepaths, filepath);
+}
+
+TrackIds LibraryTrackIndex::idsForAlbumHash(const QString& albumHash) const
+{
+    return idsForKey(m_albumHashes, albumHash);
+}
+
+void LibraryTrackIndex::addKey(KeyIndex& index, const QString& key, int id)
+{
+    auto& ids = index[key];
+    if(std::ranges::find(ids, id) == ids.cend()) {
+        ids.push_back(id);
+    }
+}
+
+void LibraryTrackIndex::removeKey(KeyIndex& index, const QString& key, int id)
+{
+    const auto keyIt = index.find(key);
+    if(keyIt == index.end()) {
+        return;
+    }
+
+    std::erase(keyIt->second, id);
+    if(keyIt->second.empty()) {
+        index.erase(keyIt);
+    }
+}
+
+TrackIds LibraryTrackIndex::idsForKey(const KeyIndex& index, const QString& key)
+{
+    if(const auto keyIt = index.find(key); keyIt != index.cend()) {
+        return keyIt->second;
+    }
+    return {};
+}
+} // namespace Fooyin
@@ -0,0 +1,71 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/track.h>
+
+#include <optional>
+#include <unordered_map>
+
+namespace Fooyin {
+/*!
+ * Secondary indexes into a TrackList owned elsewhere.
+ * Maps track ids to their position in the list, and hashes, filepaths and album hashes to track ids.
+ * Positions must be refreshed using updatePositions whenever the list is reordered.
+ */
+class FYCORE_EXPORT LibraryTrackIndex
+{
+public:
+    /** Clears and rebuilds all indexes from @p tracks. */
+    void rebuild(const TrackList& tracks);
+    void clear();
+
+    /** Adds @p track, which is located at @p position in the indexed list. */
+    void addTrack(const Track& track, size_t position);
+    /** Removes @p track from the key indexes and drops its position. */
+    void removeTrack(const Track& track);
+    /** Updates the key indexes for a track which changed from @p oldTrack to @p newTrack. */
+    void replaceTrack(const Track& oldTrack, const Track& newTrack);
+    /** Refreshes id positions for @p tracks, starting at @p from. */
+    void updatePositions(const TrackList& tracks, size_t from = 0);
+
+    [[nodiscard]] size_t size() const;
+
+    /** Returns the position of the track with @p id, if indexed. */
+    [[nodiscard]] std::optional<size_t> position(int id) const;
+    [[nodiscard]] TrackIds idsForHash(const QString& hash) const;
+    [[nodiscard]] TrackIds idsForFilepath(const QString& filepath) const;
+    [[nodiscard]] TrackIds idsForAlbumHash(const QString& albumHash) const;
+
+private:
+    using KeyIndex = std::unordered_map<QString, TrackIds>;
+
+    static void addKey(KeyIndex& index, const QString& key, int id);
+    static void removeKey(KeyIndex& index, const QString& key, int id);
+    static TrackIds idsForKey(const KeyIndex& index, const QString& key);
+
+    std::unordered_map<int, size_t> m_positions;
+    KeyIndex m_hashes;
+    KeyIndex m_filepaths;
+    KeyIndex m_albumHashes;
+};
+} // namespace Fooyin
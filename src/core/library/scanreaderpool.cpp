@@ -0,0 +1,146 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "scanreaderpool.h"
+
+#include <QThread>
+
+#include <algorithm>
+
+// Maximum number of unconsumed results per worker
+constexpr auto ResultsPerThread = 16;
+constexpr auto MaxThreads       = 32;
+
+namespace Fooyin {
+ScanReaderPool::ScanReaderPool(int threadCount, ReadFunc readFunc, FinishedFunc finishedFunc)
+    : m_threadCount{std::clamp(threadCount > 0 ? threadCount : defaultThreadCount(), 1, MaxThreads)}
+    , m_readFunc{std::move(readFunc)}
+    , m_finishedFunc{std::move(finishedFunc)}
+    , m_window{static_cast<size_t>(m_threadCount) * ResultsPerThread}
+    , m_nextFile{0}
+    , m_nextResult{0}
+    , m_stopped{false}
+{ }
+
+ScanReaderPool::~ScanReaderPool()
+{
+    stop();
+}
+
+int ScanReaderPool::defaultThreadCount()
+{
+    // Tag reading is mostly bound by IO latency, so use a few more threads than cores
+    return std::clamp(QThread::idealThreadCount() * 2, 2, 16);
+}
+
+void ScanReaderPool::start(QStringList files)
+{
+    stop();
+
+    {
+        const std::scoped_lock lock{m_mutex};
+        m_files = std::move(files);
+        m_results.clear();
+        m_results.resize(m_files.size());
+        m_nextFile   = 0;
+        m_nextResult = 0;
+        m_stopped    = false;
+    }
+
+    const int threadCount = std::min(m_threadCount, static_cast<int>(m_files.size()));
+    for(int i{0}; i < threadCount; ++i) {
+        auto& thread = m_threads.emplace_back(QThread::create([this]() { run(); }));
+        thread->setObjectName(QStringLiteral("ScanReader%1").arg(i));
+        thread->start(QThread::LowPriority);
+    }
+}
+
+std::optional<ScanReadResult> ScanReaderPool::next()
+{
+    std::unique_lock lock{m_mutex};
+
+    if(m_nextResult >= m_results.size()) {
+        return {};
+    }
+
+    m_resultReady.wait(lock, [this]() { return m_stopped || m_results.at(m_nextResult).has_value(); });
+
+    if(m_stopped) {
+        return {};
+    }
+
+    auto& slot = m_results.at(m_nextResult++);
+    std::optional<ScanReadResult> result{std::move(slot)};
+    slot.reset();
+
+    lock.unlock();
+    m_fileReady.notify_one();
+
+    return result;
+}
+
+void ScanReaderPool::stop()
+{
+    {
+        const std::scoped_lock lock{m_mutex};
+        m_stopped = true;
+    }
+
+    m_fileReady.notify_all();
+    m_resultReady.notify_all();
+
+    for(const auto& thread : m_threads) {
+        thread->wait();
+    }
+    m_threads.clear();
+}
+
+void ScanReaderPool::run()
+{
+    while(true) {
+        size_t index{0};
+
+        {
+            std::unique_lock lock{m_mutex};
+            m_fileReady.wait(lock, [this]() {
+                return m_stopped || m_nextFile >= static_cast<size_t>(m_files.size())
+                    || m_nextFile < m_nextResult + m_window;
+            });
+
+            if(m_stopped || m_nextFile >= static_cast<size_t>(m_files.size())) {
+                break;
+            }
+
+            index = m_nextFile++;
+        }
+
+        ScanReadResult result = m_readFunc(m_files.at(static_cast<qsizetype>(index)));
+
+        {
+            const std::scoped_lock lock{m_mutex};
+            m_results.at(index) = std::move(result);
+        }
+        m_resultReady.notify_all();
+    }
+
+    if(m_finishedFunc) {
+        m_finishedFunc();
+    }
+}
+} // namespace Fooyin
@@ -0,0 +1,91 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <core/track.h>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+class QThread;
+
+namespace Fooyin {
+struct ScanReadResult
+{
+    enum class Type : uint8_t
+    {
+        Skipped = 0,
+        Existing,
+        Archive,
+        New
+    };
+
+    Type type{Type::Skipped};
+    QString filepath;
+    TrackList tracks;
+};
+
+/*!
+ * Reads files on a bounded set of worker threads, handing the results back in submission order.
+ * The read function is called concurrently and must only touch thread-safe or read-only state.
+ * The finished function is called on each worker thread before it exits.
+ */
+class ScanReaderPool
+{
+public:
+    using ReadFunc     = std::function<ScanReadResult(const QString& filepath)>;
+    using FinishedFunc = std::function<void()>;
+
+    ScanReaderPool(int threadCount, ReadFunc readFunc, FinishedFunc finishedFunc = {});
+    ~ScanReaderPool();
+
+    ScanReaderPool(const ScanReaderPool&)            = delete;
+    ScanReaderPool& operator=(const ScanReaderPool&) = delete;
+
+    [[nodiscard]] static int defaultThreadCount();
+
+    void start(QStringList files);
+    /** Blocks until the next result is available, or returns an empty optional once finished or stopped. */
+    [[nodiscard]] std::optional<ScanReadResult> next();
+    void stop();
+
+private:
+    void run();
+
+    int m_threadCount;
+    ReadFunc m_readFunc;
+    FinishedFunc m_finishedFunc;
+
+    QStringList m_files;
+    std::vector<std::optional<ScanReadResult>> m_results;
+    size_t m_window;
+    size_t m_nextFile;
+    size_t m_nextResult;
+    bool m_stopped;
+
+    std::mutex m_mutex;
+    std::condition_variable m_fileReady;
+    std::condition_variable m_resultReady;
+    std::vector<std::unique_ptr<QThread>> m_threads;
+};
+} // namespace Fooyin
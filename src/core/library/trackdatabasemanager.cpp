@@ -21,6 +21,7 @@
 
 #include "database/trackdatabase.h"
 #include "internalcoresettings.h"
+#include "librarysnapshot.h"
 
 #include <core/coresettings.h>
 #include <core/engine/audioloader.h>
@@ -52,15 +53,38 @@ void TrackDatabaseManager::initialiseThread()
 
 void TrackDatabaseManager::getAllTracks()
 {
+    const bool markUnavailable
+        = m_settings->fileValue(Settings::Core::Internal::MarkUnavailableStartup, false).toBool();
+
+    // Show the library from the snapshot while the full set is read from the database
+    const LibrarySnapshot snapshot;
+    if(QFileInfo::exists(snapshot.filepath())) {
+        if(const auto state = m_trackDatabase.state()) {
+            const QString sortScript = m_settings->value<Settings::Core::LibrarySortScript>();
+            if(auto snapshotTracks = snapshot.read(sortScript, state.value())) {
+                if(markUnavailable) {
+                    std::ranges::for_each(snapshotTracks.value(),
+                                          [](auto& track) { track.setIsEnabled(track.exists()); });
+                }
+                emit gotSnapshotTracks(snapshotTracks.value());
+            }
+        }
+    }
+
     TrackList tracks = m_trackDatabase.getAllTracks();
 
-    if(m_settings->fileValue(Settings::Core::Internal::MarkUnavailableStartup, false).toBool()) {
+    if(markUnavailable) {
         std::ranges::for_each(tracks, [](auto& track) { track.setIsEnabled(track.exists()); });
     }
 
     emit gotTracks(tracks);
 }
 
+void TrackDatabaseManager::saveSnapshot(const TrackList& tracks, const QString& sortScript)
+{
+    LibrarySnapshot{}.save(tracks, sortScript, m_trackDatabase);
+}
+
 void TrackDatabaseManager::updateTracks(const TrackList& tracks, bool write)
 {
     TrackList tracksUpdated;
@@ -131,11 +155,6 @@ void TrackDatabaseManager::updateTrackStats(const TrackList& tracks)
         emit updatedTracksStats(tracksUpdated);
     }
 }
-
-void TrackDatabaseManager::cleanupTracks()
-{
-    m_trackDatabase.cleanupTracks();
-}
 } // namespace Fooyin
 
 #include "moc_trackdatabasemanager.cpp"
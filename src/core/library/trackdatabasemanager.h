@@ -40,15 +40,16 @@ public:
     void initialiseThread() override;
 
 signals:
+    void gotSnapshotTracks(const Fooyin::TrackList& tracks);
     void gotTracks(const Fooyin::TrackList& tracks);
     void updatedTracks(const Fooyin::TrackList& tracks);
     void updatedTracksStats(const Fooyin::TrackList& tracks);
 
 public slots:
     void getAllTracks();
+    void saveSnapshot(const Fooyin::TrackList& tracks, const QString& sortScript);
     void updateTracks(const Fooyin::TrackList& tracks, bool write);
     void updateTrackStats(const Fooyin::TrackList& track);
-    void cleanupTracks();
 
 private:
     DbConnectionPoolPtr m_dbPool;
@@ -21,11 +21,66 @@
 
 #include <core/scripting/scriptparser.h>
 #include <core/track.h>
+#include <utils/async.h>
+#include <utils/sortkeycache.h>
 
+#include <algorithm>
 #include <mutex>
+#include <numeric>
 #include <ranges>
 
 #include <QCollator>
+#include <QThread>
+
+// Below this, generating keys on a single thread is quicker than spreading the work
+constexpr size_t ParallelKeyThreshold = 20000;
+
+namespace {
+std::vector<QCollatorSortKey> chunkSortKeys(const Fooyin::TrackList& tracks, size_t begin, size_t end)
+{
+    QCollator collator;
+    collator.setNumericMode(true);
+
+    std::vector<QCollatorSortKey> keys;
+    keys.reserve(end - begin);
+
+    for(size_t i{begin}; i < end; ++i) {
+        keys.push_back(collator.sortKey(tracks[i].sort()));
+    }
+
+    return keys;
+}
+
+std::vector<QCollatorSortKey> sortKeys(const Fooyin::TrackList& tracks)
+{
+    const size_t count     = tracks.size();
+    const auto threadCount = static_cast<size_t>(std::max(QThread::idealThreadCount(), 1));
+
+    if(count < ParallelKeyThreshold || threadCount == 1) {
+        return chunkSortKeys(tracks, 0, count);
+    }
+
+    // Collators aren't safe to share between threads, so each chunk uses its own
+    const size_t chunkSize = (count + threadCount - 1) / threadCount;
+
+    std::vector<QFuture<std::vector<QCollatorSortKey>>> chunks;
+    for(size_t begin{0}; begin < count; begin += chunkSize) {
+        const size_t end = std::min(begin + chunkSize, count);
+        chunks.push_back(
+            Fooyin::Utils::asyncExec([&tracks, begin, end]() { return chunkSortKeys(tracks, begin, end); }));
+    }
+
+    std::vector<QCollatorSortKey> keys;
+    keys.reserve(count);
+
+    for(auto& chunk : chunks) {
+        std::vector<QCollatorSortKey> chunkKeys = chunk.result();
+        std::ranges::move(chunkKeys, std::back_inserter(keys));
+    }
+
+    return keys;
+}
+} // namespace
 
 namespace Fooyin {
 class TrackSorterPrivate
@@ -77,25 +132,59 @@ TrackList TrackSorter::calcSortFields(const ParsedScript& sortScript, const Trac
 
 TrackList TrackSorter::sortTracks(const TrackList& tracks, Qt::SortOrder order)
 {
-    TrackList sortedTracks{tracks};
+    // Collate each sort field once up front, then sort using the much cheaper binary key comparison
+    const std::vector<QCollatorSortKey> keys = sortKeys(tracks);
 
-    QCollator collator;
-    collator.setNumericMode(true);
+    std::vector<size_t> indexes(tracks.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
 
-    std::ranges::stable_sort(sortedTracks, [order, collator](const Track& lhs, const Track& rhs) {
-        const auto cmp = collator.compare(lhs.sort(), rhs.sort());
-
-        if(cmp == 0) {
-            return false;
-        }
-        if(order == Qt::AscendingOrder) {
-            return cmp < 0;
-        }
-        return cmp > 0;
+    std::ranges::stable_sort(indexes, [order, &keys](size_t lhs, size_t rhs) {
+        const int cmp = keys[lhs].compare(keys[rhs]);
+        return order == Qt::AscendingOrder ? cmp < 0 : cmp > 0;
     });
+
+    TrackList sortedTracks;
+    sortedTracks.reserve(tracks.size());
+    for(const size_t index : indexes) {
+        sortedTracks.push_back(tracks[index]);
+    }
+
     return sortedTracks;
 }
 
+TrackList TrackSorter::insertSortedTracks(const TrackList& sortedTracks, const TrackList& tracks, Qt::SortOrder order)
+{
+    if(tracks.empty()) {
+        return sortedTracks;
+    }
+
+    // Only the fields compared during the binary searches below are collated, and each only once
+    SortKeyCache sortKeys;
+    const auto lessThan = [order, &sortKeys](const Track& lhs, const Track& rhs) {
+        const int cmp = sortKeys.compare(lhs.sort(), rhs.sort());
+        return order == Qt::AscendingOrder ? cmp < 0 : cmp > 0;
+    };
+
+    TrackList tracksToInsert{tracks};
+    std::ranges::stable_sort(tracksToInsert, lessThan);
+
+    TrackList mergedTracks;
+    mergedTracks.reserve(sortedTracks.size() + tracksToInsert.size());
+
+    // Inserted tracks are sorted, so each insertion point is found by searching after the previous one.
+    // Equal tracks are placed after existing ones to match a stable sort of the combined list.
+    auto sortedIt = sortedTracks.cbegin();
+    for(const Track& track : tracksToInsert) {
+        const auto insertIt = std::upper_bound(sortedIt, sortedTracks.cend(), track, lessThan);
+        mergedTracks.insert(mergedTracks.end(), sortedIt, insertIt);
+        mergedTracks.push_back(track);
+        sortedIt = insertIt;
+    }
+    mergedTracks.insert(mergedTracks.end(), sortedIt, sortedTracks.cend());
+
+    return mergedTracks;
+}
+
 TrackList TrackSorter::calcSortTracks(const QString& sort, const TrackList& tracks, Qt::SortOrder order)
 {
     return calcSortTracks(p->parseScript(sort), tracks, order);
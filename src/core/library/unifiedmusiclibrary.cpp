@@ -19,9 +19,12 @@
 
 #include "unifiedmusiclibrary.h"
 
+#include "database/trackdatabase.h"
 #include "internalcoresettings.h"
 #include "library/librarymanager.h"
+#include "librarysnapshot.h"
 #include "librarythreadhandler.h"
+#include "librarytrackindex.h"
 
 #include <core/coresettings.h>
 #include <core/library/libraryinfo.h>
@@ -33,6 +36,7 @@
 #include <QDateTime>
 
 #include <ranges>
+#include <unordered_set>
 
 using namespace std::chrono_literals;
 
@@ -45,8 +49,13 @@ public:
                                SettingsManager* settings);
 
     void loadTracks(const TrackList& trackToLoad);
+    void loadSnapshotTracks(const TrackList& snapshotTracks);
+    void reconcileTracks(const TrackList& dbTracks);
+    void removeTracks(const TrackList& tracksToRemove);
+    void setSortedTracks(const TrackList& sortedTracks);
+    [[nodiscard]] std::optional<size_t> trackPosition(int id) const;
     QFuture<void> addTracks(const TrackList& newTracks);
-    void updateLibraryTracks(const TrackList& updatedTracks);
+    TrackList updateLibraryTracks(const TrackList& updatedTracks);
     QFuture<void> updateTracksMetadata(const TrackList& tracksToUpdate);
     QFuture<void> updateTracks(const TrackList& tracksToUpdate);
 
@@ -55,11 +64,16 @@ public:
     void playlistLoaded(int id, const TrackList& tracks);
 
     void removeLibrary(const LibraryInfo& library, const std::set<int>& tracksRemoved);
-    void libraryStatusChanged(const LibraryInfo& library) const;
+    void libraryStatusChanged(const LibraryInfo& library);
+
+    void beginUpdate();
+    void endUpdate();
+    void pruneSharedStrings() const;
+    void requestSnapshot();
 
     void changeSort(const QString& sort);
     QFuture<TrackList> recalSortTracks(const QString& sort, const TrackList& tracks);
-    QFuture<TrackList> resortTracks(const TrackList& tracks);
+    QFuture<TrackList> resortTracks(const TrackList& tracks, const TrackList& changedTracks);
 
     void handleTracksLoaded();
 
@@ -73,6 +87,17 @@ public:
     TrackSorter m_sorter;
 
     TrackList m_tracks;
+    LibraryTrackIndex m_index;
+    // Sort script m_tracks is currently sorted by
+    QString m_sortScript;
+
+    // Tracks were loaded from the snapshot and still need reconciling with the database
+    bool m_loadedFromSnapshot{false};
+    // Tracks and sort are unchanged since being loaded from the snapshot
+    bool m_snapshotCurrent{false};
+    bool m_scanning{false};
+    bool m_snapshotRequested{false};
+    int m_pendingUpdates{0};
 };
 
 UnifiedMusicLibraryPrivate::UnifiedMusicLibraryPrivate(UnifiedMusicLibrary* self, LibraryManager* libraryManager,
@@ -94,58 +119,142 @@ UnifiedMusicLibraryPrivate::UnifiedMusicLibraryPrivate(UnifiedMusicLibrary* self
 
 void UnifiedMusicLibraryPrivate::loadTracks(const TrackList& trackToLoad)
 {
+    if(m_loadedFromSnapshot) {
+        reconcileTracks(trackToLoad);
+        return;
+    }
+
     if(trackToLoad.empty()) {
         emit m_self->tracksLoaded({});
         return;
     }
 
-    auto sortTracks = recalSortTracks(m_settings->value<Settings::Core::LibrarySortScript>(), trackToLoad);
+    const QString sort = m_settings->value<Settings::Core::LibrarySortScript>();
+    auto sortTracks    = recalSortTracks(sort, trackToLoad);
 
-    sortTracks.then(m_self, [this](const TrackList& sortedTracks) {
-        m_tracks = sortedTracks;
+    sortTracks.then(m_self, [this, sort](const TrackList& sortedTracks) {
+        m_tracks     = sortedTracks;
+        m_sortScript = sort;
+        m_index.rebuild(m_tracks);
         emit m_self->tracksLoaded(m_tracks);
     });
 }
 
+void UnifiedMusicLibraryPrivate::loadSnapshotTracks(const TrackList& snapshotTracks)
+{
+    // Snapshot tracks are already sorted
+    m_tracks             = snapshotTracks;
+    m_sortScript         = m_settings->value<Settings::Core::LibrarySortScript>();
+    m_loadedFromSnapshot = true;
+    m_snapshotCurrent    = true;
+    m_index.rebuild(m_tracks);
+    emit m_self->tracksLoaded(m_tracks);
+}
+
+void UnifiedMusicLibraryPrivate::reconcileTracks(const TrackList& dbTracks)
+{
+    m_loadedFromSnapshot = false;
+
+    Utils::asyncExec([snapshotTracks = m_tracks, dbTracks]() {
+        return LibrarySnapshot::changes(snapshotTracks, dbTracks);
+    }).then(m_self, [this](const LibrarySnapshot::Changes& changes) {
+        if(!changes.removed.empty()) {
+            removeTracks(changes.removed);
+        }
+        if(!changes.updated.empty()) {
+            updateTracksMetadata(changes.updated);
+        }
+        if(!changes.added.empty()) {
+            addTracks(changes.added);
+        }
+    });
+}
+
+void UnifiedMusicLibraryPrivate::removeTracks(const TrackList& tracksToRemove)
+{
+    std::unordered_set<int> removedIds;
+    for(const Track& track : tracksToRemove) {
+        m_index.removeTrack(track);
+        removedIds.emplace(track.id());
+    }
+
+    std::erase_if(m_tracks, [&removedIds](const Track& track) { return removedIds.contains(track.id()); });
+    m_index.updatePositions(m_tracks);
+    m_snapshotCurrent = false;
+
+    emit m_self->tracksDeleted(tracksToRemove);
+    pruneSharedStrings();
+}
+
+void UnifiedMusicLibraryPrivate::setSortedTracks(const TrackList& sortedTracks)
+{
+    m_tracks = sortedTracks;
+    m_index.updatePositions(m_tracks);
+    m_snapshotCurrent = false;
+}
+
+std::optional<size_t> UnifiedMusicLibraryPrivate::trackPosition(int id) const
+{
+    // A resort started before tracks were added may have dropped them, so validate the position
+    const auto position = m_index.position(id);
+    if(position && position.value() < m_tracks.size() && m_tracks[position.value()].id() == id) {
+        return position;
+    }
+    return {};
+}
+
 QFuture<void> UnifiedMusicLibraryPrivate::addTracks(const TrackList& newTracks)
 {
     TrackList tracksToAdd;
     std::ranges::copy_if(newTracks, std::back_inserter(tracksToAdd),
                          [](const Track& track) { return track.isNewTrack(); });
+
+    beginUpdate();
     auto sortTracks = recalSortTracks(m_settings->value<Settings::Core::LibrarySortScript>(), tracksToAdd);
 
     return sortTracks.then(m_self, [this](const TrackList& sortedTracks) {
-        std::ranges::copy(sortedTracks, std::back_inserter(m_tracks));
+        for(const Track& track : sortedTracks) {
+            m_index.addTrack(track, m_tracks.size());
+            m_tracks.push_back(track);
+        }
 
-        resortTracks(m_tracks).then(m_self, [this, sortedTracks](const TrackList& sortedLibraryTracks) {
-            m_tracks = sortedLibraryTracks;
+        resortTracks(m_tracks, sortedTracks).then(m_self, [this, sortedTracks](const TrackList& sortedLibraryTracks) {
+            setSortedTracks(sortedLibraryTracks);
+            endUpdate();
 
             emit m_self->tracksAdded(sortedTracks);
         });
     });
 }
 
-void UnifiedMusicLibraryPrivate::updateLibraryTracks(const TrackList& updatedTracks)
+TrackList UnifiedMusicLibraryPrivate::updateLibraryTracks(const TrackList& updatedTracks)
 {
+    TrackList libraryTracks;
+
     for(const auto& track : updatedTracks) {
-        auto trackIt
-            = std::ranges::find_if(m_tracks, [&track](const Track& oldTrack) { return oldTrack.id() == track.id(); });
-        if(trackIt != m_tracks.end()) {
-            *trackIt = track;
-            trackIt->clearWasModified();
+        if(const auto position = trackPosition(track.id())) {
+            Track& libraryTrack = m_tracks.at(position.value());
+            m_index.replaceTrack(libraryTrack, track);
+            libraryTrack = track;
+            libraryTrack.clearWasModified();
+            libraryTracks.push_back(libraryTrack);
         }
     }
+
+    return libraryTracks;
 }
 
 QFuture<void> UnifiedMusicLibraryPrivate::updateTracksMetadata(const TrackList& tracksToUpdate)
 {
+    beginUpdate();
     auto sortTracks = recalSortTracks(m_settings->value<Settings::Core::LibrarySortScript>(), tracksToUpdate);
 
     return sortTracks.then(m_self, [this](const TrackList& sortedTracks) {
-        updateLibraryTracks(sortedTracks);
+        const TrackList libraryTracks = updateLibraryTracks(sortedTracks);
 
-        resortTracks(m_tracks).then(m_self, [this, sortedTracks](const TrackList& sortedLibraryTracks) {
-            m_tracks = sortedLibraryTracks;
+        resortTracks(m_tracks, libraryTracks).then(m_self, [this, sortedTracks](const TrackList& sortedLibraryTracks) {
+            setSortedTracks(sortedLibraryTracks);
+            endUpdate();
             emit m_self->tracksMetadataChanged(sortedTracks);
         });
     });
@@ -153,13 +262,15 @@ QFuture<void> UnifiedMusicLibraryPrivate::updateTracksMetadata(const TrackList&
 
 QFuture<void> UnifiedMusicLibraryPrivate::updateTracks(const TrackList& tracksToUpdate)
 {
+    beginUpdate();
     auto sortTracks = recalSortTracks(m_settings->value<Settings::Core::LibrarySortScript>(), tracksToUpdate);
 
     return sortTracks.then(m_self, [this](const TrackList& sortedTracks) {
-        updateLibraryTracks(sortedTracks);
+        const TrackList libraryTracks = updateLibraryTracks(sortedTracks);
 
-        resortTracks(m_tracks).then(m_self, [this, sortedTracks](const TrackList& sortedLibraryTracks) {
-            m_tracks = sortedLibraryTracks;
+        resortTracks(m_tracks, libraryTracks).then(m_self, [this, sortedTracks](const TrackList& sortedLibraryTracks) {
+            setSortedTracks(sortedLibraryTracks);
+            endUpdate();
             emit m_self->tracksUpdated(sortedTracks);
         });
     });
@@ -207,31 +318,79 @@ void UnifiedMusicLibraryPrivate::removeLibrary(const LibraryInfo& library, const
     for(auto& track : m_tracks) {
         if(track.libraryId() == library.id) {
             if(tracksRemoved.contains(track.id())) {
+                m_index.removeTrack(track);
                 removedTracks.push_back(track);
                 continue;
             }
             track.setLibraryId(-1);
             updatedTracks.push_back(track);
-            newTracks.push_back(track);
         }
         newTracks.push_back(track);
     }
 
-    m_tracks = newTracks;
+    setSortedTracks(newTracks);
 
     emit m_self->tracksDeleted(removedTracks);
     emit m_self->tracksMetadataChanged(updatedTracks);
+    pruneSharedStrings();
 }
 
-void UnifiedMusicLibraryPrivate::libraryStatusChanged(const LibraryInfo& library) const
+void UnifiedMusicLibraryPrivate::libraryStatusChanged(const LibraryInfo& library)
 {
     m_libraryManager->updateLibraryStatus(library);
+
+    if(library.status == LibraryInfo::Status::Scanning) {
+        m_scanning = true;
+    }
+    else if(m_scanning && library.status != LibraryInfo::Status::Pending) {
+        m_scanning = false;
+        requestSnapshot();
+    }
+}
+
+void UnifiedMusicLibraryPrivate::beginUpdate()
+{
+    ++m_pendingUpdates;
+    m_snapshotCurrent = false;
+}
+
+void UnifiedMusicLibraryPrivate::endUpdate()
+{
+    --m_pendingUpdates;
+
+    if(m_pendingUpdates == 0) {
+        // Retagged tracks may have left values unused
+        pruneSharedStrings();
+
+        if(m_snapshotRequested) {
+            requestSnapshot();
+        }
+    }
+}
+
+void UnifiedMusicLibraryPrivate::pruneSharedStrings() const
+{
+    // Queued so the tracks just replaced or removed, and any signals carrying them, have been released
+    QMetaObject::invokeMethod(m_self, []() { Track::pruneSharedStrings(); }, Qt::QueuedConnection);
+}
+
+void UnifiedMusicLibraryPrivate::requestSnapshot()
+{
+    // Wait for any in-progress sorts so the snapshot includes the scanned tracks
+    if(m_pendingUpdates > 0) {
+        m_snapshotRequested = true;
+        return;
+    }
+
+    m_snapshotRequested = false;
+    m_threadHandler.saveSnapshot(m_tracks, m_sortScript);
 }
 
 void UnifiedMusicLibraryPrivate::changeSort(const QString& sort)
 {
-    recalSortTracks(sort, m_tracks).then(m_self, [this](const TrackList& sortedTracks) {
-        m_tracks = sortedTracks;
+    recalSortTracks(sort, m_tracks).then(m_self, [this, sort](const TrackList& sortedTracks) {
+        setSortedTracks(sortedTracks);
+        m_sortScript = sort;
         emit m_self->tracksSorted(m_tracks);
     });
 }
@@ -241,9 +400,22 @@ QFuture<TrackList> UnifiedMusicLibraryPrivate::recalSortTracks(const QString& so
     return Utils::asyncExec([this, sort, tracks]() { return m_sorter.calcSortTracks(sort, tracks); });
 }
 
-QFuture<TrackList> UnifiedMusicLibraryPrivate::resortTracks(const TrackList& tracks)
+QFuture<TrackList> UnifiedMusicLibraryPrivate::resortTracks(const TrackList& tracks, const TrackList& changedTracks)
 {
-    return Utils::asyncExec([tracks]() { return TrackSorter::sortTracks(tracks); });
+    // The rest of the library is already sorted, so only the changed tracks need to be placed
+    return Utils::asyncExec([tracks, changedTracks]() {
+        std::unordered_set<int> changedIds;
+        for(const Track& track : changedTracks) {
+            changedIds.emplace(track.id());
+        }
+
+        TrackList unchangedTracks;
+        unchangedTracks.reserve(tracks.size());
+        std::ranges::copy_if(tracks, std::back_inserter(unchangedTracks),
+                             [&changedIds](const Track& track) { return !changedIds.contains(track.id()); });
+
+        return TrackSorter::insertSortedTracks(unchangedTracks, changedTracks);
+    });
 }
 
 void UnifiedMusicLibraryPrivate::handleTracksLoaded()
@@ -286,6 +458,8 @@ UnifiedMusicLibrary::UnifiedMusicLibrary(LibraryManager* libraryManager, DbConne
                      [this](const TrackList& tracks) { p->updateTracksMetadata(tracks); });
     QObject::connect(&p->m_threadHandler, &LibraryThreadHandler::tracksStatsUpdated, this,
                      [this](const TrackList& tracks) { p->updateTracks(tracks); });
+    QObject::connect(&p->m_threadHandler, &LibraryThreadHandler::gotSnapshotTracks, this,
+                     [this](const TrackList& tracks) { p->loadSnapshotTracks(tracks); });
     QObject::connect(&p->m_threadHandler, &LibraryThreadHandler::gotTracks, this,
                      [this](const TrackList& tracks) { p->loadTracks(tracks); });
 
@@ -379,9 +553,8 @@ TrackList UnifiedMusicLibrary::tracks() const
 
 Track UnifiedMusicLibrary::trackForId(int id) const
 {
-    auto trackIt = std::ranges::find_if(p->m_tracks, [id](const Track& track) { return track.id() == id; });
-    if(trackIt != p->m_tracks.cend()) {
-        return *trackIt;
+    if(const auto position = p->trackPosition(id)) {
+        return p->m_tracks.at(position.value());
     }
     return {};
 }
@@ -392,15 +565,24 @@ TrackList UnifiedMusicLibrary::tracksForIds(const TrackIds& ids) const
     tracks.reserve(ids.size());
 
     for(const int id : ids) {
-        auto trackIt = std::ranges::find_if(p->m_tracks, [id](const Track& track) { return track.id() == id; });
-        if(trackIt != p->m_tracks.cend()) {
-            tracks.push_back(*trackIt);
+        if(const auto position = p->trackPosition(id)) {
+            tracks.push_back(p->m_tracks.at(position.value()));
         }
     }
 
     return tracks;
 }
 
+TrackList UnifiedMusicLibrary::tracksForFilepath(const QString& filepath) const
+{
+    return tracksForIds(p->m_index.idsForFilepath(filepath));
+}
+
+TrackList UnifiedMusicLibrary::tracksForAlbum(const QString& albumHash) const
+{
+    return tracksForIds(p->m_index.idsForAlbumHash(albumHash));
+}
+
 void UnifiedMusicLibrary::updateTrack(const Track& track)
 {
     updateTracks({track});
@@ -433,14 +615,14 @@ void UnifiedMusicLibrary::updateTrackStats(const Track& track)
 
 void UnifiedMusicLibrary::trackWasPlayed(const Track& track)
 {
-    const QString hash  = track.hash();
     const auto currTime = QDateTime::currentMSecsSinceEpoch();
     const int playCount = track.playCount() + 1;
 
     TrackList tracksToUpdate;
-    for(const auto& libraryTrack : p->m_tracks) {
-        if(libraryTrack.hash() == hash) {
-            Track sameHashTrack{libraryTrack};
+    const TrackIds sameHashIds = p->m_index.idsForHash(track.hash());
+    for(const int id : sameHashIds) {
+        if(const auto position = p->trackPosition(id)) {
+            Track sameHashTrack{p->m_tracks.at(position.value())};
             sameHashTrack.setFirstPlayed(currTime);
             sameHashTrack.setLastPlayed(currTime);
             sameHashTrack.setPlayCount(playCount);
@@ -453,9 +635,31 @@ void UnifiedMusicLibrary::trackWasPlayed(const Track& track)
     p->updateTracks(tracksToUpdate);
 }
 
+void UnifiedMusicLibrary::saveSnapshot()
+{
+    // Skip if the library is mid-update or unchanged since it was loaded from the snapshot
+    if(p->m_pendingUpdates > 0 || p->m_snapshotCurrent) {
+        return;
+    }
+
+    TrackDatabase trackDatabase;
+    trackDatabase.initialise(DbConnectionProvider{p->m_dbPool});
+
+    LibrarySnapshot{}.save(p->m_tracks, p->m_sortScript, trackDatabase);
+}
+
 void UnifiedMusicLibrary::cleanupTracks()
 {
-    p->m_threadHandler.cleanupTracks();
+    TrackDatabase trackDatabase;
+    trackDatabase.initialise(DbConnectionProvider{p->m_dbPool});
+
+    const auto state = trackDatabase.state();
+    trackDatabase.cleanupTracks();
+
+    // The snapshot loaded at startup no longer matches the database, so it needs to be written again
+    if(trackDatabase.state() != state) {
+        p->m_snapshotCurrent = false;
+    }
 }
 } // namespace Fooyin
 
@@ -60,6 +60,8 @@ public:
     [[nodiscard]] TrackList tracks() const override;
     [[nodiscard]] Track trackForId(int id) const override;
     [[nodiscard]] TrackList tracksForIds(const TrackIds& ids) const override;
+    [[nodiscard]] TrackList tracksForFilepath(const QString& filepath) const override;
+    [[nodiscard]] TrackList tracksForAlbum(const QString& albumHash) const override;
 
     void updateTrack(const Track& track) override;
     void updateTracks(const TrackList& tracks) override;
@@ -71,6 +73,9 @@ public:
     void updateTrackStats(const Track& track) override;
 
     void trackWasPlayed(const Track& track);
+    /** Writes the sorted library to the snapshot loaded at startup. Blocks until written. */
+    void saveSnapshot();
+    /** Removes unused tracks and stats from the database. Blocks until finished. */
     void cleanupTracks();
 
 private:
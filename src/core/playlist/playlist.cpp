@@ -127,8 +127,11 @@ int PlaylistPrivate::getNextIndex(int delta, Playlist::PlayModes mode, bool only
     int nextIndex = m_currentTrackIndex;
 
     if(m_nextTrackIndex >= 0) {
-        nextIndex        = m_nextTrackIndex;
-        m_nextTrackIndex = -1;
+        nextIndex = m_nextTrackIndex;
+        // Only consumed once playback actually moves to it
+        if(!onlyCheck) {
+            m_nextTrackIndex = -1;
+        }
     }
     else {
         const int count = static_cast<int>(m_tracks.size());
@@ -0,0 +1,127 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "playlistdiff.h"
+
+#include <algorithm>
+
+namespace Fooyin {
+std::optional<PlaylistDiff> diffPlaylistTracks(const TrackIds& oldIds, const TrackIds& newIds, int maxEdits)
+{
+    const auto oldSize = static_cast<int>(oldIds.size());
+    const auto newSize = static_cast<int>(newIds.size());
+
+    PlaylistDiff diff;
+    diff.newToOld.assign(newIds.size(), -1);
+
+    // Most edits only touch a small part of the list, so skip the common ends first
+    int prefix{0};
+    while(prefix < oldSize && prefix < newSize && oldIds[prefix] == newIds[prefix]) {
+        diff.newToOld[prefix] = prefix;
+        ++prefix;
+    }
+
+    int suffix{0};
+    while(suffix < oldSize - prefix && suffix < newSize - prefix
+          && oldIds[oldSize - suffix - 1] == newIds[newSize - suffix - 1]) {
+        diff.newToOld[newSize - suffix - 1] = oldSize - suffix - 1;
+        ++suffix;
+    }
+
+    const int n = oldSize - prefix - suffix;
+    const int m = newSize - prefix - suffix;
+
+    const auto oldId = [&](int i) {
+        return oldIds[prefix + i];
+    };
+    const auto newId = [&](int i) {
+        return newIds[prefix + i];
+    };
+
+    const int maxD   = std::min(n + m, std::max(maxEdits, 0));
+    const int offset = maxD + 1;
+
+    // Furthest reaching x for each diagonal k, and a copy of the reachable diagonals after each step
+    std::vector<int> v(2 * static_cast<size_t>(maxD) + 3, 0);
+    std::vector<std::vector<int>> trace;
+
+    int edits{-1};
+    for(int d{0}; d <= maxD && edits < 0; ++d) {
+        for(int k{-d}; k <= d; k += 2) {
+            int x = (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1])) ? v[offset + k + 1]
+                                                                                   : v[offset + k - 1] + 1;
+            int y = x - k;
+            while(x < n && y < m && oldId(x) == newId(y)) {
+                ++x;
+                ++y;
+            }
+            v[offset + k] = x;
+
+            if(x >= n && y >= m) {
+                edits = d;
+                break;
+            }
+        }
+        trace.emplace_back(v.cbegin() + offset - d, v.cbegin() + offset + d + 1);
+    }
+
+    if(edits < 0) {
+        return {};
+    }
+
+    int x{n};
+    int y{m};
+
+    for(int d{edits}; d > 0; --d) {
+        const auto& prev = trace.at(d - 1);
+        const auto prevV = [&prev, d](int k) {
+            return prev.at(k + d - 1);
+        };
+
+        const int k         = x - y;
+        const bool inserted = k == -d || (k != d && prevV(k - 1) < prevV(k + 1));
+        const int prevK     = inserted ? k + 1 : k - 1;
+        const int prevX     = prevV(prevK);
+        const int prevY     = prevX - prevK;
+
+        while(x > prevX && y > prevY) {
+            --x;
+            --y;
+            diff.newToOld[prefix + y] = prefix + x;
+        }
+
+        if(!inserted) {
+            diff.removed.push_back(prefix + prevX);
+        }
+
+        x = prevX;
+        y = prevY;
+    }
+
+    while(x > 0 && y > 0) {
+        --x;
+        --y;
+        diff.newToOld[prefix + y] = prefix + x;
+    }
+
+    std::ranges::reverse(diff.removed);
+
+    return diff;
+}
+} // namespace Fooyin
@@ -0,0 +1,46 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/track.h>
+
+#include <optional>
+
+namespace Fooyin {
+/*!
+ * The shortest set of insertions and removals which turns one list of track ids into another.
+ */
+struct PlaylistDiff
+{
+    // For each new track, the index of the same entry in the old list, or -1 if it was inserted
+    std::vector<int> newToOld;
+    // Indexes of old tracks which were removed, in ascending order
+    std::vector<int> removed;
+};
+
+/*!
+ * Diffs @p oldIds against @p newIds using Myers' algorithm.
+ * Returns an empty optional if more than @p maxEdits insertions and removals are needed.
+ */
+FYCORE_EXPORT std::optional<PlaylistDiff> diffPlaylistTracks(const TrackIds& oldIds, const TrackIds& newIds,
+                                                             int maxEdits);
+} // namespace Fooyin
@@ -160,13 +160,14 @@ Track PlaylistHandlerPrivate::nextTrack(int delta)
         return {};
     }
 
-    Track nextTrk = m_activePlaylist->nextTrack(delta, m_playerController->playMode());
+    // Match nextTrackChange, which switches to any scheduled playlist first
+    Track nextTrk = playlist->nextTrack(delta, m_playerController->playMode());
 
     if(nextTrk.isValid() && !nextTrk.metadataWasRead()) {
         if(m_audioLoader->readTrackMetadata(nextTrk)) {
             nextTrk.generateHash();
-            const int nextIndex = m_activePlaylist->nextIndex(delta, m_playerController->playMode());
-            m_activePlaylist->updateTrackAtIndex(nextIndex, nextTrk);
+            const int nextIndex = playlist->nextIndex(delta, m_playerController->playMode());
+            playlist->updateTrackAtIndex(nextIndex, nextTrk);
         }
     }
 
@@ -818,11 +819,6 @@ void PlaylistHandler::handleTracksRemoved(const TrackList& tracks)
         }
     }
 }
-
-void PlaylistHandler::trackAboutToFinish()
-{
-    p->nextTrack(1);
-}
 } // namespace Fooyin
 
 #include "core/playlist/moc_playlisthandler.cpp"
@@ -19,12 +19,16 @@
 
 #include <core/scripting/scriptparser.h>
 
+#include "scriptprogram.h"
+
 #include <core/constants.h>
 #include <core/scripting/scriptscanner.h>
 #include <core/track.h>
 
 #include <QDebug>
 
+#include <atomic>
+
 using TokenType = Fooyin::ScriptScanner::TokenType;
 
 namespace {
@@ -45,6 +49,22 @@ QStringList evalStringList(const Fooyin::ScriptResult& evalExpr, const QStringLi
     }
     return listResult;
 }
+
+bool hasTracks(const Fooyin::Track& /*track*/)
+{
+    return true;
+}
+
+bool hasTracks(const Fooyin::TrackList& tracks)
+{
+    return !tracks.empty();
+}
+
+uint64_t nextParserId()
+{
+    static std::atomic<uint64_t> parserId{0};
+    return ++parserId;
+}
 } // namespace
 
 namespace Fooyin {
@@ -83,6 +103,8 @@ public:
     QString evaluate(const ParsedScript& input, const auto& tracks);
 
     ScriptParser* m_self;
+    // Identifies programs compiled by this parser
+    uint64_t m_id;
 
     ScriptScanner m_scanner;
     std::unique_ptr<ScriptRegistry> m_defaultRegistry;
@@ -94,16 +116,19 @@ public:
     QString m_currentInput;
     std::unordered_map<QString, ParsedScript> m_parsedScripts;
     QStringList m_currentResult;
+    ScriptEvaluator m_evaluator;
 };
 
 ScriptParserPrivate::ScriptParserPrivate(ScriptParser* self)
     : m_self{self}
+    , m_id{nextParserId()}
     , m_defaultRegistry{std::make_unique<ScriptRegistry>()}
     , m_registry{m_defaultRegistry.get()}
 { }
 
 ScriptParserPrivate::ScriptParserPrivate(ScriptParser* self, ScriptRegistry* registry)
     : m_self{self}
+    , m_id{nextParserId()}
     , m_registry{registry}
 { }
 
@@ -364,7 +389,7 @@ ScriptResult ScriptParserPrivate::evalVariableList(const Expression& exp, const
 
 ScriptResult ScriptParserPrivate::evalFunction(const Expression& exp, const auto& tracks) const
 {
-    auto func = std::get<FuncValue>(exp.value);
+    const auto& func = std::get<FuncValue>(exp.value);
     ScriptValueList args;
     std::ranges::transform(func.args, std::back_inserter(args),
                            [this, &tracks](const Expression& arg) { return evalExpression(arg, tracks); });
@@ -376,7 +401,7 @@ ScriptResult ScriptParserPrivate::evalFunctionArg(const Expression& exp, const a
     ScriptResult result;
     bool allPassed{true};
 
-    auto arg = std::get<ExpressionList>(exp.value);
+    const auto& arg = std::get<ExpressionList>(exp.value);
     for(const Expression& subArg : arg) {
         const auto subExpr = evalExpression(subArg, tracks);
         if(!subExpr.cond) {
@@ -403,7 +428,7 @@ ScriptResult ScriptParserPrivate::evalConditional(const Expression& exp, const a
     QStringList exprResult;
     result.cond = true;
 
-    auto arg = std::get<ExpressionList>(exp.value);
+    const auto& arg = std::get<ExpressionList>(exp.value);
     for(const Expression& subArg : arg) {
         const auto subExpr = evalExpression(subArg, tracks);
 
@@ -464,6 +489,10 @@ ParsedScript ScriptParserPrivate::parse(const QString& input, const auto& tracks
 
     consume(TokenType::TokEos, QStringLiteral("Expected end of expression"));
 
+    if(script.isValid()) {
+        script.program = ScriptProgram::compile(script.expressions, m_registry, m_id);
+    }
+
     return script;
 }
 
@@ -473,10 +502,14 @@ QString ScriptParserPrivate::evaluate(const ParsedScript& input, const auto& tra
         return {};
     }
 
+    // Programs are only valid for the registry they were compiled against
+    if(input.program && input.program->owner() == m_id && hasTracks(tracks)) {
+        return m_evaluator.evaluate(*input.program, tracks);
+    }
+
     m_currentResult.clear();
 
-    const ExpressionList expressions = input.expressions;
-    for(const auto& expr : expressions) {
+    for(const auto& expr : input.expressions) {
         const auto evalExpr = evalExpression(expr, tracks);
 
         if(evalExpr.value.isNull()) {
@@ -0,0 +1,510 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "scriptprogram.h"
+
+#include <core/constants.h>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+using Op = Fooyin::ScriptProgram::Op;
+
+namespace {
+QLatin1String unitSeparator()
+{
+    return QLatin1String{Fooyin::Constants::UnitSeparator};
+}
+
+QStringList evalStringList(const QString& value, const QStringList& result)
+{
+    QStringList listResult;
+    const QStringList values = value.split(unitSeparator());
+    const bool isEmpty       = result.empty();
+
+    for(const QString& subValue : values) {
+        if(isEmpty) {
+            listResult.append(subValue);
+        }
+        else {
+            for(const QString& retValue : result) {
+                listResult.emplace_back(retValue + subValue);
+            }
+        }
+    }
+    return listResult;
+}
+
+void appendValue(QStringList& results, const QString& value)
+{
+    if(value.contains(unitSeparator())) {
+        results = evalStringList(value, results);
+    }
+    else if(results.empty()) {
+        results.append(value);
+    }
+    else {
+        for(QString& result : results) {
+            result += value;
+        }
+    }
+}
+
+// Merges runs of adjacent literals, which are always concatenated unconditionally
+Fooyin::ExpressionList mergeLiterals(const Fooyin::ExpressionList& expressions)
+{
+    Fooyin::ExpressionList merged;
+    merged.reserve(expressions.size());
+
+    for(const auto& expr : expressions) {
+        if(expr.type == Fooyin::Expr::Literal && !merged.empty() && merged.back().type == Fooyin::Expr::Literal) {
+            auto& prevValue   = std::get<QString>(merged.back().value);
+            const auto& value = std::get<QString>(expr.value);
+            if(!prevValue.contains(unitSeparator()) && !value.contains(unitSeparator())) {
+                prevValue += value;
+                continue;
+            }
+        }
+        merged.push_back(expr);
+    }
+
+    return merged;
+}
+} // namespace
+
+namespace Fooyin {
+class ScriptCompiler
+{
+public:
+    explicit ScriptCompiler(ScriptProgram* program)
+        : m_program{program}
+    { }
+
+    void compile(const ExpressionList& expressions);
+
+private:
+    bool expression(const Expression& expr);
+    bool variable(const Expression& expr, Op op);
+    bool function(const Expression& expr);
+    bool functionArg(const Expression& expr);
+    bool conditional(const Expression& expr);
+
+    void fold(size_t begin);
+    void emit(Op op, int operand = 0, int count = 0);
+    int addConstant(ScriptResult result);
+    int addHandle(ScriptHandle handle);
+
+    [[nodiscard]] size_t size() const;
+
+    ScriptProgram* m_program;
+    ScriptEvaluator m_evaluator;
+};
+
+void ScriptCompiler::compile(const ExpressionList& expressions)
+{
+    for(const auto& expr : mergeLiterals(expressions)) {
+        expression(expr);
+        emit(Op::Output);
+    }
+}
+
+bool ScriptCompiler::expression(const Expression& expr)
+{
+    switch(expr.type) {
+        case(Expr::Literal):
+            emit(Op::Constant, addConstant({.value = std::get<QString>(expr.value), .cond = true}));
+            return true;
+        case(Expr::Variable):
+            return variable(expr, Op::Variable);
+        case(Expr::VariableList):
+            return variable(expr, Op::VariableList);
+        case(Expr::Function):
+            return function(expr);
+        case(Expr::FunctionArg):
+            return functionArg(expr);
+        case(Expr::Conditional):
+            return conditional(expr);
+        case(Expr::Null):
+        default:
+            emit(Op::Constant, addConstant({}));
+            return true;
+    }
+}
+
+bool ScriptCompiler::variable(const Expression& expr, Op op)
+{
+    emit(op, addHandle(m_program->m_registry->resolveVariable(std::get<QString>(expr.value))));
+    return false;
+}
+
+bool ScriptCompiler::function(const Expression& expr)
+{
+    const size_t begin = size();
+    const auto& func   = std::get<FuncValue>(expr.value);
+
+    bool isConstant{true};
+    for(const auto& arg : func.args) {
+        isConstant &= expression(arg);
+    }
+
+    ScriptHandle handle = m_program->m_registry->resolveFunction(func.name);
+    isConstant &= handle.isPureFunction();
+
+    emit(Op::Function, addHandle(std::move(handle)), static_cast<int>(func.args.size()));
+
+    if(isConstant) {
+        fold(begin);
+    }
+    return isConstant;
+}
+
+bool ScriptCompiler::functionArg(const Expression& expr)
+{
+    const size_t begin = size();
+    const auto args    = mergeLiterals(std::get<ExpressionList>(expr.value));
+
+    bool isConstant{true};
+    for(const auto& arg : args) {
+        isConstant &= expression(arg);
+    }
+
+    emit(Op::Concat, 0, static_cast<int>(args.size()));
+
+    if(isConstant) {
+        fold(begin);
+    }
+    return isConstant;
+}
+
+bool ScriptCompiler::conditional(const Expression& expr)
+{
+    const size_t begin = size();
+    const auto args    = mergeLiterals(std::get<ExpressionList>(expr.value));
+
+    emit(Op::CondBegin);
+
+    bool isConstant{true};
+    std::vector<size_t> jumps;
+
+    for(const auto& arg : args) {
+        isConstant &= expression(arg);
+        jumps.push_back(size());
+        emit(Op::CondAppend, 0, arg.type == Expr::Literal ? 1 : 0);
+    }
+
+    emit(Op::CondEnd);
+
+    // Failed conditions skip straight past the end of the block
+    for(const size_t jump : jumps) {
+        m_program->m_instructions.at(jump).operand = static_cast<int>(size());
+    }
+
+    if(isConstant) {
+        fold(begin);
+    }
+    return isConstant;
+}
+
+void ScriptCompiler::fold(size_t begin)
+{
+    // Constant subexpressions never touch the track, so evaluate them now
+    ScriptResult result = m_evaluator.evaluateRange(*m_program, begin, size(), Track{});
+
+    m_program->m_instructions.resize(begin);
+    emit(Op::Constant, addConstant(std::move(result)));
+}
+
+void ScriptCompiler::emit(Op op, int operand, int count)
+{
+    m_program->m_instructions.push_back({.op = op, .operand = operand, .count = count});
+}
+
+int ScriptCompiler::addConstant(ScriptResult result)
+{
+    m_program->m_constants.push_back(std::move(result));
+    return static_cast<int>(m_program->m_constants.size() - 1);
+}
+
+int ScriptCompiler::addHandle(ScriptHandle handle)
+{
+    m_program->m_handles.push_back(std::move(handle));
+    return static_cast<int>(m_program->m_handles.size() - 1);
+}
+
+size_t ScriptCompiler::size() const
+{
+    return m_program->m_instructions.size();
+}
+
+ScriptProgram::ScriptProgram(const ScriptRegistry* registry, uint64_t owner)
+    : m_registry{registry}
+    , m_owner{owner}
+{ }
+
+std::shared_ptr<const ScriptProgram> ScriptProgram::compile(const ExpressionList& expressions,
+                                                            const ScriptRegistry* registry, uint64_t owner)
+{
+    if(!registry) {
+        return {};
+    }
+
+    auto program = std::make_shared<ScriptProgram>(registry, owner);
+
+    ScriptCompiler compiler{program.get()};
+    compiler.compile(expressions);
+
+    return program;
+}
+
+const ScriptRegistry* ScriptProgram::registry() const
+{
+    return m_registry;
+}
+
+uint64_t ScriptProgram::owner() const
+{
+    return m_owner;
+}
+
+const std::vector<ScriptProgram::Instruction>& ScriptProgram::instructions() const
+{
+    return m_instructions;
+}
+
+const ScriptResult& ScriptProgram::constant(int index) const
+{
+    return m_constants.at(index);
+}
+
+const ScriptHandle& ScriptProgram::handle(int index) const
+{
+    return m_handles.at(index);
+}
+
+QString ScriptEvaluator::evaluate(const ScriptProgram& program, const Track& track)
+{
+    m_stack.clear();
+    m_condDepth   = 0;
+    m_outputCount = 0;
+
+    run(program, 0, program.instructions().size(), track);
+
+    return takeOutput();
+}
+
+QString ScriptEvaluator::evaluate(const ScriptProgram& program, const TrackList& tracks)
+{
+    m_stack.clear();
+    m_condDepth   = 0;
+    m_outputCount = 0;
+
+    run(program, 0, program.instructions().size(), tracks);
+
+    return takeOutput();
+}
+
+ScriptResult ScriptEvaluator::evaluateRange(const ScriptProgram& program, size_t begin, size_t end,
+                                            const Track& track)
+{
+    m_stack.clear();
+    m_condDepth = 0;
+
+    run(program, begin, end, track);
+
+    if(m_stack.empty()) {
+        return {};
+    }
+
+    ScriptResult result = std::move(m_stack.back());
+    m_stack.clear();
+    return result;
+}
+
+void ScriptEvaluator::run(const ScriptProgram& program, size_t begin, size_t end, const auto& tracks)
+{
+    const auto& instructions       = program.instructions();
+    const ScriptRegistry* registry = program.registry();
+
+    size_t pc{begin};
+    while(pc < end) {
+        const auto& instruction = instructions[pc++];
+
+        switch(instruction.op) {
+            case(Op::Constant):
+                m_stack.push_back(program.constant(instruction.operand));
+                break;
+            case(Op::Variable): {
+                ScriptResult result = registry->value(program.handle(instruction.operand), tracks);
+                if(!result.cond) {
+                    m_stack.emplace_back();
+                    break;
+                }
+                if(result.value.contains(unitSeparator())) {
+                    result.value.replace(unitSeparator(), QStringLiteral(", "));
+                }
+                m_stack.push_back(std::move(result));
+                break;
+            }
+            case(Op::VariableList):
+                m_stack.push_back(registry->value(program.handle(instruction.operand), tracks));
+                break;
+            case(Op::Function): {
+                const auto argsBegin = m_stack.end() - instruction.count;
+                m_args.clear();
+                std::move(argsBegin, m_stack.end(), std::back_inserter(m_args));
+                m_stack.erase(argsBegin, m_stack.end());
+                m_stack.push_back(registry->function(program.handle(instruction.operand), m_args, tracks));
+                break;
+            }
+            case(Op::Concat):
+                concat(instruction.count);
+                break;
+            case(Op::CondBegin):
+                condBegin();
+                break;
+            case(Op::CondAppend): {
+                const ScriptResult value = std::move(m_stack.back());
+                m_stack.pop_back();
+
+                // Literals never cause a conditional to fail
+                if(instruction.count == 0 && (!value.cond || value.value.isEmpty())) {
+                    --m_condDepth;
+                    m_stack.emplace_back();
+                    pc = static_cast<size_t>(instruction.operand);
+                }
+                else {
+                    condAppend(value.value);
+                }
+                break;
+            }
+            case(Op::CondEnd):
+                condEnd();
+                break;
+            case(Op::Output):
+                output(m_stack.back().value);
+                m_stack.pop_back();
+                break;
+        }
+    }
+}
+
+void ScriptEvaluator::concat(int count)
+{
+    const auto argsBegin = m_stack.end() - count;
+
+    ScriptResult result;
+    bool allPassed{true};
+
+    for(auto argIt = argsBegin; argIt != m_stack.end(); ++argIt) {
+        if(!argIt->cond) {
+            allPassed = false;
+        }
+        if(argIt->value.contains(unitSeparator())) {
+            QStringList newResult;
+            const auto values = argIt->value.split(unitSeparator());
+            for(const QString& value : values) {
+                newResult.emplace_back(result.value + value);
+            }
+            result.value = newResult.join(unitSeparator());
+        }
+        else {
+            result.value += argIt->value;
+        }
+    }
+
+    result.cond = allPassed;
+
+    m_stack.erase(argsBegin, m_stack.end());
+    m_stack.push_back(std::move(result));
+}
+
+void ScriptEvaluator::condBegin()
+{
+    if(m_condDepth == m_conditionals.size()) {
+        m_conditionals.emplace_back();
+    }
+    m_conditionals[m_condDepth++].clear();
+}
+
+void ScriptEvaluator::condAppend(const QString& value)
+{
+    appendValue(m_conditionals[m_condDepth - 1], value);
+}
+
+void ScriptEvaluator::condEnd()
+{
+    const QStringList& results = m_conditionals[--m_condDepth];
+
+    ScriptResult result;
+    result.cond = true;
+
+    if(results.size() == 1) {
+        result.value = results.constFirst();
+    }
+    else if(results.size() > 1) {
+        result.value = results.join(unitSeparator());
+    }
+
+    m_stack.push_back(std::move(result));
+}
+
+void ScriptEvaluator::output(const QString& value)
+{
+    if(value.isNull()) {
+        return;
+    }
+
+    if(m_outputCount == 0 && !value.contains(unitSeparator())) {
+        m_buffer      = value;
+        m_outputCount = 1;
+        return;
+    }
+
+    if(m_outputCount == 1) {
+        if(!value.contains(unitSeparator())) {
+            m_buffer += value;
+            return;
+        }
+        m_output.clear();
+        m_output.append(std::exchange(m_buffer, {}));
+    }
+    else if(m_outputCount == 0) {
+        m_output.clear();
+    }
+
+    appendValue(m_output, value);
+    m_outputCount = static_cast<int>(m_output.size());
+}
+
+QString ScriptEvaluator::takeOutput()
+{
+    if(m_outputCount == 1) {
+        // Calling join on a QStringList with a single empty string will return a null QString, so return the first
+        // result.
+        return std::exchange(m_buffer, {});
+    }
+
+    if(m_outputCount > 1) {
+        return m_output.join(unitSeparator());
+    }
+
+    return {};
+}
+} // namespace Fooyin
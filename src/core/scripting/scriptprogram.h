@@ -0,0 +1,125 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <core/scripting/expression.h>
+#include <core/scripting/scriptregistry.h>
+
+#include <memory>
+
+namespace Fooyin {
+/*!
+ * A parsed script flattened into a list of stack-based instructions.
+ * Variables and functions are resolved against the registry once at compile time, and any subexpression which
+ * doesn't depend on the track being evaluated is folded into a constant.
+ * A program is immutable once compiled and is only valid for the registry it was compiled against.
+ */
+class ScriptProgram
+{
+public:
+    enum class Op : uint8_t
+    {
+        // Push constants[operand]
+        Constant = 0,
+        // Push the value of handles[operand], with list values joined by ", "
+        Variable,
+        // Push the value of handles[operand]
+        VariableList,
+        // Pop count arguments, push the result of calling handles[operand]
+        Function,
+        // Pop count values, push them concatenated as a function argument
+        Concat,
+        // Start a new conditional block
+        CondBegin,
+        // Pop a value into the current conditional, jumping to operand if it failed
+        // A count of 1 marks the value as a literal, which never fails
+        CondAppend,
+        // Finish the current conditional block and push its result
+        CondEnd,
+        // Pop a value into the output
+        Output,
+    };
+
+    struct Instruction
+    {
+        Op op;
+        int operand{0};
+        int count{0};
+    };
+
+    ScriptProgram(const ScriptRegistry* registry, uint64_t owner);
+
+    static std::shared_ptr<const ScriptProgram> compile(const ExpressionList& expressions,
+                                                        const ScriptRegistry* registry, uint64_t owner);
+
+    [[nodiscard]] const ScriptRegistry* registry() const;
+    /** Returns an id identifying the parser which compiled this program. */
+    [[nodiscard]] uint64_t owner() const;
+
+    [[nodiscard]] const std::vector<Instruction>& instructions() const;
+    [[nodiscard]] const ScriptResult& constant(int index) const;
+    [[nodiscard]] const ScriptHandle& handle(int index) const;
+
+private:
+    friend class ScriptCompiler;
+
+    const ScriptRegistry* m_registry;
+    uint64_t m_owner;
+
+    std::vector<Instruction> m_instructions;
+    std::vector<ScriptResult> m_constants;
+    std::vector<ScriptHandle> m_handles;
+};
+
+/*!
+ * Runs compiled programs.
+ * Stack and string buffers are kept between evaluations, so an evaluator should be reused where possible.
+ * Not thread-safe; use one evaluator per thread.
+ */
+class ScriptEvaluator
+{
+public:
+    QString evaluate(const ScriptProgram& program, const Track& track);
+    QString evaluate(const ScriptProgram& program, const TrackList& tracks);
+
+    /** Runs instructions [begin, end) of @p program, which must leave a single value on the stack. */
+    ScriptResult evaluateRange(const ScriptProgram& program, size_t begin, size_t end, const Track& track);
+
+private:
+    void run(const ScriptProgram& program, size_t begin, size_t end, const auto& tracks);
+
+    void concat(int count);
+    void condBegin();
+    void condAppend(const QString& value);
+    void condEnd();
+    void output(const QString& value);
+    QString takeOutput();
+
+    std::vector<ScriptResult> m_stack;
+    ScriptValueList m_args;
+    std::vector<QStringList> m_conditionals;
+    size_t m_condDepth{0};
+
+    // Holds the output while it is a single string, so it can be appended to in place
+    QString m_buffer;
+    QStringList m_output;
+    int m_outputCount{0};
+};
+} // namespace Fooyin
@@ -116,6 +116,40 @@ QString trackChannels(const Fooyin::Track& track)
     }
 }
 
+QStringList argValues(const Fooyin::ScriptValueList& args)
+{
+    QStringList values;
+    values.reserve(static_cast<qsizetype>(args.size()));
+    for(const auto& arg : args) {
+        values.emplace_back(arg.value);
+    }
+    return values;
+}
+
+Fooyin::ScriptResult callFunc(const Func& func, const Fooyin::ScriptValueList& args, const Fooyin::Track& track)
+{
+    if(const auto* nativeFunc = std::get_if<NativeFunc>(&func)) {
+        const QString value = (*nativeFunc)(argValues(args));
+        return {.value = value, .cond = !value.isEmpty()};
+    }
+    if(const auto* voidFunc = std::get_if<NativeVoidFunc>(&func)) {
+        const QString value = (*voidFunc)();
+        return {.value = value, .cond = !value.isEmpty()};
+    }
+    if(const auto* trackFunc = std::get_if<NativeTrackFunc>(&func)) {
+        const QString value = (*trackFunc)(track, argValues(args));
+        return {.value = value, .cond = !value.isEmpty()};
+    }
+    if(const auto* boolFunc = std::get_if<NativeBoolFunc>(&func)) {
+        return (*boolFunc)(argValues(args));
+    }
+    if(const auto* condFunc = std::get_if<NativeCondFunc>(&func)) {
+        return (*condFunc)(args);
+    }
+
+    return {};
+}
+
 QString formatDateTime(const uint64_t ms)
 {
     if(ms == 0) {
@@ -449,31 +483,16 @@ ScriptResult ScriptRegistry::value(const QString& var, const TrackList& tracks)
 
 ScriptResult ScriptRegistry::function(const QString& func, const ScriptValueList& args, const Track& track) const
 {
-    if(func.isEmpty() || !p->m_funcs.contains(func)) {
+    if(func.isEmpty()) {
         return {};
     }
 
-    const auto scriptFunc = p->m_funcs.at(func);
-    if(std::holds_alternative<NativeFunc>(scriptFunc)) {
-        const QString value = std::get<NativeFunc>(scriptFunc)(containerCast<QStringList>(args));
-        return {.value = value, .cond = !value.isEmpty()};
-    }
-    if(std::holds_alternative<NativeVoidFunc>(scriptFunc)) {
-        const QString value = std::get<NativeVoidFunc>(scriptFunc)();
-        return {.value = value, .cond = !value.isEmpty()};
-    }
-    if(std::holds_alternative<NativeTrackFunc>(scriptFunc)) {
-        const QString value = std::get<NativeTrackFunc>(scriptFunc)(track, containerCast<QStringList>(args));
-        return {.value = value, .cond = !value.isEmpty()};
-    }
-    if(std::holds_alternative<NativeBoolFunc>(scriptFunc)) {
-        return std::get<NativeBoolFunc>(scriptFunc)(containerCast<QStringList>(args));
-    }
-    if(std::holds_alternative<NativeCondFunc>(scriptFunc)) {
-        return std::get<NativeCondFunc>(scriptFunc)(args);
+    const auto funcIt = p->m_funcs.find(func);
+    if(funcIt == p->m_funcs.cend()) {
+        return {};
     }
 
-    return {};
+    return callFunc(funcIt->second, args, track);
 }
 
 ScriptResult ScriptRegistry::function(const QString& func, const ScriptValueList& args, const TrackList& tracks) const
@@ -500,6 +519,133 @@ void ScriptRegistry::setValue(const QString& var, const FuncRet& value, Track& t
     }
 }
 
+ScriptHandle ScriptRegistry::resolveVariable(const QString& var) const
+{
+    using Type = ScriptHandle::Type;
+
+    ScriptHandle handle;
+    handle.name = var;
+
+    if(var.isEmpty()) {
+        return handle;
+    }
+
+    if(const auto metaIt = p->m_metadata.find(var); metaIt != p->m_metadata.cend()) {
+        handle.type  = Type::Metadata;
+        handle.entry = &metaIt->second;
+    }
+    else if(const auto playbackIt = p->m_playbackVars.find(var); playbackIt != p->m_playbackVars.cend()) {
+        handle.type  = Type::PlaybackVar;
+        handle.entry = &playbackIt->second;
+    }
+    else if(const auto libraryIt = p->m_libraryVars.find(var); libraryIt != p->m_libraryVars.cend()) {
+        handle.type  = Type::LibraryVar;
+        handle.entry = &libraryIt->second;
+    }
+    else if(const auto listIt = p->m_listProperties.find(var); listIt != p->m_listProperties.cend()) {
+        handle.type  = Type::ListProperty;
+        handle.entry = &listIt->second;
+    }
+    else {
+        handle.type = Type::ExtraTag;
+        handle.tag  = var.toUpper();
+    }
+
+    return handle;
+}
+
+ScriptHandle ScriptRegistry::resolveFunction(const QString& func) const
+{
+    ScriptHandle handle;
+    handle.name = func;
+
+    if(const auto funcIt = p->m_funcs.find(func); funcIt != p->m_funcs.cend()) {
+        handle.type  = std::holds_alternative<NativeTrackFunc>(funcIt->second) ? ScriptHandle::Type::TrackFunction
+                                                                                : ScriptHandle::Type::Function;
+        handle.entry = &funcIt->second;
+    }
+
+    return handle;
+}
+
+ScriptResult ScriptRegistry::value(const ScriptHandle& var, const Track& track) const
+{
+    using Type = ScriptHandle::Type;
+
+    switch(var.type) {
+        case(Type::Metadata):
+            return calculateResult((*static_cast<const TrackFunc*>(var.entry))(track));
+        case(Type::PlaybackVar):
+            return calculateResult((*static_cast<const NativeVoidFunc*>(var.entry))());
+        case(Type::LibraryVar):
+            return calculateResult((*static_cast<const NativeTrackVoidFunc*>(var.entry))(track));
+        case(Type::ListProperty):
+            return calculateResult((*static_cast<const TrackListFunc*>(var.entry))({track}));
+        case(Type::ExtraTag):
+            if(!track.hasExtraTag(var.tag)) {
+                return {};
+            }
+            return calculateResult(track.extraTag(var.tag));
+        case(Type::Unresolved):
+        case(Type::Function):
+        case(Type::TrackFunction):
+            break;
+    }
+
+    return value(var.name, track);
+}
+
+ScriptResult ScriptRegistry::value(const ScriptHandle& var, const TrackList& tracks) const
+{
+    using Type = ScriptHandle::Type;
+
+    switch(var.type) {
+        case(Type::ListProperty):
+            return calculateResult((*static_cast<const TrackListFunc*>(var.entry))(tracks));
+        case(Type::Metadata):
+            if(tracks.empty()) {
+                return {};
+            }
+            return calculateResult((*static_cast<const TrackFunc*>(var.entry))(tracks.front()));
+        case(Type::ExtraTag):
+            if(tracks.empty() || !tracks.front().hasExtraTag(var.tag)) {
+                return {};
+            }
+            return calculateResult(tracks.front().extraTag(var.tag));
+        case(Type::PlaybackVar):
+        case(Type::LibraryVar):
+        case(Type::Unresolved):
+        case(Type::Function):
+        case(Type::TrackFunction):
+            break;
+    }
+
+    return value(var.name, tracks);
+}
+
+ScriptResult ScriptRegistry::function(const ScriptHandle& func, const ScriptValueList& args, const Track& track) const
+{
+    if(func.type == ScriptHandle::Type::Function || func.type == ScriptHandle::Type::TrackFunction) {
+        return callFunc(*static_cast<const Func*>(func.entry), args, track);
+    }
+
+    return function(func.name, args, track);
+}
+
+ScriptResult ScriptRegistry::function(const ScriptHandle& func, const ScriptValueList& args,
+                                      const TrackList& tracks) const
+{
+    if(func.type == ScriptHandle::Type::Unresolved) {
+        return function(func.name, args, tracks);
+    }
+
+    if(tracks.empty()) {
+        return {};
+    }
+
+    return function(func, args, tracks.front());
+}
+
 bool ScriptRegistry::isListVariable(const QString& var) const
 {
     return p->m_listProperties.contains(var);
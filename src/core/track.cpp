@@ -21,6 +21,7 @@
 #include <core/track.h>
 
 #include <utils/crypto.h>
+#include <utils/stringpool.h>
 #include <utils/utils.h>
 
 #include <QDir>
@@ -28,6 +29,9 @@
 #include <QIODevice>
 #include <QRegularExpression>
 
+#include <atomic>
+#include <mutex>
+
 constexpr auto MaxStarCount = 10;
 constexpr auto YearRegex    = R"lit(\b\d{4}\b)lit";
 
@@ -43,6 +47,77 @@ int extractYear(const QString& input)
 
     return 0;
 }
+
+// Low-cardinality fields shared between all tracks
+Fooyin::StringPool& trackStrings()
+{
+    static Fooyin::StringPool pool;
+    return pool;
+}
+
+std::mutex& hashMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+/*!
+ * A hash which is regenerated on first access after being invalidated, rather than on every change.
+ * Tracks are shared between threads, so regeneration from a const accessor is guarded by a mutex.
+ * The stored value is only written while dirty, so clean reads don't need to lock.
+ */
+class LazyHash
+{
+public:
+    LazyHash() = default;
+
+    LazyHash(const LazyHash& other)
+    {
+        if(other.m_dirty.load(std::memory_order_acquire)) {
+            const std::scoped_lock lock{hashMutex()};
+            m_hash = other.m_hash;
+            m_dirty.store(other.m_dirty.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        else {
+            m_hash = other.m_hash;
+        }
+    }
+
+    LazyHash& operator=(const LazyHash& other) = delete;
+
+    template <typename Generator>
+    QString value(Generator generate) const
+    {
+        if(!m_dirty.load(std::memory_order_acquire)) {
+            return m_hash;
+        }
+
+        const std::scoped_lock lock{hashMutex()};
+        if(m_dirty.load(std::memory_order_relaxed)) {
+            m_hash = generate();
+            m_dirty.store(false, std::memory_order_release);
+        }
+        return m_hash;
+    }
+
+    void set(const QString& hash)
+    {
+        m_hash = hash;
+        m_dirty.store(false, std::memory_order_relaxed);
+    }
+
+    void invalidate()
+    {
+        // Hashes are only kept up to date once generated
+        if(!m_hash.isEmpty()) {
+            m_dirty.store(true, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    mutable QString m_hash;
+    mutable std::atomic<bool> m_dirty{false};
+};
 } // namespace
 
 namespace Fooyin {
@@ -52,7 +127,7 @@ public:
     int libraryId{-1};
     bool enabled{true};
     int id{-1};
-    QString hash;
+    LazyHash hash;
     QString codec;
     QString filepath;
     QString directory;
@@ -104,6 +179,17 @@ public:
     QString archivePath;
     QString filepathWithinArchive;
 
+    [[nodiscard]] QString generateHash() const
+    {
+        QString hashTitle = title;
+        if(hashTitle.isEmpty()) {
+            hashTitle = directory + filename;
+        }
+
+        return Utils::generateHash(artists.join(QStringLiteral(",")), album, discNumber, trackNumber, hashTitle,
+                                   QString::number(subsong));
+    }
+
     void splitArchiveUrl()
     {
         QString path = filepath.mid(filepath.indexOf(u"://") + 3);
@@ -121,7 +207,7 @@ public:
 
         const QFileInfo info{filepathWithinArchive};
         filename  = info.completeBaseName();
-        extension = info.suffix().toLower();
+        extension = trackStrings().intern(info.suffix().toLower());
         directory = info.dir().dirName();
         if(directory == u".") {
             directory = QFileInfo{archivePath}.fileName();
@@ -166,14 +252,9 @@ bool Track::operator<(const Track& other) const
 
 QString Track::generateHash()
 {
-    QString title = p->title;
-    if(title.isEmpty()) {
-        title = p->directory + p->filename;
-    }
-
-    p->hash = Utils::generateHash(p->artists.join(QStringLiteral(",")), p->album, p->discNumber, p->trackNumber, title,
-                                  QString::number(p->subsong));
-    return p->hash;
+    const QString hash = p->generateHash();
+    p->hash.set(hash);
+    return hash;
 }
 
 bool Track::isValid() const
@@ -252,7 +333,7 @@ int Track::id() const
 
 QString Track::hash() const
 {
-    return p->hash;
+    return p->hash.value([this]() { return p->generateHash(); });
 }
 
 QString Track::albumHash() const
@@ -643,12 +724,12 @@ void Track::setId(int id)
 
 void Track::setHash(const QString& hash)
 {
-    p->hash = hash;
+    p->hash.set(hash);
 }
 
 void Track::setCodec(const QString& codec)
 {
-    p->codec = codec;
+    p->codec = trackStrings().intern(codec);
 }
 
 void Track::setFilePath(const QString& path)
@@ -667,7 +748,7 @@ void Track::setFilePath(const QString& path)
         p->isInArchive = false;
         const QFileInfo info{p->filepath};
         p->filename  = info.completeBaseName();
-        p->extension = info.suffix().toLower();
+        p->extension = trackStrings().intern(info.suffix().toLower());
         p->directory = info.dir().dirName();
     }
 }
@@ -676,9 +757,7 @@ void Track::setTitle(const QString& title)
 {
     p->title = title;
 
-    if(!p->hash.isEmpty()) {
-        generateHash();
-    }
+    p->hash.invalidate();
 }
 
 void Track::setArtists(const QStringList& artists)
@@ -690,18 +769,14 @@ void Track::setArtists(const QStringList& artists)
         p->artists = artists;
     }
 
-    if(!p->hash.isEmpty()) {
-        generateHash();
-    }
+    p->hash.invalidate();
 }
 
 void Track::setAlbum(const QString& title)
 {
     p->album = title;
 
-    if(!p->hash.isEmpty()) {
-        generateHash();
-    }
+    p->hash.invalidate();
 }
 
 void Track::setAlbumArtists(const QStringList& artists)
@@ -719,24 +794,22 @@ void Track::setTrackNumber(const QString& number)
     if(number.contains(u'/')) {
         const auto& parts = number.split(u'/', Qt::SkipEmptyParts);
         if(!parts.empty()) {
-            p->trackNumber = parts.at(0);
+            p->trackNumber = trackStrings().intern(parts.at(0));
             if(parts.size() > 1) {
-                p->trackTotal = parts.at(1);
+                p->trackTotal = trackStrings().intern(parts.at(1));
             }
         }
     }
     else {
-        p->trackNumber = number;
+        p->trackNumber = trackStrings().intern(number);
     }
 
-    if(!p->hash.isEmpty()) {
-        generateHash();
-    }
+    p->hash.invalidate();
 }
 
 void Track::setTrackTotal(const QString& total)
 {
-    p->trackTotal = total;
+    p->trackTotal = trackStrings().intern(total);
 }
 
 void Track::setDiscNumber(const QString& number)
@@ -744,24 +817,22 @@ void Track::setDiscNumber(const QString& number)
     if(number.contains(u'/')) {
         const auto& parts = number.split(u'/', Qt::SkipEmptyParts);
         if(!parts.empty()) {
-            p->discNumber = parts.at(0);
+            p->discNumber = trackStrings().intern(parts.at(0));
             if(parts.size() > 1) {
-                p->discTotal = parts.at(1);
+                p->discTotal = trackStrings().intern(parts.at(1));
             }
         }
     }
     else {
-        p->discNumber = number;
+        p->discNumber = trackStrings().intern(number);
     }
 
-    if(!p->hash.isEmpty()) {
-        generateHash();
-    }
+    p->hash.invalidate();
 }
 
 void Track::setDiscTotal(const QString& total)
 {
-    p->discTotal = total;
+    p->discTotal = trackStrings().intern(total);
 }
 
 void Track::setGenres(const QStringList& genres)
@@ -770,7 +841,7 @@ void Track::setGenres(const QStringList& genres)
         p->genres.clear();
     }
     else {
-        p->genres = genres;
+        p->genres = trackStrings().intern(genres);
     }
 }
 
@@ -1056,6 +1127,11 @@ void Track::clearWasModified()
     p->metadataWasModified = false;
 }
 
+void Track::pruneSharedStrings()
+{
+    trackStrings().prune();
+}
+
 QString Track::findCommonField(const TrackList& tracks)
 {
     QString name;
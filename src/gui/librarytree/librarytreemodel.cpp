@@ -83,7 +83,9 @@ namespace Fooyin {
 LibraryTreeSortModel::LibraryTreeSortModel(QObject* parent)
     : QSortFilterProxyModel{parent}
 {
-    m_collator.setNumericMode(true);
+    // Only keep keys for a single sort, so strings from removed or renamed items don't build up
+    QObject::connect(this, &QAbstractItemModel::layoutAboutToBeChanged, this, [this]() { m_sortKeys.clear(); });
+    QObject::connect(this, &QAbstractItemModel::modelAboutToBeReset, this, [this]() { m_sortKeys.clear(); });
 }
 
 bool LibraryTreeSortModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
@@ -103,7 +105,7 @@ bool LibraryTreeSortModel::lessThan(const QModelIndex& left, const QModelIndex&
         return sortOrder() != Qt::AscendingOrder;
     }
 
-    const auto cmp = m_collator.compare(leftItem->title(), rightItem->title());
+    const auto cmp = m_sortKeys.compare(leftItem->title(), rightItem->title());
 
     if(cmp == 0) {
         return false;
@@ -23,9 +23,9 @@
 #include "librarytreeitem.h"
 
 #include <core/player/playerdefs.h>
+#include <utils/sortkeycache.h>
 #include <utils/treemodel.h>
 
-#include <QCollator>
 #include <QSortFilterProxyModel>
 
 namespace Fooyin {
@@ -43,7 +43,7 @@ protected:
     [[nodiscard]] bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
 
 private:
-    QCollator m_collator;
+    mutable SortKeyCache m_sortKeys;
 };
 
 class LibraryTreeModel : public TreeModel<LibraryTreeItem>
@@ -146,4 +146,14 @@ ScriptResult PlaylistScriptRegistry::value(const QString& var, const Track& trac
 
     return ScriptRegistry::value(var, track);
 }
+
+ScriptHandle PlaylistScriptRegistry::resolveVariable(const QString& var) const
+{
+    // Evaluated by our override of value
+    if(isListVariable(var) || p->m_vars.contains(var)) {
+        return {.name = var};
+    }
+
+    return ScriptRegistry::resolveVariable(var);
+}
 } // namespace Fooyin
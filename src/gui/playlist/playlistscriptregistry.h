@@ -46,6 +46,7 @@ public:
 
     [[nodiscard]] bool isVariable(const QString& var, const Track& track) const override;
     [[nodiscard]] ScriptResult value(const QString& var, const Track& track) const override;
+    [[nodiscard]] ScriptHandle resolveVariable(const QString& var) const override;
 
 private:
     std::unique_ptr<PlaylistScriptRegistryPrivate> p;
@@ -40,6 +40,7 @@
 #include <QLabel>
 #include <QMenu>
 #include <QPushButton>
+#include <QSpinBox>
 
 namespace Fooyin {
 class LibraryTableView : public ExtendableTableView
@@ -104,6 +105,8 @@ private:
     QLineEdit* m_restrictTypes;
     QLineEdit* m_excludeTypes;
 
+    QSpinBox* m_scanThreads;
+
     QCheckBox* m_autoRefresh;
     QCheckBox* m_monitorLibraries;
     QCheckBox* m_markUnavailable;
@@ -121,6 +124,7 @@ LibraryGeneralPageWidget::LibraryGeneralPageWidget(ActionManager* actionManager,
     , m_model{new LibraryModel(m_libraryManager, this)}
     , m_restrictTypes{new QLineEdit(this)}
     , m_excludeTypes{new QLineEdit(this)}
+    , m_scanThreads{new QSpinBox(this)}
     , m_autoRefresh{new QCheckBox(tr("Auto refresh on startup"), this)}
     , m_monitorLibraries{new QCheckBox(tr("Monitor libraries"), this)}
     , m_markUnavailable{new QCheckBox(tr("Mark unavailable tracks on playback"), this)}
@@ -156,11 +160,27 @@ LibraryGeneralPageWidget::LibraryGeneralPageWidget(ActionManager* actionManager,
     fileTypesLayout->addWidget(fileHint, row++, 1);
     fileTypesLayout->setColumnStretch(1, 1);
 
+    auto* scanningGroup  = new QGroupBox(tr("Scanning"), this);
+    auto* scanningLayout = new QGridLayout(scanningGroup);
+
+    auto* scanThreadsLabel = new QLabel(tr("Tag reader threads") + u":", this);
+
+    m_scanThreads->setMinimum(0);
+    m_scanThreads->setMaximum(32);
+    m_scanThreads->setSpecialValueText(tr("Auto"));
+    m_scanThreads->setToolTip(tr("Number of files to read concurrently when scanning libraries"));
+
+    row = 0;
+    scanningLayout->addWidget(scanThreadsLabel, row, 0);
+    scanningLayout->addWidget(m_scanThreads, row++, 1);
+    scanningLayout->setColumnStretch(2, 1);
+
     auto* mainLayout = new QGridLayout(this);
 
     row = 0;
     mainLayout->addWidget(m_libraryView, row++, 0, 1, 2);
     mainLayout->addWidget(fileTypesGroup, row++, 0, 1, 2);
+    mainLayout->addWidget(scanningGroup, row++, 0, 1, 2);
     mainLayout->addWidget(m_autoRefresh, row++, 0, 1, 2);
     mainLayout->addWidget(m_monitorLibraries, row++, 0, 1, 2);
     mainLayout->addWidget(m_markUnavailable, row++, 0, 1, 2);
@@ -188,6 +208,7 @@ void LibraryGeneralPageWidget::load()
 
     m_restrictTypes->setText(restrictExtensions.join(u';'));
     m_excludeTypes->setText(excludeExtensions.join(u';'));
+    m_scanThreads->setValue(m_settings->fileValue(Settings::Core::Internal::LibraryScanThreads, 0).toInt());
 
     m_autoRefresh->setChecked(m_settings->value<Settings::Core::AutoRefresh>());
     m_monitorLibraries->setChecked(m_settings->value<Settings::Core::Internal::MonitorLibraries>());
@@ -206,6 +227,7 @@ void LibraryGeneralPageWidget::apply()
                         m_restrictTypes->text().split(u';', Qt::SkipEmptyParts));
     m_settings->fileSet(Settings::Core::Internal::LibraryExcludeTypes,
                         m_excludeTypes->text().split(u';', Qt::SkipEmptyParts));
+    m_settings->fileSet(Settings::Core::Internal::LibraryScanThreads, m_scanThreads->value());
 
     m_settings->set<Settings::Core::AutoRefresh>(m_autoRefresh->isChecked());
     m_settings->set<Settings::Core::Internal::MonitorLibraries>(m_monitorLibraries->isChecked());
@@ -219,6 +241,7 @@ void LibraryGeneralPageWidget::reset()
 {
     m_settings->fileRemove(Settings::Core::Internal::LibraryRestrictTypes);
     m_settings->fileRemove(Settings::Core::Internal::LibraryExcludeTypes);
+    m_settings->fileRemove(Settings::Core::Internal::LibraryScanThreads);
 
     m_settings->reset<Settings::Core::AutoRefresh>();
     m_settings->reset<Settings::Core::Internal::MonitorLibraries>();
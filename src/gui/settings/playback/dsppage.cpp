@@ -0,0 +1,174 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dsppage.h"
+
+#include "core/engine/dsp/equaliser.h"
+
+#include <core/coresettings.h>
+#include <core/engine/enginecontroller.h>
+#include <gui/guiconstants.h>
+#include <utils/settings/settingsmanager.h>
+
+#include <QDoubleSpinBox>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QLabel>
+#include <QListWidget>
+
+#include <algorithm>
+#include <array>
+
+namespace Fooyin {
+class DspPageWidget : public SettingsPageWidget
+{
+    Q_OBJECT
+
+public:
+    explicit DspPageWidget(EngineController* engine, SettingsManager* settings);
+
+    void load() override;
+    void apply() override;
+    void reset() override;
+
+private:
+    void addDsp(const QString& name, bool enabled);
+
+    EngineController* m_engine;
+    SettingsManager* m_settings;
+
+    QListWidget* m_dspList;
+    std::array<QDoubleSpinBox*, Equaliser::BandCount> m_eqGains;
+};
+
+DspPageWidget::DspPageWidget(EngineController* engine, SettingsManager* settings)
+    : m_engine{engine}
+    , m_settings{settings}
+    , m_dspList{new QListWidget(this)}
+    , m_eqGains{}
+{
+    auto* dspLabel = new QLabel(tr("Processors are applied from top to bottom. Drag to reorder."), this);
+    dspLabel->setWordWrap(true);
+
+    m_dspList->setDragDropMode(QAbstractItemView::InternalMove);
+    m_dspList->setDefaultDropAction(Qt::MoveAction);
+    m_dspList->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_dspList->setSelectionMode(QAbstractItemView::SingleSelection);
+
+    auto* eqGroup  = new QGroupBox(tr("Equaliser"), this);
+    auto* eqLayout = new QGridLayout(eqGroup);
+
+    for(size_t i{0}; i < Equaliser::BandCount; ++i) {
+        const double frequency = Equaliser::Frequencies.at(i);
+        const QString label
+            = frequency >= 1000.0 ? tr("%1 kHz").arg(frequency / 1000.0) : tr("%1 Hz").arg(frequency);
+
+        auto* gain = new QDoubleSpinBox(this);
+        gain->setRange(-Equaliser::MaxGain, Equaliser::MaxGain);
+        gain->setSingleStep(0.5);
+        gain->setDecimals(1);
+        gain->setSuffix(QStringLiteral(" dB"));
+        m_eqGains.at(i) = gain;
+
+        const auto column = static_cast<int>(i);
+        eqLayout->addWidget(new QLabel(label, this), 0, column, Qt::AlignHCenter);
+        eqLayout->addWidget(gain, 1, column);
+    }
+
+    auto* layout = new QGridLayout(this);
+    layout->addWidget(dspLabel, 0, 0);
+    layout->addWidget(m_dspList, 1, 0);
+    layout->addWidget(eqGroup, 2, 0);
+
+    layout->setRowStretch(1, 1);
+}
+
+void DspPageWidget::load()
+{
+    m_dspList->clear();
+
+    // Enabled DSPs first, in the order they're applied
+    const QStringList chain = m_settings->value<Settings::Core::DspChain>();
+    const auto dsps         = m_engine->getAllDsps();
+
+    for(const QString& name : chain) {
+        if(std::ranges::find(dsps, name) != dsps.cend()) {
+            addDsp(name, true);
+        }
+    }
+    for(const QString& name : dsps) {
+        if(!chain.contains(name)) {
+            addDsp(name, false);
+        }
+    }
+
+    const QVariantList gains = m_settings->value<Settings::Core::EqualiserGains>().toList();
+    for(size_t i{0}; i < Equaliser::BandCount; ++i) {
+        const auto index = static_cast<qsizetype>(i);
+        m_eqGains.at(i)->setValue(index < gains.size() ? gains.at(index).toDouble() : 0.0);
+    }
+}
+
+void DspPageWidget::apply()
+{
+    QStringList chain;
+
+    const int count = m_dspList->count();
+    for(int i{0}; i < count; ++i) {
+        const auto* item = m_dspList->item(i);
+        if(item->checkState() == Qt::Checked) {
+            chain.append(item->text());
+        }
+    }
+
+    m_settings->set<Settings::Core::DspChain>(chain);
+
+    QVariantList gains;
+    for(const auto* gain : m_eqGains) {
+        gains.append(gain->value());
+    }
+    m_settings->set<Settings::Core::EqualiserGains>(gains);
+}
+
+void DspPageWidget::reset()
+{
+    m_settings->reset<Settings::Core::DspChain>();
+    m_settings->reset<Settings::Core::EqualiserGains>();
+}
+
+void DspPageWidget::addDsp(const QString& name, bool enabled)
+{
+    auto* item = new QListWidgetItem(name, m_dspList);
+    item->setFlags(item->flags() | Qt::ItemIsUserCheckable | Qt::ItemIsDragEnabled);
+    item->setFlags(item->flags() & ~Qt::ItemIsDropEnabled);
+    item->setCheckState(enabled ? Qt::Checked : Qt::Unchecked);
+}
+
+DspPage::DspPage(EngineController* engine, SettingsManager* settings, QObject* parent)
+    : SettingsPage{settings->settingsDialog(), parent}
+{
+    setId(Constants::Page::Dsp);
+    setName(tr("DSP"));
+    setCategory({tr("Playback"), tr("DSP")});
+    setWidgetCreator([engine, settings] { return new DspPageWidget(engine, settings); });
+}
+} // namespace Fooyin
+
+#include "dsppage.moc"
+#include "moc_dsppage.cpp"
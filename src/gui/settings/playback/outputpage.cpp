@@ -28,6 +28,7 @@
 
 #include <QCheckBox>
 #include <QComboBox>
+#include <QDoubleSpinBox>
 #include <QGridLayout>
 #include <QGroupBox>
 #include <QLabel>
@@ -64,6 +65,10 @@ private:
     QSpinBox* m_fadingStopOut;
     // QSpinBox* m_fadingSeekIn;
     // QSpinBox* m_fadingSeekOut;
+
+    QComboBox* m_replayGainMode;
+    QDoubleSpinBox* m_replayGainPreAmp;
+    QCheckBox* m_replayGainNoClipping;
 };
 
 OutputPageWidget::OutputPageWidget(EngineController* engine, SettingsManager* settings)
@@ -76,6 +81,9 @@ OutputPageWidget::OutputPageWidget(EngineController* engine, SettingsManager* se
     , m_fadingBox{new QGroupBox(tr("Fading"), this)}
     , m_fadingStopIn{new QSpinBox(this)}
     , m_fadingStopOut{new QSpinBox(this)}
+    , m_replayGainMode{new QComboBox(this)}
+    , m_replayGainPreAmp{new QDoubleSpinBox(this)}
+    , m_replayGainNoClipping{new QCheckBox(tr("Prevent clipping according to peak"), this)}
 // , m_fadingSeekIn{new QSpinBox(this)}
 // , m_fadingSeekOut{new QSpinBox(this)}
 {
@@ -135,6 +143,32 @@ OutputPageWidget::OutputPageWidget(EngineController* engine, SettingsManager* se
     // fadingLayout->addWidget(m_fadingSeekOut, 2, 2);
     fadingLayout->setColumnStretch(3, 1);
 
+    auto* replayGainBox    = new QGroupBox(tr("ReplayGain"), this);
+    auto* replayGainLayout = new QGridLayout(replayGainBox);
+
+    auto* modeLabel   = new QLabel(tr("Mode") + QStringLiteral(":"), this);
+    auto* preAmpLabel = new QLabel(tr("Pre-amplification") + QStringLiteral(":"), this);
+
+    // Ordered as ReplayGain::Mode
+    m_replayGainMode->addItem(tr("Disabled"));
+    m_replayGainMode->addItem(tr("Track gain"));
+    m_replayGainMode->addItem(tr("Album gain"));
+
+    m_replayGainPreAmp->setSuffix(QStringLiteral(" dB"));
+    m_replayGainPreAmp->setDecimals(1);
+    m_replayGainPreAmp->setSingleStep(0.5);
+    m_replayGainPreAmp->setMinimum(-20.0);
+    m_replayGainPreAmp->setMaximum(20.0);
+
+    m_replayGainNoClipping->setToolTip(tr("Reduce the applied gain if it would cause the track's peak to clip"));
+
+    replayGainLayout->addWidget(modeLabel, 0, 0);
+    replayGainLayout->addWidget(m_replayGainMode, 0, 1);
+    replayGainLayout->addWidget(preAmpLabel, 1, 0);
+    replayGainLayout->addWidget(m_replayGainPreAmp, 1, 1);
+    replayGainLayout->addWidget(m_replayGainNoClipping, 2, 0, 1, 3);
+    replayGainLayout->setColumnStretch(2, 1);
+
     auto* mainLayout = new QGridLayout(this);
     mainLayout->addWidget(outputLabel, 0, 0);
     mainLayout->addWidget(m_outputBox, 0, 1);
@@ -142,6 +176,7 @@ OutputPageWidget::OutputPageWidget(EngineController* engine, SettingsManager* se
     mainLayout->addWidget(m_deviceBox, 1, 1);
     mainLayout->addWidget(generalBox, 2, 0, 1, 2);
     mainLayout->addWidget(m_fadingBox, 3, 0, 1, 2);
+    mainLayout->addWidget(replayGainBox, 4, 0, 1, 2);
 
     mainLayout->setColumnStretch(1, 1);
     mainLayout->setRowStretch(mainLayout->rowCount(), 1);
@@ -170,6 +205,10 @@ void OutputPageWidget::load()
     m_fadingStopOut->setValue(fadingValues.outPauseStop);
     // m_fadingSeekIn->setValue(fadingValues.inSeek);
     // m_fadingSeekOut->setValue(fadingValues.outSeek);
+
+    m_replayGainMode->setCurrentIndex(m_settings->value<Settings::Core::ReplayGainMode>());
+    m_replayGainPreAmp->setValue(m_settings->value<Settings::Core::ReplayGainPreAmp>());
+    m_replayGainNoClipping->setChecked(m_settings->value<Settings::Core::ReplayGainNoClipping>());
 }
 
 void OutputPageWidget::apply()
@@ -187,6 +226,10 @@ void OutputPageWidget::apply()
 
     m_settings->set<Settings::Core::Internal::EngineFading>(m_fadingBox->isChecked());
     m_settings->set<Settings::Core::Internal::FadingIntervals>(QVariant::fromValue(fadingValues));
+
+    m_settings->set<Settings::Core::ReplayGainMode>(m_replayGainMode->currentIndex());
+    m_settings->set<Settings::Core::ReplayGainPreAmp>(m_replayGainPreAmp->value());
+    m_settings->set<Settings::Core::ReplayGainNoClipping>(m_replayGainNoClipping->isChecked());
 }
 
 void OutputPageWidget::reset()
@@ -196,6 +239,9 @@ void OutputPageWidget::reset()
     m_settings->reset<Settings::Core::BufferLength>();
     m_settings->reset<Settings::Core::Internal::EngineFading>();
     m_settings->reset<Settings::Core::Internal::FadingIntervals>();
+    m_settings->reset<Settings::Core::ReplayGainMode>();
+    m_settings->reset<Settings::Core::ReplayGainPreAmp>();
+    m_settings->reset<Settings::Core::ReplayGainNoClipping>();
 }
 
 void OutputPageWidget::setupOutputs()
@@ -46,6 +46,7 @@
 #include "settings/librarytree/librarytreegrouppage.h"
 #include "settings/librarytree/librarytreepage.h"
 #include "settings/playback/decoderpage.h"
+#include "settings/playback/dsppage.h"
 #include "settings/playback/outputpage.h"
 #include "settings/playback/playbackpage.h"
 #include "settings/playlist/playlistcolumnpage.h"
@@ -253,6 +254,7 @@ void Widgets::registerPages()
     new ShortcutsPage(m_gui.actionManager, m_settings, this);
     new OutputPage(m_core->engine(), m_settings, this);
     new DecoderPage(m_core->audioLoader().get(), m_settings, this);
+    new DspPage(m_core->engine(), m_settings, this);
     new DirBrowserPage(m_settings, this);
     new LibraryTreePage(m_settings, this);
     new LibraryTreeGroupPage(m_gui.actionManager, m_libraryTreeController->groupRegistry(), m_settings, this);
@@ -301,6 +303,9 @@ void Widgets::showScanProgress(const ScanProgress& progress) const
     }
 
     scanText += QStringLiteral(": %1%").arg(progress.percentage());
+    if(progress.rowsPerSecond > 0) {
+        scanText += QStringLiteral(" (%1)").arg(tr("%1 tracks/s").arg(progress.rowsPerSecond));
+    }
     m_statusWidget->showTempMessage(scanText);
 }
 } // namespace Fooyin
@@ -154,7 +154,6 @@ AlsaOutput::AlsaOutput()
     , m_pausable{true}
     , m_started{false}
     , m_device{QStringLiteral("default")}
-    , m_volume{1.0}
     , m_bufferSize{8192}
     , m_periodSize{1024}
 { }
@@ -245,11 +244,8 @@ int AlsaOutput::write(const AudioBuffer& buffer)
 
     const int frameCount = buffer.frameCount();
 
-    AudioBuffer adjustedBuff{buffer};
-    adjustedBuff.scale(m_volume);
-
     snd_pcm_sframes_t err{0};
-    err = snd_pcm_writei(m_pcmHandle.get(), adjustedBuff.constData().data(), frameCount);
+    err = snd_pcm_writei(m_pcmHandle.get(), buffer.constData().data(), frameCount);
     if(checkError(static_cast<int>(err), "Write error")) {
         return 0;
     }
@@ -278,11 +274,6 @@ void AlsaOutput::setPaused(bool pause)
     }
 }
 
-void AlsaOutput::setVolume(double volume)
-{
-    m_volume = volume;
-}
-
 void AlsaOutput::setDevice(const QString& device)
 {
     if(!device.isEmpty()) {
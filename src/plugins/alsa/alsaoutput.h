@@ -56,7 +56,6 @@ public:
 
     int write(const AudioBuffer& buffer) override;
     void setPaused(bool pause) override;
-    void setVolume(double volume) override;
     void setDevice(const QString& device) override;
 
     [[nodiscard]] QString error() const override;
@@ -80,7 +79,6 @@ private:
     bool m_started;
 
     QString m_device;
-    double m_volume;
     QString m_error;
 
     PcmHandleUPtr m_pcmHandle;
@@ -74,7 +74,9 @@ namespace Fooyin::Filters {
 FilterSortModel::FilterSortModel(QObject* parent)
     : QSortFilterProxyModel{parent}
 {
-    m_collator.setNumericMode(true);
+    // Only keep keys for a single sort, so strings from removed or renamed items don't build up
+    QObject::connect(this, &QAbstractItemModel::layoutAboutToBeChanged, this, [this]() { m_sortKeys.clear(); });
+    QObject::connect(this, &QAbstractItemModel::modelAboutToBeReset, this, [this]() { m_sortKeys.clear(); });
 }
 
 bool FilterSortModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
@@ -93,7 +95,7 @@ bool FilterSortModel::lessThan(const QModelIndex& left, const QModelIndex& right
         return sortOrder() != Qt::AscendingOrder;
     }
 
-    const auto cmp = m_collator.compare(leftItem->column(left.column()), rightItem->column(right.column()));
+    const auto cmp = m_sortKeys.compare(leftItem->column(left.column()), rightItem->column(right.column()));
 
     if(cmp == 0) {
         return false;
@@ -19,7 +19,6 @@
 
 #include "libarchiveinput.h"
 
-#include <QBuffer>
 #include <QDir>
 #include <QFileInfo>
 #include <QLoggingCategory>
@@ -27,9 +26,14 @@
 
 #include <archive_entry.h>
 
+#include <cstring>
+
 Q_LOGGING_CATEGORY(LIBARCH, "fy.libarchive")
 
 namespace {
+// Amount of decompressed data kept around for short backwards seeks
+constexpr qint64 WindowSize = 4LL * 1024 * 1024;
+
 QStringList fileExtensions()
 {
     static const QStringList extensions = {QStringLiteral("zip"), QStringLiteral("rar"), QStringLiteral("tar"),
@@ -58,16 +62,54 @@ bool setupForReading(archive* archive, const QString& filename)
 
     return true;
 }
+
+Fooyin::LibArchive::ArchivePtr openEntry(const QString& filename, const QString& file, archive_entry** entry)
+{
+    Fooyin::LibArchive::ArchivePtr archive{archive_read_new()};
+
+    if(!setupForReading(archive.get(), filename)) {
+        return nullptr;
+    }
+
+    while(archive_read_next_header(archive.get(), entry) == ARCHIVE_OK) {
+        if(archive_read_has_encrypted_entries(archive.get()) == 1) {
+            qCInfo(LIBARCH) << "Unable to read encrypted file" << filename;
+            return nullptr;
+        }
+
+        if(archive_entry_filetype(*entry) == AE_IFREG) {
+            const QString entryPath = QDir::fromNativeSeparators(QFile::decodeName(archive_entry_pathname(*entry)));
+            if(entryPath == file) {
+                return archive;
+            }
+        }
+    }
+
+    qCDebug(LIBARCH) << "Unable to find" << file << "in" << filename;
+    return nullptr;
+}
+
+Fooyin::LibArchive::LibArchiveIODevice::ReopenFunc reopenFunc(const QString& filename, const QString& file)
+{
+    return [filename, file](archive_entry** entry) {
+        return openEntry(filename, file, entry);
+    };
+}
 } // namespace
 
 namespace Fooyin::LibArchive {
-LibArchiveIODevice::LibArchiveIODevice(ArchivePtr archive, archive_entry* entry, QObject* parent)
+LibArchiveIODevice::LibArchiveIODevice(ArchivePtr archive, archive_entry* entry, ReopenFunc reopen, QObject* parent)
     : QIODevice{parent}
     , m_archive{std::move(archive)}
-    , m_entry{entry}
+    , m_reopen{std::move(reopen)}
+    , m_size{archive_entry_size(entry)}
+    // Small entries (covers, tags) don't need the full window
+    , m_windowSize{m_size > 0 ? std::min(m_size, WindowSize) : WindowSize}
+    , m_windowStart{0}
+    , m_streamPos{0}
 {
-    open(QIODevice::ReadOnly);
-    m_buffer.open(QBuffer::ReadWrite);
+    // Data is already held in the window, so skip QIODevice's own buffer
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
 }
 
 LibArchiveIODevice::~LibArchiveIODevice()
@@ -77,42 +119,21 @@ LibArchiveIODevice::~LibArchiveIODevice()
 
 bool LibArchiveIODevice::seek(qint64 pos)
 {
-    if(!isOpen()) {
+    if(!isOpen() || pos < 0 || (m_size >= 0 && pos > m_size)) {
         return false;
     }
 
-    QIODevice::seek(pos);
-
-    if(pos <= m_buffer.size()) {
-        return m_buffer.seek(pos);
-    }
-
-    qint64 bufferLen = pos - m_buffer.size();
-    std::vector<char> tmpBuffer(1024);
-
-    while(bufferLen > 0) {
-        qint64 lenToRead = std::min(static_cast<qint64>(tmpBuffer.size()), bufferLen);
-
-        lenToRead = archive_read_data(m_archive.get(), tmpBuffer.data(), static_cast<size_t>(lenToRead));
-        if(lenToRead > 0) {
-            m_buffer.buffer().append(tmpBuffer.data(), static_cast<qsizetype>(lenToRead));
-            bufferLen -= lenToRead;
-            continue;
-        }
-        if(lenToRead < 0) {
-            qCWarning(LIBARCH) << "Seeking failed:" << archive_error_string(m_archive.get());
-            setErrorString(QString::fromLocal8Bit(archive_error_string(m_archive.get())));
-            close();
-        }
+    // Forward seeks are resolved lazily by the next read
+    if(pos < m_windowStart && !rewind(pos)) {
         return false;
     }
 
-    return m_buffer.seek(pos);
+    return QIODevice::seek(pos);
 }
 
 qint64 LibArchiveIODevice::size() const
 {
-    return archive_entry_size(m_entry);
+    return m_size;
 }
 
 archive* LibArchiveIODevice::releaseArchive()
@@ -122,26 +143,37 @@ archive* LibArchiveIODevice::releaseArchive()
 
 qint64 LibArchiveIODevice::readData(char* data, qint64 maxlen)
 {
-    if(!isOpen()) {
+    if(!isOpen() || !m_archive) {
         return -1;
     }
 
-    if(m_buffer.pos() + maxlen > m_buffer.size()) {
-        const qint64 lenToRead = m_buffer.pos() + maxlen - m_buffer.size();
-        std::vector<char> tmpBuffer(lenToRead);
+    const qint64 pos = QIODevice::pos();
 
-        const auto read = archive_read_data(m_archive.get(), tmpBuffer.data(), lenToRead);
-        if(read > 0) {
-            m_buffer.buffer().append(tmpBuffer.data(), read);
-        }
-        else if(read < 0) {
-            qCWarning(LIBARCH) << "Reading failed:" << archive_error_string(m_archive.get());
-            setErrorString(QString::fromLocal8Bit(archive_error_string(m_archive.get())));
-            return -1;
-        }
+    if(pos < m_windowStart && !rewind(pos)) {
+        return -1;
+    }
+
+    // The requested range has to fit in the window alongside data already read
+    maxlen = std::min(maxlen, m_windowSize);
+
+    if(pos + maxlen > m_streamPos && !fill(pos + maxlen)) {
+        return -1;
     }
 
-    return m_buffer.read(data, maxlen);
+    const qint64 available = std::min(maxlen, m_streamPos - pos);
+    if(available <= 0) {
+        return 0;
+    }
+
+    const qint64 offset = pos % m_windowSize;
+    const qint64 first  = std::min(available, m_windowSize - offset);
+
+    std::memcpy(data, m_window.get() + offset, static_cast<size_t>(first));
+    if(first < available) {
+        std::memcpy(data + first, m_window.get(), static_cast<size_t>(available - first));
+    }
+
+    return available;
 }
 
 qint64 LibArchiveIODevice::writeData(const char* /*data*/, qint64 /*len*/)
@@ -149,6 +181,73 @@ qint64 LibArchiveIODevice::writeData(const char* /*data*/, qint64 /*len*/)
     return -1;
 }
 
+bool LibArchiveIODevice::rewind(qint64 pos)
+{
+    if(m_archive && archive_seek_data(m_archive.get(), pos, SEEK_SET) == pos) {
+        m_windowStart = pos;
+        m_streamPos   = pos;
+        return true;
+    }
+
+    if(!m_reopen) {
+        qCWarning(LIBARCH) << "Unable to seek backwards in archive entry";
+        setErrorString(QStringLiteral("Unable to seek backwards in archive entry"));
+        return false;
+    }
+
+    archive_entry* entry{nullptr};
+    m_archive = m_reopen(&entry);
+    if(!m_archive) {
+        setErrorString(QStringLiteral("Unable to reopen archive"));
+        return false;
+    }
+
+    m_windowStart = 0;
+    m_streamPos   = 0;
+
+    // Fill the window up to the target so the caller can read from it directly
+    return pos == 0 || fill(pos);
+}
+
+void LibArchiveIODevice::allocateWindow()
+{
+    if(!m_window) {
+        // Every byte is written by fill before it's read, so skip zeroing it
+        m_window = std::unique_ptr<char[]>{new char[static_cast<size_t>(m_windowSize)]};
+    }
+}
+
+bool LibArchiveIODevice::fill(qint64 end)
+{
+    allocateWindow();
+
+    while(m_streamPos < end) {
+        const qint64 offset = m_streamPos % m_windowSize;
+        const qint64 len    = std::min(end - m_streamPos, m_windowSize - offset);
+
+        const auto read = archive_read_data(m_archive.get(), m_window.get() + offset, static_cast<size_t>(len));
+        if(read < 0) {
+            setError();
+            return false;
+        }
+        if(read == 0) {
+            // End of entry
+            break;
+        }
+
+        m_streamPos += read;
+        m_windowStart = std::max(m_windowStart, m_streamPos - m_windowSize);
+    }
+
+    return true;
+}
+
+void LibArchiveIODevice::setError()
+{
+    qCWarning(LIBARCH) << "Reading failed:" << archive_error_string(m_archive.get());
+    setErrorString(QString::fromLocal8Bit(archive_error_string(m_archive.get())));
+}
+
 QStringList LibArchiveReader::extensions() const
 {
     return fileExtensions();
@@ -168,30 +267,14 @@ bool LibArchiveReader::init(const QString& file)
 
 std::unique_ptr<QIODevice> LibArchiveReader::entry(const QString& file)
 {
-    ArchivePtr archive{archive_read_new()};
-
-    if(!setupForReading(archive.get(), m_file)) {
-        return nullptr;
-    }
-
     archive_entry* entry{nullptr};
 
-    while(archive_read_next_header(archive.get(), &entry) == ARCHIVE_OK) {
-        if(archive_read_has_encrypted_entries(archive.get()) == 1) {
-            qCInfo(LIBARCH) << "Unable to read encrypted file" << m_file;
-            return nullptr;
-        }
-
-        if(archive_entry_filetype(entry) == AE_IFREG) {
-            const QString entryPath = QDir::fromNativeSeparators(QFile::decodeName(archive_entry_pathname(entry)));
-            if(entryPath == file) {
-                return std::make_unique<LibArchiveIODevice>(std::move(archive), entry, nullptr);
-            }
-        }
+    ArchivePtr archive = openEntry(m_file, file, &entry);
+    if(!archive) {
+        return nullptr;
     }
 
-    qCDebug(LIBARCH) << "Unable to find" << file << "in" << m_file;
-    return nullptr;
+    return std::make_unique<LibArchiveIODevice>(std::move(archive), entry, reopenFunc(m_file, file));
 }
 
 bool LibArchiveReader::readTracks(ReadEntryCallback readEntry)
@@ -212,10 +295,14 @@ bool LibArchiveReader::readTracks(ReadEntryCallback readEntry)
 
         if(archive_entry_filetype(entry) == AE_IFREG) {
             const QString entryPath = QDir::fromNativeSeparators(QFile::decodeName(archive_entry_pathname(entry)));
-            auto entryDev           = std::make_unique<LibArchiveIODevice>(std::move(archive), entry, nullptr);
+            auto entryDev           = std::make_unique<LibArchiveIODevice>(std::move(archive), entry,
+                                                                             reopenFunc(m_file, entryPath));
 
             readEntry(entryPath, entryDev.get());
             archive.reset(entryDev->releaseArchive());
+            if(!archive) {
+                return false;
+            }
         }
     }
 
@@ -246,7 +333,8 @@ QByteArray LibArchiveReader::readCover(const Track& track, Track::Cover /*cover*
             if(isImageFile(entryPath)) {
                 const QFileInfo info{entryPath};
                 if(info.path() == track.relativeArchivePath()) {
-                    auto entryDev = std::make_unique<LibArchiveIODevice>(std::move(archive), entry, nullptr);
+                    auto entryDev = std::make_unique<LibArchiveIODevice>(std::move(archive), entry,
+                                                                         reopenFunc(m_file, entryPath));
                     if(entryDev) {
                         // Use first valid image
                         coverData = entryDev->readAll();
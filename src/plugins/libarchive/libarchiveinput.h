@@ -22,11 +22,13 @@
 #include <core/engine/audioinput.h>
 #include <core/engine/audioloader.h>
 
-#include <QBuffer>
 #include <QFile>
 
 #include <archive.h>
 
+#include <functional>
+#include <memory>
+
 struct archive;
 struct archive_entry;
 
@@ -43,12 +45,23 @@ struct ArchiveDeleter
 };
 using ArchivePtr = std::unique_ptr<archive, ArchiveDeleter>;
 
+/*!
+ * Streams a single archive entry.
+ *
+ * Only a fixed size window of the most recently decompressed data is kept, so memory use doesn't depend on
+ * the size of the entry. Seeking forwards decompresses up to the new position, and seeking back within the
+ * window is free. Seeking back before the window uses archive_seek_data if the format supports it, otherwise
+ * the archive is reopened at the start of the entry and decompressed up to the new position.
+ */
 class LibArchiveIODevice : public QIODevice
 {
     Q_OBJECT
 
 public:
-    LibArchiveIODevice(ArchivePtr archive, archive_entry* entry, QObject* parent = nullptr);
+    /** Returns the archive positioned at the start of the entry, setting @p entry to its header. */
+    using ReopenFunc = std::function<ArchivePtr(archive_entry** entry)>;
+
+    LibArchiveIODevice(ArchivePtr archive, archive_entry* entry, ReopenFunc reopen, QObject* parent = nullptr);
     ~LibArchiveIODevice() override;
 
     bool seek(qint64 pos) override;
@@ -61,9 +74,21 @@ protected:
     qint64 writeData(const char* data, qint64 len) override;
 
 private:
+    bool rewind(qint64 pos);
+    void allocateWindow();
+    bool fill(qint64 end);
+    void setError();
+
     ArchivePtr m_archive;
-    archive_entry* m_entry;
-    QBuffer m_buffer;
+    ReopenFunc m_reopen;
+    qint64 m_size;
+
+    // Ring buffer holding decompressed data from m_windowStart up to m_streamPos
+    // Allocated (uninitialised) on first fill
+    std::unique_ptr<char[]> m_window;
+    qint64 m_windowSize;
+    qint64 m_windowStart;
+    qint64 m_streamPos;
 };
 
 class FYCORE_EXPORT LibArchiveReader : public ArchiveReader
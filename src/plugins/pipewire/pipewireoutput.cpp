@@ -233,6 +233,11 @@ void PipeWireOutput::setPaused(bool pause)
     m_stream->setActive(!pause);
 }
 
+bool PipeWireOutput::supportsVolume() const
+{
+    return true;
+}
+
 void PipeWireOutput::setVolume(double volume)
 {
     m_volume = static_cast<float>(volume);
@@ -48,6 +48,7 @@ public:
     int write(const AudioBuffer& buffer) override;
     void setPaused(bool pause) override;
 
+    [[nodiscard]] bool supportsVolume() const override;
     void setVolume(double volume) override;
     void setDevice(const QString& device) override;
 
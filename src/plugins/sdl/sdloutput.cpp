@@ -76,7 +76,6 @@ SdlOutput::SdlOutput()
     : m_bufferSize{4096}
     , m_initialised{false}
     , m_device{QStringLiteral("default")}
-    , m_volume{1.0}
 { }
 
 bool SdlOutput::init(const AudioFormat& format)
@@ -200,10 +199,7 @@ OutputDevices SdlOutput::getAllDevices(bool isCurrentOutput)
 
 int SdlOutput::write(const AudioBuffer& buffer)
 {
-    AudioBuffer adjustedBuffer{buffer};
-    adjustedBuffer.scale(m_volume);
-
-    if(SDL_QueueAudio(m_audioDeviceId, adjustedBuffer.constData().data(), buffer.byteCount()) == 0) {
+    if(SDL_QueueAudio(m_audioDeviceId, buffer.constData().data(), buffer.byteCount()) == 0) {
         return buffer.sampleCount();
     }
 
@@ -215,11 +211,6 @@ void SdlOutput::setPaused(bool pause)
     SDL_PauseAudioDevice(m_audioDeviceId, pause);
 }
 
-void SdlOutput::setVolume(double volume)
-{
-    m_volume = volume;
-}
-
 void SdlOutput::setDevice(const QString& device)
 {
     if(!device.isEmpty()) {
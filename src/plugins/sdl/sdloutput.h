@@ -47,7 +47,6 @@ public:
 
     int write(const AudioBuffer& buffer) override;
     void setPaused(bool pause) override;
-    void setVolume(double volume) override;
     void setDevice(const QString& device) override;
 
     [[nodiscard]] QString error() const override;
@@ -63,7 +62,6 @@ private:
     int m_bufferSize;
     bool m_initialised;
     QString m_device;
-    double m_volume;
 
     SDL_AudioSpec m_desiredSpec;
     SDL_AudioSpec m_obtainedSpec;
@@ -23,6 +23,8 @@
 
 #include <utils/settings/settingsmanager.h>
 
+#include <QThread>
+
 namespace Fooyin::WaveBar {
 WaveBarSettings::WaveBarSettings(SettingsManager* settingsManager)
     : m_settings{settingsManager}
@@ -42,5 +44,9 @@ WaveBarSettings::WaveBarSettings(SettingsManager* settingsManager)
     m_settings->createSetting<CentreGap>(0, QStringLiteral("WaveBar/CentreGap"));
     m_settings->createSetting<ChannelScale>(0.9, QStringLiteral("WaveBar/ChannelScale"));
     m_settings->createSetting<NumSamples>(2048, QStringLiteral("WaveBar/NumSamples"));
+    m_settings->createSetting<Pregenerate>(false, QStringLiteral("WaveBar/Pregenerate"));
+    m_settings->createSetting<PregenerateThreads>(std::max(1, QThread::idealThreadCount() / 2),
+                                                  QStringLiteral("WaveBar/PregenerateThreads"));
+    m_settings->createSetting<PregenerateBudget>(50, QStringLiteral("WaveBar/PregenerateBudget"));
 }
 } // namespace Fooyin::WaveBar
@@ -35,6 +35,7 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QRadioButton>
+#include <QThread>
 
 namespace Fooyin::WaveBar {
 class WaveBarSettingsPageWidget : public SettingsPageWidget
@@ -74,6 +75,10 @@ private:
 
     QLabel* m_cacheSizeLabel;
     QComboBox* m_numSamples;
+
+    QGroupBox* m_pregenerate;
+    QSpinBox* m_pregenerateThreads;
+    QSpinBox* m_pregenerateBudget;
 };
 
 WaveBarSettingsPageWidget::WaveBarSettingsPageWidget(SettingsManager* settings)
@@ -93,6 +98,9 @@ WaveBarSettingsPageWidget::WaveBarSettingsPageWidget(SettingsManager* settings)
     , m_centreGap{new QSpinBox(this)}
     , m_cacheSizeLabel{new QLabel(this)}
     , m_numSamples{new QComboBox(this)}
+    , m_pregenerate{new QGroupBox(tr("Generate waveforms for the library in the background"), this)}
+    , m_pregenerateThreads{new QSpinBox(this)}
+    , m_pregenerateBudget{new QSpinBox(this)}
 {
     auto* layout = new QGridLayout(this);
 
@@ -211,6 +219,30 @@ WaveBarSettingsPageWidget::WaveBarSettingsPageWidget(SettingsManager* settings)
     generalGroupLayout->addWidget(clearCacheButton, 1, 1);
     generalGroupLayout->setColumnStretch(2, 1);
 
+    m_pregenerate->setCheckable(true);
+    auto* pregenerateLayout = new QGridLayout(m_pregenerate);
+
+    auto* threadsLabel = new QLabel(tr("Threads") + QStringLiteral(":"), this);
+    auto* budgetLabel  = new QLabel(tr("CPU budget") + QStringLiteral(":"), this);
+
+    m_pregenerateThreads->setMinimum(1);
+    m_pregenerateThreads->setMaximum(std::max(1, QThread::idealThreadCount()));
+
+    const QString budgetTip{tr("Share of each thread's time spent generating. \n"
+                               "Threads are idle for the rest of the time.")};
+    budgetLabel->setToolTip(budgetTip);
+    m_pregenerateBudget->setToolTip(budgetTip);
+    m_pregenerateBudget->setMinimum(5);
+    m_pregenerateBudget->setMaximum(100);
+    m_pregenerateBudget->setSingleStep(5);
+    m_pregenerateBudget->setSuffix(QStringLiteral(" %"));
+
+    pregenerateLayout->addWidget(threadsLabel, 0, 0);
+    pregenerateLayout->addWidget(m_pregenerateThreads, 0, 1);
+    pregenerateLayout->addWidget(budgetLabel, 1, 0);
+    pregenerateLayout->addWidget(m_pregenerateBudget, 1, 1);
+    pregenerateLayout->setColumnStretch(2, 1);
+
     row = 0;
     layout->addWidget(modeGroup, row, 0);
     layout->addWidget(downmixGroupBox, row++, 1);
@@ -218,6 +250,7 @@ WaveBarSettingsPageWidget::WaveBarSettingsPageWidget(SettingsManager* settings)
     layout->addWidget(scaleGroup, row++, 1);
     layout->addWidget(cursorGroup, row, 0);
     layout->addWidget(generalGroup, row++, 1);
+    layout->addWidget(m_pregenerate, row++, 0, 1, 2);
     layout->setRowStretch(layout->rowCount(), 1);
 }
 
@@ -250,6 +283,10 @@ void WaveBarSettingsPageWidget::load()
     updateCacheSize();
     const int samples = m_settings->value<Settings::WaveBar::NumSamples>();
     m_numSamples->setCurrentIndex(samples == 2048 ? 0 : 1);
+
+    m_pregenerate->setChecked(m_settings->value<Settings::WaveBar::Pregenerate>());
+    m_pregenerateThreads->setValue(m_settings->value<Settings::WaveBar::PregenerateThreads>());
+    m_pregenerateBudget->setValue(m_settings->value<Settings::WaveBar::PregenerateBudget>());
 }
 
 void WaveBarSettingsPageWidget::apply()
@@ -286,6 +323,10 @@ void WaveBarSettingsPageWidget::apply()
     }
     m_settings->set<Settings::WaveBar::Mode>(static_cast<int>(mode));
 
+    m_settings->set<Settings::WaveBar::PregenerateThreads>(m_pregenerateThreads->value());
+    m_settings->set<Settings::WaveBar::PregenerateBudget>(m_pregenerateBudget->value());
+    m_settings->set<Settings::WaveBar::Pregenerate>(m_pregenerate->isChecked());
+
     if(m_settings->set<Settings::WaveBar::NumSamples>(m_numSamples->currentIndex() == 0 ? 2048 : 4096)) {
         emit clearCache();
         updateCacheSize();
@@ -304,6 +345,9 @@ void WaveBarSettingsPageWidget::reset()
     m_settings->reset<Settings::WaveBar::ChannelScale>();
     m_settings->reset<Settings::WaveBar::Mode>();
     m_settings->reset<Settings::WaveBar::NumSamples>();
+    m_settings->reset<Settings::WaveBar::Pregenerate>();
+    m_settings->reset<Settings::WaveBar::PregenerateThreads>();
+    m_settings->reset<Settings::WaveBar::PregenerateBudget>();
 }
 
 void WaveBarSettingsPageWidget::updateCacheSize()
@@ -19,67 +19,24 @@
 
 #include "wavebardatabase.h"
 
+#include "waveformcodec.h"
+
 #include <core/track.h>
 #include <utils/crypto.h>
 #include <utils/database/dbquery.h>
-#include <utils/datastream.h>
-
-namespace {
-using Fooyin::WaveBar::WaveformData;
-
-QDataStream& operator>>(QDataStream& stream, std::vector<WaveformData<int16_t>::ChannelData>& data)
-{
-    quint32 size;
-    stream >> size;
+#include <utils/database/dbtransaction.h>
 
-    data.reserve(size);
-
-    while(size > 0) {
-        --size;
-
-        WaveformData<int16_t>::ChannelData channel;
-        Fooyin::operator>>(stream, channel.max);
-        Fooyin::operator>>(stream, channel.min);
-        Fooyin::operator>>(stream, channel.rms);
-        data.emplace_back(channel);
-    }
-    return stream;
-}
-
-QDataStream& operator<<(QDataStream& stream, const std::vector<WaveformData<int16_t>::ChannelData>& data)
-{
-    stream << static_cast<quint32>(data.size());
-
-    for(const auto& channel : data) {
-        Fooyin::operator<<(stream, channel.max);
-        Fooyin::operator<<(stream, channel.min);
-        Fooyin::operator<<(stream, channel.rms);
-    }
-
-    return stream;
-}
-
-QByteArray serialiseData(const WaveformData<int16_t>& data)
-{
-    QByteArray out;
-    QDataStream stream{&out, QDataStream::WriteOnly};
-    stream.setVersion(QDataStream::Qt_6_0);
+#include <QLoggingCategory>
 
-    stream << data.channelData;
+#include <algorithm>
 
-    out = qCompress(out, 9);
+Q_DECLARE_LOGGING_CATEGORY(WAVEBAR)
 
-    return out;
-}
-
-void deserialiseData(const QByteArray& cacheData, WaveformData<int16_t>& data)
-{
-    QByteArray in = qUncompress(cacheData);
-    QDataStream stream{&in, QDataStream::ReadOnly};
-    stream.setVersion(QDataStream::Qt_6_0);
-
-    stream >> data.channelData;
-}
+namespace {
+// Stored as the SQLite user_version once every blob has been converted to the compact format
+constexpr auto CacheVersion = 1;
+// Rows converted per transaction when migrating, so other connections aren't locked out for long
+constexpr auto MigrationBatchSize = 256;
 } // namespace
 
 namespace Fooyin::WaveBar {
@@ -108,6 +65,23 @@ bool WaveBarDatabase::existsInCache(const QString& key) const
     return false;
 }
 
+QStringList WaveBarDatabase::cacheKeys() const
+{
+    const auto statement = QStringLiteral("SELECT TrackKey FROM WaveCache;");
+
+    DbQuery query{db(), statement};
+
+    QStringList keys;
+
+    if(query.exec()) {
+        while(query.next()) {
+            keys.emplace_back(query.value(0).toString());
+        }
+    }
+
+    return keys;
+}
+
 bool WaveBarDatabase::loadCachedData(const QString& key, WaveformData<int16_t>& data) const
 {
     const auto statement = QStringLiteral("SELECT Data FROM WaveCache WHERE TrackKey = :trackKey;");
@@ -116,13 +90,26 @@ bool WaveBarDatabase::loadCachedData(const QString& key, WaveformData<int16_t>&
 
     query.bindValue(QStringLiteral(":trackKey"), key);
 
-    if(query.exec() && query.next()) {
-        const QByteArray cacheData = query.value(0).toByteArray();
-        deserialiseData(cacheData, data);
-        return true;
+    if(!query.exec() || !query.next()) {
+        return false;
     }
 
-    return false;
+    const QByteArray cacheData = query.value(0).toByteArray();
+
+    if(WaveformCodec::isCompact(cacheData)) {
+        return WaveformCodec::decode(cacheData, data);
+    }
+
+    if(!WaveformCodec::decodeLegacy(cacheData, data)) {
+        return false;
+    }
+
+    // Not yet migrated, so convert now it's been read
+    if(!storeInCache(key, data)) {
+        qCWarning(WAVEBAR) << "Unable to convert cached waveform to the compact format";
+    }
+
+    return true;
 }
 
 bool WaveBarDatabase::storeInCache(const QString& key, const WaveformData<int16_t>& data) const
@@ -133,7 +120,7 @@ bool WaveBarDatabase::storeInCache(const QString& key, const WaveformData<int16_
     DbQuery query{db(), statement};
 
     query.bindValue(QStringLiteral(":trackKey"), key);
-    query.bindValue(QStringLiteral(":data"), serialiseData(data));
+    query.bindValue(QStringLiteral(":data"), WaveformCodec::encode(data));
 
     return query.exec();
 }
@@ -158,6 +145,75 @@ bool WaveBarDatabase::removeFromCache(const QStringList& keys) const
     return query.exec();
 }
 
+bool WaveBarDatabase::migrateCache() const
+{
+    DbQuery versionQuery{db(), QStringLiteral("PRAGMA user_version;")};
+    if(!versionQuery.exec() || !versionQuery.next()) {
+        return false;
+    }
+    if(versionQuery.value(0).toInt() >= CacheVersion) {
+        return true;
+    }
+
+    const QStringList keys = cacheKeys();
+
+    int migrated{0};
+
+    for(qsizetype batchStart{0}; batchStart < keys.size(); batchStart += MigrationBatchSize) {
+        DbTransaction transaction{db()};
+        if(!transaction) {
+            return false;
+        }
+
+        const qsizetype batchEnd = std::min(batchStart + MigrationBatchSize, keys.size());
+
+        for(qsizetype i{batchStart}; i < batchEnd; ++i) {
+            const QString& key = keys.at(i);
+
+            DbQuery query{db(), QStringLiteral("SELECT Data FROM WaveCache WHERE TrackKey = :trackKey;")};
+            query.bindValue(QStringLiteral(":trackKey"), key);
+
+            if(!query.exec() || !query.next()) {
+                continue;
+            }
+
+            const QByteArray cacheData = query.value(0).toByteArray();
+            if(WaveformCodec::isCompact(cacheData)) {
+                continue;
+            }
+
+            WaveformData<int16_t> data;
+            if(!WaveformCodec::decodeLegacy(cacheData, data) || !storeInCache(key, data)) {
+                // Will be regenerated when next needed
+                if(!removeFromCache(key)) {
+                    qCWarning(WAVEBAR) << "Unable to remove invalid waveform data";
+                }
+                continue;
+            }
+
+            ++migrated;
+        }
+
+        if(!transaction.commit()) {
+            return false;
+        }
+    }
+
+    DbQuery setVersionQuery{db(), QStringLiteral("PRAGMA user_version = %1;").arg(CacheVersion)};
+    if(!setVersionQuery.exec()) {
+        return false;
+    }
+
+    if(migrated > 0) {
+        qCInfo(WAVEBAR) << "Converted" << migrated << "cached waveforms to the compact format";
+
+        DbQuery cleanQuery{db(), QStringLiteral("VACUUM")};
+        cleanQuery.exec();
+    }
+
+    return true;
+}
+
 bool WaveBarDatabase::clearCache() const
 {
     const auto statement = QStringLiteral("DELETE FROM WaveCache;");
@@ -33,10 +33,13 @@ public:
     void initialiseDatabase() const;
 
     [[nodiscard]] bool existsInCache(const QString& key) const;
+    [[nodiscard]] QStringList cacheKeys() const;
     [[nodiscard]] bool loadCachedData(const QString& key, WaveformData<int16_t>& data) const;
     [[nodiscard]] bool storeInCache(const QString& key, const WaveformData<int16_t>& data) const;
     [[nodiscard]] bool removeFromCache(const QString& key) const;
     [[nodiscard]] bool removeFromCache(const QStringList& keys) const;
+    /** Converts any data stored in the legacy format to the compact format. */
+    [[nodiscard]] bool migrateCache() const;
     [[nodiscard]] bool clearCache() const;
 
     static QString cacheKey(const Track& track);
@@ -25,6 +25,7 @@
 #include "wavebarconstants.h"
 #include "wavebarwidget.h"
 #include "waveformbuilder.h"
+#include "waveformpregenerator.h"
 
 #include <core/engine/enginecontroller.h>
 #include <core/player/playercontroller.h>
@@ -57,6 +58,7 @@ WaveBarPlugin::WaveBarPlugin()
 
 WaveBarPlugin::~WaveBarPlugin()
 {
+    m_pregenerator.reset();
     m_waveBuilder.reset();
 }
 
@@ -64,6 +66,8 @@ void WaveBarPlugin::initialise(const CorePluginContext& context)
 {
     m_playerController = context.playerController;
     m_engine           = context.engine;
+    m_library          = context.library;
+    m_playlistHandler  = context.playlistHandler;
     m_audioLoader      = context.audioLoader;
     m_settings         = context.settingsManager;
 
@@ -74,6 +78,8 @@ void WaveBarPlugin::initialise(const CorePluginContext& context)
             removeTrack(m_playingTrack);
         }
     });
+
+    migrateCache();
 }
 
 void WaveBarPlugin::initialise(const GuiPluginContext& context)
@@ -88,6 +94,9 @@ void WaveBarPlugin::initialise(const GuiPluginContext& context)
 
     QObject::connect(m_waveBarSettingsPage.get(), &WaveBarSettingsPage::clearCache, this, &WaveBarPlugin::clearCache);
 
+    m_pregenerator = std::make_unique<WaveformPregenerator>(m_audioLoader, m_dbPool, m_library, m_playlistHandler,
+                                                            m_settings);
+
     m_widgetProvider->registerWidget(
         QStringLiteral("WaveBar"), [this]() { return createWavebar(); }, tr("Waveform Seekbar"));
     m_widgetProvider->setSubMenus(QStringLiteral("WaveBar"), {tr("Controls")});
@@ -198,14 +207,35 @@ void WaveBarPlugin::removeSelection()
     removeTracks(m_trackSelection->selectedTracks());
 }
 
+void WaveBarPlugin::migrateCache() const
+{
+    Utils::asyncExec([dbPool = m_dbPool]() {
+        const DbConnectionHandler dbHandler{dbPool};
+        WaveBarDatabase waveDb;
+        waveDb.initialise(DbConnectionProvider{dbPool});
+        waveDb.initialiseDatabase();
+
+        if(!waveDb.migrateCache()) {
+            qCWarning(WAVEBAR) << "Unable to migrate waveform cache";
+        }
+    });
+}
+
 void WaveBarPlugin::clearCache() const
 {
-    const DbConnectionHandler handler{m_dbPool};
-    WaveBarDatabase waveDb;
-    waveDb.initialise(DbConnectionProvider{m_dbPool});
+    {
+        const DbConnectionHandler handler{m_dbPool};
+        WaveBarDatabase waveDb;
+        waveDb.initialise(DbConnectionProvider{m_dbPool});
+
+        if(!waveDb.clearCache()) {
+            qCWarning(WAVEBAR) << "Unable to clear waveform cache";
+        }
+    }
 
-    if(!waveDb.clearCache()) {
-        qCWarning(WAVEBAR) << "Unable to clear waveform cache";
+    // Restart only once this thread's connection has been released
+    if(m_pregenerator) {
+        m_pregenerator->restart();
     }
 }
 } // namespace Fooyin::WaveBar
@@ -33,6 +33,7 @@ class WaveBarSettings;
 class WaveBarSettingsPage;
 class WaveBarGuiSettingsPage;
 class WaveformBuilder;
+class WaveformPregenerator;
 
 class WaveBarPlugin : public QObject,
                       public Plugin,
@@ -56,11 +57,14 @@ private:
     void removeTrack(const Track& track);
     void removeTracks(const TrackList& tracks);
     void removeSelection();
+    void migrateCache() const;
     void clearCache() const;
 
     ActionManager* m_actionManager;
     PlayerController* m_playerController;
     EngineController* m_engine;
+    MusicLibrary* m_library;
+    PlaylistHandler* m_playlistHandler;
     std::shared_ptr<AudioLoader> m_audioLoader;
     TrackSelectionController* m_trackSelection;
     WidgetProvider* m_widgetProvider;
@@ -69,6 +73,7 @@ private:
     Track m_playingTrack;
     DbConnectionPoolPtr m_dbPool;
     std::unique_ptr<WaveformBuilder> m_waveBuilder;
+    std::unique_ptr<WaveformPregenerator> m_pregenerator;
 
     std::unique_ptr<WaveBarSettings> m_waveBarSettings;
     std::unique_ptr<WaveBarSettingsPage> m_waveBarSettingsPage;
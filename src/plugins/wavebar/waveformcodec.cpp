@@ -0,0 +1,270 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "waveformcodec.h"
+
+#include <utils/datastream.h>
+
+#include <QDataStream>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+using Fooyin::WaveBar::WaveformData;
+using ChannelData = WaveformData<int16_t>::ChannelData;
+
+namespace {
+constexpr std::array<char, 4> Magic{'F', 'Y', 'W', 'F'};
+constexpr quint8 Version = 2;
+// Size of the log curve used to quantise samples (as for mu-law)
+constexpr float Mu = 255.0F;
+
+struct Header
+{
+    quint8 version{0};
+    quint8 channels{0};
+    quint16 scale{0};
+    quint32 samples{0};
+    qint64 dataOffset{0};
+};
+
+size_t sampleCount(const std::vector<ChannelData>& channels)
+{
+    if(channels.empty()) {
+        return 0;
+    }
+
+    size_t count{std::numeric_limits<size_t>::max()};
+    for(const auto& [max, min, rms] : channels) {
+        count = std::min({count, max.size(), min.size(), rms.size()});
+    }
+    return count;
+}
+
+int peakScale(const std::vector<ChannelData>& channels)
+{
+    int peak{1};
+    for(const auto& channel : channels) {
+        for(const auto* samples : {&channel.max, &channel.min, &channel.rms}) {
+            for(const int16_t sample : *samples) {
+                peak = std::max(peak, std::abs(static_cast<int>(sample)));
+            }
+        }
+    }
+    return peak;
+}
+
+float logScale(int16_t sample, int scale)
+{
+    const float x = std::min(1.0F, static_cast<float>(std::abs(static_cast<int>(sample))) / static_cast<float>(scale));
+    return std::log1p(Mu * x) / std::log1p(Mu);
+}
+
+uint8_t quantiseSigned(int16_t sample, int scale)
+{
+    const auto level = static_cast<int>(std::lround(logScale(sample, scale) * 127.0F));
+    return static_cast<uint8_t>(static_cast<int8_t>(sample < 0 ? -level : level));
+}
+
+uint8_t quantiseUnsigned(int16_t sample, int scale)
+{
+    return static_cast<uint8_t>(std::lround(logScale(sample, scale) * 255.0F));
+}
+
+int16_t expand(float level, int scale)
+{
+    const float x = std::expm1(level * std::log1p(Mu)) / Mu;
+    return static_cast<int16_t>(std::clamp(std::lround(x * static_cast<float>(scale)), 0L,
+                                           static_cast<long>(std::numeric_limits<int16_t>::max())));
+}
+
+// Each channel is stored as max, min then rms, with every byte stored as the difference from the one before
+QByteArray encodeSamples(const std::vector<ChannelData>& channels, size_t count, int scale)
+{
+    QByteArray raw;
+    raw.reserve(static_cast<qsizetype>(channels.size() * count * 3));
+
+    for(const auto& [max, min, rms] : channels) {
+        uint8_t prev{0};
+        auto append = [&raw, &prev](uint8_t value) {
+            raw.append(static_cast<char>(static_cast<uint8_t>(value - prev)));
+            prev = value;
+        };
+
+        for(size_t i{0}; i < count; ++i) {
+            append(quantiseSigned(max[i], scale));
+        }
+        for(size_t i{0}; i < count; ++i) {
+            append(quantiseSigned(min[i], scale));
+        }
+        for(size_t i{0}; i < count; ++i) {
+            append(quantiseUnsigned(rms[i], scale));
+        }
+    }
+
+    return qCompress(raw, 9);
+}
+
+bool readHeader(const QByteArray& blob, Header& header)
+{
+    QDataStream stream{blob};
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    std::array<char, 4> magic{};
+    if(stream.readRawData(magic.data(), static_cast<int>(magic.size())) != static_cast<int>(magic.size())
+       || magic != Magic) {
+        return false;
+    }
+
+    stream >> header.version >> header.channels >> header.scale >> header.samples;
+    if(header.version != Version || header.scale == 0) {
+        return false;
+    }
+
+    header.dataOffset = stream.device()->pos();
+
+    return stream.status() == QDataStream::Ok;
+}
+} // namespace
+
+namespace Fooyin::WaveBar::WaveformCodec {
+QByteArray encode(const WaveformData<int16_t>& data)
+{
+    const int scale        = peakScale(data.channelData);
+    const size_t count     = sampleCount(data.channelData);
+    const QByteArray chunk = encodeSamples(data.channelData, count, scale);
+
+    QByteArray out;
+    QDataStream stream{&out, QDataStream::WriteOnly};
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    stream.writeRawData(Magic.data(), static_cast<int>(Magic.size()));
+    stream << Version << static_cast<quint8>(data.channelData.size()) << static_cast<quint16>(scale)
+           << static_cast<quint32>(count);
+    stream.writeRawData(chunk.constData(), static_cast<int>(chunk.size()));
+
+    return out;
+}
+
+bool decode(const QByteArray& blob, WaveformData<int16_t>& data)
+{
+    Header header;
+    if(!readHeader(blob, header)) {
+        return false;
+    }
+
+    // The compressed samples make up the rest of the blob
+    const QByteArray raw = qUncompress(reinterpret_cast<const uchar*>(blob.constData() + header.dataOffset),
+                                       static_cast<qsizetype>(blob.size() - header.dataOffset));
+
+    const size_t count = header.samples;
+    if(std::cmp_not_equal(raw.size(), static_cast<size_t>(header.channels) * count * 3)) {
+        return false;
+    }
+
+    // Every quantised value maps to one of 256 samples, so expand them once up front
+    std::array<int16_t, 256> signedTable;
+    std::array<int16_t, 256> unsignedTable;
+    for(int i{0}; i < 256; ++i) {
+        const auto signedLevel = static_cast<int8_t>(static_cast<uint8_t>(i));
+        const int16_t sample   = expand(static_cast<float>(std::abs(signedLevel)) / 127.0F, header.scale);
+
+        signedTable[i]   = static_cast<int16_t>(signedLevel < 0 ? -sample : sample);
+        unsignedTable[i] = expand(static_cast<float>(i) / 255.0F, header.scale);
+    }
+
+    const auto* in = reinterpret_cast<const uint8_t*>(raw.constData());
+
+    data.channelData.clear();
+    data.channelData.resize(header.channels);
+
+    for(auto& [max, min, rms] : data.channelData) {
+        uint8_t prev{0};
+        auto read = [&in, &prev, count](std::vector<int16_t>& out, const std::array<int16_t, 256>& table) {
+            out.resize(count);
+            for(size_t i{0}; i < count; ++i) {
+                prev   = static_cast<uint8_t>(prev + *in++);
+                out[i] = table[prev];
+            }
+        };
+
+        read(max, signedTable);
+        read(min, signedTable);
+        read(rms, unsignedTable);
+    }
+
+    return true;
+}
+
+bool isCompact(const QByteArray& blob)
+{
+    // Legacy blobs start with the uncompressed size, which would have to be over 1GB to match
+    return blob.size() >= static_cast<qsizetype>(Magic.size())
+        && std::equal(Magic.cbegin(), Magic.cend(), blob.cbegin());
+}
+
+QByteArray encodeLegacy(const WaveformData<int16_t>& data)
+{
+    QByteArray out;
+    QDataStream stream{&out, QDataStream::WriteOnly};
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    stream << static_cast<quint32>(data.channelData.size());
+
+    for(const auto& channel : data.channelData) {
+        Fooyin::operator<<(stream, channel.max);
+        Fooyin::operator<<(stream, channel.min);
+        Fooyin::operator<<(stream, channel.rms);
+    }
+
+    return qCompress(out, 9);
+}
+
+bool decodeLegacy(const QByteArray& blob, WaveformData<int16_t>& data)
+{
+    QByteArray in = qUncompress(blob);
+    if(in.isEmpty()) {
+        return false;
+    }
+
+    QDataStream stream{&in, QDataStream::ReadOnly};
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 size;
+    stream >> size;
+
+    data.channelData.clear();
+    data.channelData.reserve(size);
+
+    while(size > 0) {
+        --size;
+
+        ChannelData channel;
+        Fooyin::operator>>(stream, channel.max);
+        Fooyin::operator>>(stream, channel.min);
+        Fooyin::operator>>(stream, channel.rms);
+        data.channelData.emplace_back(channel);
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+} // namespace Fooyin::WaveBar::WaveformCodec
@@ -0,0 +1,45 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "waveformdata.h"
+
+#include <QByteArray>
+
+namespace Fooyin::WaveBar::WaveformCodec {
+/*!
+ * Encodes @p data in the compact cache format.
+ *
+ * Samples are stored as 8 bits on a log scale relative to the loudest sample in the track, delta encoded
+ * and compressed. Only the full resolution data is stored, as reduced views are built from it in memory
+ * by WaveformPyramid.
+ */
+[[nodiscard]] QByteArray encode(const WaveformData<int16_t>& data);
+
+/** Decodes a blob created by encode. */
+bool decode(const QByteArray& blob, WaveformData<int16_t>& data);
+
+/** Returns true if @p blob was created by encode rather than being in the legacy format. */
+[[nodiscard]] bool isCompact(const QByteArray& blob);
+
+// The original format: compressed QDataStream serialisation of the int16 sample vectors
+[[nodiscard]] QByteArray encodeLegacy(const WaveformData<int16_t>& data);
+bool decodeLegacy(const QByteArray& blob, WaveformData<int16_t>& data);
+} // namespace Fooyin::WaveBar::WaveformCodec
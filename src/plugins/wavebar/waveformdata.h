@@ -21,10 +21,13 @@
 
 #include <core/engine/audioformat.h>
 
+#include <memory>
 #include <tuple>
 #include <vector>
 
 namespace Fooyin::WaveBar {
+class WaveformPyramid;
+
 struct WaveformSample
 {
     float max{-1.0};
@@ -58,6 +61,8 @@ struct WaveformData
         }
     };
     std::vector<ChannelData> channelData;
+    // Built from channelData once generation is complete; not part of comparisons
+    std::shared_ptr<const WaveformPyramid> pyramid;
 
     bool operator==(const WaveformData<T>& other) const noexcept
     {
@@ -19,6 +19,8 @@
 
 #include "waveformgenerator.h"
 
+#include "waveformpyramid.h"
+
 #include <core/engine/audioconverter.h>
 #include <core/engine/audioloader.h>
 #include <utils/math.h>
@@ -106,6 +108,7 @@ WaveformGenerator::WaveformGenerator(std::shared_ptr<AudioLoader> audioLoader, D
     , m_audioLoader{std::move(audioLoader)}
     , m_decoder{nullptr}
     , m_dbPool{std::move(dbPool)}
+    , m_convert{false}
 {
     m_requiredFormat.setSampleFormat(SampleFormat::F32);
 }
@@ -139,6 +142,7 @@ void WaveformGenerator::generate(const Track& track, int samplesPerChannel, bool
                 const auto floatData = convertCache<float>(data);
                 m_data.channelData   = floatData.channelData;
                 m_data.complete      = true;
+                m_data.pyramid       = WaveformPyramid::build(m_data);
 
                 setState(Idle);
                 emit waveformGenerated(m_data);
@@ -193,7 +197,9 @@ void WaveformGenerator::generate(const Track& track, int samplesPerChannel, bool
         }
 
         processedBytes += buffer.byteCount();
-        buffer = Audio::convert(buffer, m_requiredFormat);
+        if(m_convert) {
+            buffer = Audio::convert(buffer, m_requiredFormat);
+        }
         processBuffer(buffer);
 
         if(render && processedCount++ == updateThreshold) {
@@ -212,6 +218,10 @@ void WaveformGenerator::generate(const Track& track, int samplesPerChannel, bool
         setState(Idle);
     }
 
+    if(render) {
+        m_data.pyramid = WaveformPyramid::build(m_data);
+    }
+
     emit waveformGenerated(m_data);
 }
 
@@ -256,6 +266,10 @@ QString WaveformGenerator::setup(const Track& track, int samplesPerChannel)
     m_requiredFormat.setChannelCount(m_format.channelCount());
     m_requiredFormat.setSampleRate(m_format.sampleRate());
 
+    // Reduce directly from the decoder's format where possible
+    m_convert = !WaveformReducer::canReduce(m_format.sampleFormat());
+    m_reducer.setFormat(m_convert ? m_requiredFormat : m_format);
+
     m_data.format   = m_requiredFormat;
     m_data.duration = track.duration();
     m_data.channels = m_format.channelCount();
@@ -267,35 +281,12 @@ QString WaveformGenerator::setup(const Track& track, int samplesPerChannel)
 
 void WaveformGenerator::processBuffer(const AudioBuffer& buffer)
 {
-    const int bps         = buffer.format().bytesPerSample();
-    const int sampleCount = buffer.frameCount();
-    const auto* samples   = buffer.data();
+    if(!m_reducer.reduce(buffer.data(), buffer.frameCount(), [this]() { return mayRun(); })) {
+        return;
+    }
 
     for(int ch{0}; ch < m_data.channels; ++ch) {
-        if(!mayRun()) {
-            return;
-        }
-
-        float max{-1.0};
-        float min{1.0};
-        float rms{0.0};
-
-        for(int i{0}; i < sampleCount; ++i) {
-            if(!mayRun()) {
-                return;
-            }
-
-            const int offset = (i * m_data.channels + ch) * bps;
-            float sample;
-            std::memcpy(&sample, samples + offset, bps);
-
-            max = std::max(max, sample);
-            min = std::min(min, sample);
-            rms += sample * sample;
-        }
-
-        rms /= static_cast<float>(sampleCount);
-        rms = std::sqrt(rms);
+        const auto [max, min, rms] = m_reducer.sample(ch);
 
         auto& [cMax, cMin, cRms] = m_data.channelData.at(ch);
         cMax.emplace_back(max);
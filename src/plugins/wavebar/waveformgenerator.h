@@ -20,6 +20,7 @@
 #pragma once
 
 #include "wavebardatabase.h"
+#include "waveformreducer.h"
 
 #include <core/engine/audioinput.h>
 #include <core/track.h>
@@ -68,6 +69,8 @@ private:
     AudioFormat m_requiredFormat;
     int m_samplesPerChannel;
     WaveformData<float> m_data;
+    WaveformReducer m_reducer;
+    bool m_convert;
 };
 } // namespace WaveBar
 } // namespace Fooyin
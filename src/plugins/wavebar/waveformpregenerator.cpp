@@ -0,0 +1,293 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "waveformpregenerator.h"
+
+#include "settings/wavebarsettings.h"
+#include "wavebardatabase.h"
+#include "waveformgenerator.h"
+
+#include <core/library/musiclibrary.h>
+#include <core/playlist/playlisthandler.h>
+#include <utils/async.h>
+#include <utils/database/dbconnectionhandler.h>
+#include <utils/settings/settingsmanager.h>
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <utility>
+
+namespace Fooyin::WaveBar {
+WaveformPregenerator::WaveformPregenerator(std::shared_ptr<AudioLoader> audioLoader, DbConnectionPoolPtr dbPool,
+                                           MusicLibrary* library, PlaylistHandler* playlistHandler,
+                                           SettingsManager* settings, QObject* parent)
+    : QObject{parent}
+    , m_audioLoader{std::move(audioLoader)}
+    , m_dbPool{std::move(dbPool)}
+    , m_library{library}
+    , m_playlistHandler{playlistHandler}
+    , m_settings{settings}
+    , m_running{false}
+    , m_keysLoaded{false}
+    , m_session{0}
+    , m_budget{m_settings->value<Settings::WaveBar::PregenerateBudget>()}
+    , m_samplesPerChannel{m_settings->value<Settings::WaveBar::NumSamples>()}
+{
+    QObject::connect(m_library, &MusicLibrary::tracksLoaded, this, &WaveformPregenerator::enqueue);
+    QObject::connect(m_library, &MusicLibrary::tracksAdded, this, &WaveformPregenerator::enqueue);
+    QObject::connect(m_playlistHandler, &PlaylistHandler::activePlaylistChanged, this,
+                     &WaveformPregenerator::activePlaylistChanged);
+
+    m_settings->subscribe<Settings::WaveBar::Pregenerate>(this, &WaveformPregenerator::setEnabled);
+    m_settings->subscribe<Settings::WaveBar::PregenerateThreads>(this, &WaveformPregenerator::restart);
+    m_settings->subscribe<Settings::WaveBar::PregenerateBudget>(this, [this](const int budget) { m_budget = budget; });
+    m_settings->subscribe<Settings::WaveBar::NumSamples>(this, [this](const int num) { m_samplesPerChannel = num; });
+
+    setEnabled(m_settings->value<Settings::WaveBar::Pregenerate>());
+}
+
+WaveformPregenerator::~WaveformPregenerator()
+{
+    stop();
+}
+
+void WaveformPregenerator::start()
+{
+    if(m_running) {
+        return;
+    }
+
+    m_running    = true;
+    m_keysLoaded = false;
+    ++m_session;
+
+    const int threadCount = std::max(1, m_settings->value<Settings::WaveBar::PregenerateThreads>());
+
+    for(int i{0}; i < threadCount; ++i) {
+        auto* thread    = new QThread(this);
+        auto* generator = new WaveformGenerator(m_audioLoader, m_dbPool);
+
+        generator->moveToThread(thread);
+        // Deleted on its own thread so its database connection is closed there
+        QObject::connect(thread, &QThread::finished, generator, &QObject::deleteLater);
+
+        thread->start(QThread::LowPriority);
+        QMetaObject::invokeMethod(generator, &Worker::initialiseThread);
+
+        m_workers.push_back({thread, generator});
+    }
+
+    if(Playlist* playlist = m_playlistHandler->activePlaylist()) {
+        prioritise(playlist->tracks());
+    }
+    enqueue(m_library->tracks());
+
+    loadCachedKeys();
+}
+
+void WaveformPregenerator::stop()
+{
+    if(!m_running) {
+        return;
+    }
+
+    m_running = false;
+
+    for(const auto& worker : m_workers) {
+        worker.generator->closeThread();
+        worker.thread->quit();
+    }
+    for(const auto& worker : m_workers) {
+        worker.thread->wait();
+        delete worker.thread;
+    }
+
+    m_workers.clear();
+    m_priorityQueue.clear();
+    m_queue.clear();
+    m_handledKeys.clear();
+}
+
+bool WaveformPregenerator::isRunning() const
+{
+    return m_running;
+}
+
+void WaveformPregenerator::prioritise(const TrackList& tracks)
+{
+    if(!m_running) {
+        return;
+    }
+
+    m_priorityQueue.insert(m_priorityQueue.begin(), tracks.cbegin(), tracks.cend());
+    dispatch();
+}
+
+void WaveformPregenerator::enqueue(const TrackList& tracks)
+{
+    if(!m_running) {
+        return;
+    }
+
+    m_queue.insert(m_queue.end(), tracks.cbegin(), tracks.cend());
+    dispatch();
+}
+
+void WaveformPregenerator::setEnabled(bool enabled)
+{
+    if(enabled) {
+        start();
+    }
+    else {
+        stop();
+    }
+}
+
+void WaveformPregenerator::restart()
+{
+    if(m_running) {
+        stop();
+        start();
+    }
+}
+
+void WaveformPregenerator::loadCachedKeys()
+{
+    Utils::asyncExec([dbPool = m_dbPool]() {
+        const DbConnectionHandler dbHandler{dbPool};
+        WaveBarDatabase waveDb;
+        waveDb.initialise(DbConnectionProvider{dbPool});
+        waveDb.initialiseDatabase();
+
+        return waveDb.cacheKeys();
+    }).then(this, [this, session = m_session](const QStringList& keys) {
+        if(!m_running || session != m_session) {
+            return;
+        }
+
+        for(const QString& key : keys) {
+            m_handledKeys.insert(key);
+        }
+
+        m_keysLoaded = true;
+        dispatch();
+    });
+}
+
+void WaveformPregenerator::activePlaylistChanged(Playlist* playlist)
+{
+    if(playlist) {
+        prioritise(playlist->tracks());
+    }
+}
+
+void WaveformPregenerator::dispatch()
+{
+    // Wait for the cached keys so already generated tracks aren't decoded again
+    if(!m_running || !m_keysLoaded) {
+        return;
+    }
+
+    for(int i{0}; std::cmp_less(i, m_workers.size()); ++i) {
+        if(!m_workers.at(i).busy) {
+            dispatchTo(i);
+        }
+    }
+}
+
+void WaveformPregenerator::dispatchTo(int index)
+{
+    auto& worker = m_workers.at(index);
+
+    const Track track = nextTrack();
+    if(!track.isValid()) {
+        worker.busy = false;
+        return;
+    }
+
+    worker.busy = true;
+
+    WaveformGenerator* generator = worker.generator;
+    QMetaObject::invokeMethod(generator, [this, generator, index, track, samples = m_samplesPerChannel,
+                                          session = m_session]() {
+        QElapsedTimer timer;
+        timer.start();
+
+        generator->generate(track, samples, false);
+
+        const qint64 elapsed = timer.elapsed();
+        QMetaObject::invokeMethod(this, [this, index, elapsed, session]() {
+            if(m_running && session == m_session) {
+                trackFinished(index, elapsed);
+            }
+        });
+    });
+}
+
+void WaveformPregenerator::trackFinished(int index, qint64 elapsed)
+{
+    // Stay idle long enough for time spent generating to make up m_budget percent of the total
+    const int budget    = std::clamp(m_budget, 1, 100);
+    const qint64 idleMs = elapsed * (100 - budget) / budget;
+
+    if(idleMs <= 0) {
+        dispatchTo(index);
+        return;
+    }
+
+    QTimer::singleShot(idleMs, this, [this, index, session = m_session]() {
+        if(m_running && session == m_session) {
+            dispatchTo(index);
+        }
+    });
+}
+
+Track WaveformPregenerator::nextTrack()
+{
+    auto takeFrom = [this](std::deque<Track>& queue) -> Track {
+        while(!queue.empty()) {
+            Track track = queue.front();
+            queue.pop_front();
+
+            if(!track.isValid()) {
+                continue;
+            }
+
+            const QString key = WaveBarDatabase::cacheKey(track);
+            if(m_handledKeys.contains(key)) {
+                continue;
+            }
+
+            m_handledKeys.insert(key);
+            return track;
+        }
+        return {};
+    };
+
+    if(Track track = takeFrom(m_priorityQueue); track.isValid()) {
+        return track;
+    }
+    return takeFrom(m_queue);
+}
+} // namespace Fooyin::WaveBar
+
+#include "moc_waveformpregenerator.cpp"
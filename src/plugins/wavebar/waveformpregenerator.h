@@ -0,0 +1,108 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <core/track.h>
+#include <utils/database/dbconnectionpool.h>
+
+#include <QObject>
+#include <QSet>
+
+#include <deque>
+#include <vector>
+
+class QThread;
+
+namespace Fooyin {
+class AudioLoader;
+class MusicLibrary;
+class Playlist;
+class PlaylistHandler;
+class SettingsManager;
+
+namespace WaveBar {
+class WaveformGenerator;
+
+/*!
+ * Generates waveform data for the library in the background.
+ *
+ * Tracks in the active playlist are generated first, followed by the rest of the library.
+ * Each worker runs its own WaveformGenerator, and so has its own decoder and database connection.
+ * Tracks already in the cache are skipped, so generation resumes where it left off after a restart.
+ * Each worker is idle for a share of the time it spends generating to stay within the configured budget.
+ */
+class WaveformPregenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    WaveformPregenerator(std::shared_ptr<AudioLoader> audioLoader, DbConnectionPoolPtr dbPool, MusicLibrary* library,
+                         PlaylistHandler* playlistHandler, SettingsManager* settings, QObject* parent = nullptr);
+    ~WaveformPregenerator() override;
+
+    void start();
+    void stop();
+    /** Restarts if running, rebuilding the queue from the current cache. */
+    void restart();
+    [[nodiscard]] bool isRunning() const;
+
+    /** Queues @p tracks ahead of any library tracks. */
+    void prioritise(const TrackList& tracks);
+    /** Queues @p tracks after all other queued tracks. */
+    void enqueue(const TrackList& tracks);
+
+private:
+    struct GeneratorThread
+    {
+        QThread* thread;
+        WaveformGenerator* generator;
+        bool busy{false};
+    };
+
+    void setEnabled(bool enabled);
+    void loadCachedKeys();
+    void activePlaylistChanged(Playlist* playlist);
+
+    void dispatch();
+    void dispatchTo(int index);
+    void trackFinished(int index, qint64 elapsed);
+    [[nodiscard]] Track nextTrack();
+
+    std::shared_ptr<AudioLoader> m_audioLoader;
+    DbConnectionPoolPtr m_dbPool;
+    MusicLibrary* m_library;
+    PlaylistHandler* m_playlistHandler;
+    SettingsManager* m_settings;
+
+    std::vector<GeneratorThread> m_workers;
+    std::deque<Track> m_priorityQueue;
+    std::deque<Track> m_queue;
+    // Keys of tracks which are cached or have been dispatched
+    QSet<QString> m_handledKeys;
+
+    bool m_running;
+    bool m_keysLoaded;
+    // Incremented on each start so work queued before a restart is ignored
+    int m_session;
+    int m_budget;
+    int m_samplesPerChannel;
+};
+} // namespace WaveBar
+} // namespace Fooyin
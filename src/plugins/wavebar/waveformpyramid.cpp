@@ -0,0 +1,113 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "waveformpyramid.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace Fooyin::WaveBar {
+void WaveformPyramid::Summary::merge(const Summary& other)
+{
+    if(other.count == 0) {
+        return;
+    }
+
+    max = std::max(max, other.max);
+    min = std::min(min, other.min);
+    sumSquares += other.sumSquares;
+    count += other.count;
+}
+
+std::shared_ptr<const WaveformPyramid> WaveformPyramid::build(const WaveformData<float>& data)
+{
+    auto pyramid = std::make_shared<WaveformPyramid>();
+
+    pyramid->m_sampleCount = data.sampleCount();
+    pyramid->m_levels.resize(data.channelData.size());
+
+    for(size_t ch{0}; ch < data.channelData.size(); ++ch) {
+        const auto& [inMax, inMin, inRms] = data.channelData[ch];
+        auto& levels                      = pyramid->m_levels[ch];
+
+        const size_t count = std::min({inMax.size(), inMin.size(), inRms.size()});
+
+        Level& base = levels.emplace_back();
+        base.reserve(count);
+        for(size_t i{0}; i < count; ++i) {
+            const auto rms = static_cast<double>(inRms[i]);
+            base.push_back({inMax[i], inMin[i], rms * rms, 1});
+        }
+
+        // Only whole nodes are kept, since a partial node can never lie within a clipped range
+        while(levels.back().size() >= 2) {
+            const Level& prev = levels.back();
+
+            Level next(prev.size() / 2);
+            for(size_t i{0}; i < next.size(); ++i) {
+                next[i] = prev[2 * i];
+                next[i].merge(prev[(2 * i) + 1]);
+            }
+
+            levels.push_back(std::move(next));
+        }
+    }
+
+    return pyramid;
+}
+
+int WaveformPyramid::channels() const
+{
+    return static_cast<int>(m_levels.size());
+}
+
+int WaveformPyramid::sampleCount() const
+{
+    return m_sampleCount;
+}
+
+WaveformPyramid::Summary WaveformPyramid::summarise(int channel, int start, int end) const
+{
+    Summary summary;
+
+    if(channel < 0 || channel >= channels()) {
+        return summary;
+    }
+
+    const auto& levels = m_levels[channel];
+    if(levels.empty()) {
+        return summary;
+    }
+
+    auto pos        = static_cast<size_t>(std::max(start, 0));
+    const auto last = std::min(static_cast<size_t>(std::max(end, 0)), levels.front().size());
+
+    while(pos < last) {
+        // Take the largest node which starts at pos and doesn't extend past last
+        const int aligned = pos == 0 ? static_cast<int>(levels.size()) - 1 : std::countr_zero(pos);
+        const int fits    = std::bit_width(last - pos) - 1;
+        const int level   = std::min({aligned, fits, static_cast<int>(levels.size()) - 1});
+
+        summary.merge(levels[level][pos >> level]);
+        pos += size_t{1} << level;
+    }
+
+    return summary;
+}
+} // namespace Fooyin::WaveBar
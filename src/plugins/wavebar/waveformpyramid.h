@@ -0,0 +1,61 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "waveformdata.h"
+
+#include <memory>
+#include <vector>
+
+namespace Fooyin::WaveBar {
+/*!
+ * Min/max/RMS summaries of waveform data at power-of-two reductions.
+ *
+ * Built once per waveform, so the summary of any range of samples can be found by merging
+ * at most two nodes per level rather than visiting every sample in the range.
+ */
+class WaveformPyramid
+{
+public:
+    struct Summary
+    {
+        float max{-1.0};
+        float min{1.0};
+        double sumSquares{0.0};
+        int count{0};
+
+        void merge(const Summary& other);
+    };
+
+    [[nodiscard]] static std::shared_ptr<const WaveformPyramid> build(const WaveformData<float>& data);
+
+    [[nodiscard]] int channels() const;
+    [[nodiscard]] int sampleCount() const;
+
+    /** Returns the summary of samples [start, end) of @p channel, clipped to the available samples. */
+    [[nodiscard]] Summary summarise(int channel, int start, int end) const;
+
+private:
+    // Levels per channel, where node i of level k covers samples [i * 2^k, (i + 1) * 2^k)
+    using Level = std::vector<Summary>;
+    std::vector<std::vector<Level>> m_levels;
+    int m_sampleCount{0};
+};
+} // namespace Fooyin::WaveBar
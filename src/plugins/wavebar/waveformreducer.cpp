@@ -0,0 +1,282 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "waveformreducer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if(defined(__GNUC__) && defined(__x86_64__))
+#define FY_WAVEFORM_SIMD
+#include <immintrin.h>
+#endif
+
+using Fooyin::SampleFormat;
+using Channel = Fooyin::WaveBar::WaveformReducer::Channel;
+
+namespace {
+// S24 is stored in 32 bits, so is reduced as S32
+SampleFormat reduceFormat(SampleFormat format)
+{
+    return format == SampleFormat::S24 ? SampleFormat::S32 : format;
+}
+
+float formatScale(SampleFormat format)
+{
+    switch(reduceFormat(format)) {
+        case(SampleFormat::S16):
+            return 1.0F / static_cast<float>(std::numeric_limits<int16_t>::max());
+        case(SampleFormat::S32):
+            return 1.0F / static_cast<float>(std::numeric_limits<int32_t>::max());
+        default:
+            return 1.0F;
+    }
+}
+
+// Accumulates samples [start, count) in their raw (unscaled) range
+template <typename T>
+void reduceScalar(const std::byte* data, size_t start, size_t count, int channels, Channel* out)
+{
+    for(size_t i{start}; i < count; ++i) {
+        T sample;
+        std::memcpy(&sample, data + (i * sizeof(T)), sizeof(T));
+
+        const auto value = static_cast<float>(sample);
+        auto& channel    = out[i % channels];
+
+        channel.min = std::min(channel.min, value);
+        channel.max = std::max(channel.max, value);
+        channel.sumSquares += static_cast<double>(value) * value;
+    }
+}
+
+#ifdef FY_WAVEFORM_SIMD
+// Vector lanes map to channels as lane % channels, so these only handle layouts where channels divides 4
+
+template <size_t Lanes, typename T>
+void foldLanes(const std::array<T, Lanes>& mins, const std::array<T, Lanes>& maxs,
+               const std::array<float, Lanes>& sums, int channels, Channel* out)
+{
+    for(size_t lane{0}; lane < Lanes; ++lane) {
+        auto& channel = out[lane % channels];
+
+        channel.min = std::min(channel.min, static_cast<float>(mins[lane]));
+        channel.max = std::max(channel.max, static_cast<float>(maxs[lane]));
+        channel.sumSquares += sums[lane];
+    }
+}
+
+void reduceS16Sse2(const std::byte* data, size_t count, int channels, Channel* out)
+{
+    __m128i min  = _mm_set1_epi16(std::numeric_limits<int16_t>::max());
+    __m128i max  = _mm_set1_epi16(std::numeric_limits<int16_t>::min());
+    __m128 sumLo = _mm_setzero_ps();
+    __m128 sumHi = _mm_setzero_ps();
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + (i * sizeof(int16_t))));
+
+        min = _mm_min_epi16(min, samples);
+        max = _mm_max_epi16(max, samples);
+
+        const __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16));
+        const __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16));
+
+        sumLo = _mm_add_ps(sumLo, _mm_mul_ps(lo, lo));
+        sumHi = _mm_add_ps(sumHi, _mm_mul_ps(hi, hi));
+    }
+
+    if(i > 0) {
+        std::array<int16_t, 8> mins;
+        std::array<int16_t, 8> maxs;
+        std::array<float, 8> sums;
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(mins.data()), min);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(maxs.data()), max);
+        _mm_storeu_ps(sums.data(), sumLo);
+        _mm_storeu_ps(sums.data() + 4, sumHi);
+
+        foldLanes(mins, maxs, sums, channels, out);
+    }
+
+    reduceScalar<int16_t>(data, i, count, channels, out);
+}
+
+template <typename T>
+__m128 load32(const std::byte* data, size_t index)
+{
+    if constexpr(std::is_same_v<T, float>) {
+        return _mm_loadu_ps(reinterpret_cast<const float*>(data) + index);
+    }
+    else {
+        return _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + (index * sizeof(int32_t)))));
+    }
+}
+
+// S32 is reduced as float, which only loses precision far below what a waveform can show
+template <typename T>
+void reduce32Sse2(const std::byte* data, size_t count, int channels, Channel* out)
+{
+    __m128 minA = _mm_set1_ps(std::numeric_limits<float>::max());
+    __m128 maxA = _mm_set1_ps(std::numeric_limits<float>::lowest());
+    __m128 sumA = _mm_setzero_ps();
+    __m128 minB = minA;
+    __m128 maxB = maxA;
+    __m128 sumB = sumA;
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const __m128 a = load32<T>(data, i);
+        const __m128 b = load32<T>(data, i + 4);
+
+        minA = _mm_min_ps(minA, a);
+        maxA = _mm_max_ps(maxA, a);
+        sumA = _mm_add_ps(sumA, _mm_mul_ps(a, a));
+        minB = _mm_min_ps(minB, b);
+        maxB = _mm_max_ps(maxB, b);
+        sumB = _mm_add_ps(sumB, _mm_mul_ps(b, b));
+    }
+
+    if(i > 0) {
+        std::array<float, 4> mins;
+        std::array<float, 4> maxs;
+        std::array<float, 4> sums;
+
+        _mm_storeu_ps(mins.data(), _mm_min_ps(minA, minB));
+        _mm_storeu_ps(maxs.data(), _mm_max_ps(maxA, maxB));
+        _mm_storeu_ps(sums.data(), _mm_add_ps(sumA, sumB));
+
+        foldLanes(mins, maxs, sums, channels, out);
+    }
+
+    reduceScalar<T>(data, i, count, channels, out);
+}
+#endif
+} // namespace
+
+namespace Fooyin::WaveBar {
+WaveformReducer::WaveformReducer()
+    : m_channels{0}
+    , m_scale{1.0F}
+    , m_frames{0}
+{ }
+
+bool WaveformReducer::canReduce(SampleFormat format)
+{
+    switch(reduceFormat(format)) {
+        case(SampleFormat::S16):
+        case(SampleFormat::S32):
+        case(SampleFormat::F32):
+            return true;
+        default:
+            return false;
+    }
+}
+
+void WaveformReducer::setFormat(const AudioFormat& format)
+{
+    m_format   = format;
+    m_channels = format.channelCount();
+    m_scale    = formatScale(format.sampleFormat());
+    m_frames   = 0;
+    m_state.assign(static_cast<size_t>(std::max(m_channels, 0)), {});
+}
+
+bool WaveformReducer::reduce(const std::byte* data, int frameCount, const ContinueFunc& mayContinue)
+{
+    std::ranges::fill(m_state, Channel{});
+    m_frames = 0;
+
+    if(!canReduce(m_format.sampleFormat()) || m_channels <= 0) {
+        return true;
+    }
+
+    const int frameBytes = m_format.bytesPerFrame();
+
+    for(int frame{0}; frame < frameCount; frame += BlockFrames) {
+        if(mayContinue && !mayContinue()) {
+            return false;
+        }
+
+        const int frames = std::min(BlockFrames, frameCount - frame);
+        reduceBlock(data + static_cast<ptrdiff_t>(frame) * frameBytes, frames);
+        m_frames += frames;
+    }
+
+    return true;
+}
+
+WaveformSample WaveformReducer::sample(int channel) const
+{
+    if(m_frames == 0 || channel < 0 || channel >= m_channels) {
+        return {};
+    }
+
+    const auto& state = m_state.at(channel);
+
+    WaveformSample sample;
+    sample.min = state.min * m_scale;
+    sample.max = state.max * m_scale;
+    sample.rms = static_cast<float>(std::sqrt(state.sumSquares / m_frames)) * m_scale;
+    return sample;
+}
+
+void WaveformReducer::reduceBlock(const std::byte* data, int frameCount)
+{
+    const auto count = static_cast<size_t>(frameCount) * m_channels;
+    Channel* out     = m_state.data();
+
+#ifdef FY_WAVEFORM_SIMD
+    if(4 % m_channels == 0) {
+        switch(reduceFormat(m_format.sampleFormat())) {
+            case(SampleFormat::S16):
+                reduceS16Sse2(data, count, m_channels, out);
+                return;
+            case(SampleFormat::S32):
+                reduce32Sse2<int32_t>(data, count, m_channels, out);
+                return;
+            case(SampleFormat::F32):
+                reduce32Sse2<float>(data, count, m_channels, out);
+                return;
+            default:
+                return;
+        }
+    }
+#endif
+
+    switch(reduceFormat(m_format.sampleFormat())) {
+        case(SampleFormat::S16):
+            reduceScalar<int16_t>(data, 0, count, m_channels, out);
+            break;
+        case(SampleFormat::S32):
+            reduceScalar<int32_t>(data, 0, count, m_channels, out);
+            break;
+        case(SampleFormat::F32):
+            reduceScalar<float>(data, 0, count, m_channels, out);
+            break;
+        default:
+            break;
+    }
+}
+} // namespace Fooyin::WaveBar
@@ -0,0 +1,77 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "waveformdata.h"
+
+#include <core/engine/audioformat.h>
+
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace Fooyin::WaveBar {
+/*!
+ * Reduces interleaved audio to a per-channel min/max/RMS in a single pass.
+ *
+ * S16, S24, S32 and F32 data is read in its native format, so buffers don't need converting first.
+ * Mono, stereo and quad layouts use vector instructions where available.
+ */
+class WaveformReducer
+{
+public:
+    // Frames reduced between checks for cancellation
+    static constexpr int BlockFrames = 4096;
+
+    using ContinueFunc = std::function<bool()>;
+
+    WaveformReducer();
+
+    [[nodiscard]] static bool canReduce(SampleFormat format);
+
+    void setFormat(const AudioFormat& format);
+
+    /*!
+     * Reduces @p frameCount frames of @p data, replacing the result of any previous call.
+     * @returns false if @p mayContinue returned false before all frames were reduced.
+     */
+    bool reduce(const std::byte* data, int frameCount, const ContinueFunc& mayContinue = {});
+
+    /** Returns the result for @p channel normalised to [-1, 1]. */
+    [[nodiscard]] WaveformSample sample(int channel) const;
+
+    // Running totals in the raw range of the sample format
+    struct Channel
+    {
+        float min{std::numeric_limits<float>::max()};
+        float max{std::numeric_limits<float>::lowest()};
+        double sumSquares{0.0};
+    };
+
+private:
+    void reduceBlock(const std::byte* data, int frameCount);
+
+    AudioFormat m_format;
+    int m_channels;
+    float m_scale;
+    int m_frames;
+    std::vector<Channel> m_state;
+};
+} // namespace Fooyin::WaveBar
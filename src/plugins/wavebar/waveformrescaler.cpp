@@ -19,37 +19,11 @@
 
 #include "waveformrescaler.h"
 
-#include <utils/settings/settingsmanager.h>
-
-namespace {
-int buildSample(Fooyin::WaveBar::WaveformSample& sample, Fooyin::WaveBar::WaveformData<float>& data, int channel,
-                double start, double end)
-{
-    int sampleCount{0};
-
-    auto& [inMax, inMin, inRms] = data.channelData.at(channel);
-
-    const int lastIndex = std::floor(end);
+#include "waveformpyramid.h"
 
-    for(int i = std::floor(start); i < std::ceil(end); ++i) {
-        for(int index{i}; index < lastIndex; ++index) {
-            if(std::cmp_less(index, inMax.size())) {
-                const float sampleMax = inMax.at(index);
-                const float sampleMin = inMin.at(index);
-                const float sampleRms = inRms.at(index);
-
-                sample.max = std::max(sample.max, sampleMax);
-                sample.min = std::min(sample.min, sampleMin);
-                sample.rms += sampleRms * sampleRms;
-
-                ++sampleCount;
-            }
-        }
-    }
+#include <utils/settings/settingsmanager.h>
 
-    return sampleCount;
-}
-} // namespace
+#include <cmath>
 
 namespace Fooyin::WaveBar {
 WaveformRescaler::WaveformRescaler(QObject* parent)
@@ -61,7 +35,7 @@ WaveformRescaler::WaveformRescaler(QObject* parent)
 
 void WaveformRescaler::rescale()
 {
-    if(m_width == 0) {
+    if(m_width == 0 || !m_pyramid) {
         return;
     }
 
@@ -69,6 +43,7 @@ void WaveformRescaler::rescale()
 
     WaveformData<float> data{m_data};
     data.channelData.clear();
+    data.pyramid.reset();
 
     if(m_downMix == DownmixOption::Stereo) {
         data.channels = 2;
@@ -83,8 +58,18 @@ void WaveformRescaler::rescale()
         = static_cast<double>(m_data.complete ? m_data.sampleCount() : m_data.samplesPerChannel) * m_sampleWidth;
     const auto samplesPerPixel = sampleSize / m_width;
 
+    const bool mixChannels
+        = m_downMix == DownmixOption::Mono || (m_downMix == DownmixOption::Stereo && m_data.channels > 2);
+
     for(int ch{0}; ch < data.channels; ++ch) {
-        auto& [outMax, outMin, outRms] = data.channelData.at(ch);
+        auto& [outMax, outMin, outRms] = data.channelData[ch];
+
+        outMax.reserve(m_width);
+        outMin.reserve(m_width);
+        outRms.reserve(m_width);
+
+        // Mono sources are shown on both channels when downmixing to stereo
+        const int inChannel = std::min(ch, m_data.channels - 1);
 
         double start{0.0};
 
@@ -95,25 +80,24 @@ void WaveformRescaler::rescale()
 
             const double end = std::max(1.0, (x + 1) * samplesPerPixel);
 
-            int sampleCount{0};
-            WaveformSample sample;
+            const auto first = static_cast<int>(std::floor(start));
+            const auto last  = static_cast<int>(std::floor(end));
 
-            if(m_downMix == DownmixOption::Mono || (m_downMix == DownmixOption::Stereo && m_data.channels > 2)) {
+            WaveformPyramid::Summary sample;
+
+            if(mixChannels) {
                 for(int mixCh{0}; mixCh < m_data.channels; ++mixCh) {
-                    sampleCount += buildSample(sample, m_data, mixCh, start, end);
+                    sample.merge(m_pyramid->summarise(mixCh, first, last));
                 }
             }
             else {
-                sampleCount += buildSample(sample, m_data, ch, start, end);
+                sample.merge(m_pyramid->summarise(inChannel, first, last));
             }
 
-            if(sampleCount > 0) {
-                sample.rms /= static_cast<float>(sampleCount);
-                sample.rms = std::sqrt(sample.rms);
-
+            if(sample.count > 0) {
                 outMax.emplace_back(sample.max);
                 outMin.emplace_back(sample.min);
-                outRms.emplace_back(sample.rms);
+                outRms.emplace_back(static_cast<float>(std::sqrt(sample.sumSquares / sample.count)));
             }
 
             start = end;
@@ -138,6 +122,8 @@ void WaveformRescaler::rescale(int width)
 void WaveformRescaler::rescale(const WaveformData<float>& data, int width)
 {
     if(std::exchange(m_data, data) != data) {
+        // Partial data emitted during generation doesn't carry a pyramid
+        m_pyramid = m_data.pyramid ? m_data.pyramid : WaveformPyramid::build(m_data);
         rescale(width);
     }
 }
@@ -45,6 +45,7 @@ public slots:
 
 private:
     WaveformData<float> m_data;
+    std::shared_ptr<const WaveformPyramid> m_pyramid;
     int m_width;
     int m_sampleWidth;
     DownmixOption m_downMix;
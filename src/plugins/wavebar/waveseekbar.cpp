@@ -26,32 +26,21 @@
 #include <utils/settings/settingsmanager.h>
 #include <utils/utils.h>
 
+#include <QElapsedTimer>
+#include <QLoggingCategory>
 #include <QMouseEvent>
 #include <QPainter>
 #include <QStyle>
 
+Q_DECLARE_LOGGING_CATEGORY(WAVEBAR)
+
 constexpr auto ToolTipDelay = 5;
 
 namespace {
-QColor blendColors(const QColor& color1, const QColor& color2, double ratio)
+void setupPainter(QPainter& painter, bool isPlayed, int barWidth, const QColor& unplayed, const QColor& played,
+                  const QColor& border)
 {
-    const int r = static_cast<int>(color1.red() * (1.0 - ratio) + color2.red() * ratio);
-    const int g = static_cast<int>(color1.green() * (1.0 - ratio) + color2.green() * ratio);
-    const int b = static_cast<int>(color1.blue() * (1.0 - ratio) + color2.blue() * ratio);
-    const int a = static_cast<int>(color1.alpha() * (1.0 - ratio) + color2.alpha() * ratio);
-
-    return {r, g, b, a};
-}
-
-void setupPainter(QPainter& painter, bool isInProgress, bool isPlayed, int barWidth, double progress,
-                  const QColor& unplayed, const QColor& played, const QColor& border)
-{
-    if(isInProgress) {
-        painter.setBrush(blendColors(unplayed, played, progress));
-    }
-    else {
-        painter.setBrush(isPlayed ? played : unplayed);
-    }
+    painter.setBrush(isPlayed ? played : unplayed);
 
     if(barWidth > 1) {
         painter.setPen(border);
@@ -79,6 +68,7 @@ WaveSeekBar::WaveSeekBar(SettingsManager* settings, QWidget* parent)
     , m_centreGap{settings->value<Settings::WaveBar::CentreGap>()}
     , m_mode{static_cast<WaveModes>(settings->value<Settings::WaveBar::Mode>())}
     , m_colours{settings->value<Settings::WaveBar::ColourOptions>().value<Colours>()}
+    , m_layersValid{false}
 {
     setFocusPolicy(Qt::FocusPolicy(style()->styleHint(QStyle::SH_Button_FocusPolicy)));
 
@@ -92,38 +82,38 @@ WaveSeekBar::WaveSeekBar(SettingsManager* settings, QWidget* parent)
     });
     m_settings->subscribe<Settings::WaveBar::ChannelScale>(this, [this](const double scale) {
         m_channelScale = scale;
-        update();
+        invalidateLayers();
     });
     m_settings->subscribe<Settings::WaveBar::BarWidth>(this, [this](const int width) {
         m_barWidth    = width;
         m_sampleWidth = m_barWidth + m_barGap;
-        update();
+        invalidateLayers();
     });
     m_settings->subscribe<Settings::WaveBar::BarGap>(this, [this](const int gap) {
         m_barGap      = gap;
         m_sampleWidth = m_barWidth + m_barGap;
-        update();
+        invalidateLayers();
     });
     m_settings->subscribe<Settings::WaveBar::MaxScale>(this, [this](const double scale) {
         m_maxScale = scale;
-        update();
+        invalidateLayers();
     });
     m_settings->subscribe<Settings::WaveBar::CentreGap>(this, [this](const int gap) {
         m_centreGap = gap;
-        update();
+        invalidateLayers();
     });
     m_settings->subscribe<Settings::WaveBar::Mode>(this, [this](const int mode) {
         m_mode = static_cast<WaveModes>(mode);
-        update();
+        invalidateLayers();
     });
     m_settings->subscribe<Settings::WaveBar::ColourOptions>(this, [this](const QVariant& var) {
         m_colours = var.value<Colours>();
-        update();
+        invalidateLayers();
     });
 
     auto updateColours = [this]() {
         m_colours = m_settings->value<Settings::WaveBar::ColourOptions>().value<Colours>();
-        update();
+        invalidateLayers();
     };
     m_settings->subscribe<Settings::Gui::Theme>(this, updateColours);
     m_settings->subscribe<Settings::Gui::Style>(this, updateColours);
@@ -141,7 +131,7 @@ void WaveSeekBar::processData(const WaveformData<float>& waveData)
         m_scale                 = std::round(m_scale * multiplier) / multiplier;
     }
 
-    update();
+    invalidateLayers();
 }
 
 void WaveSeekBar::setPlayState(Player::PlayState state)
@@ -180,8 +170,10 @@ void WaveSeekBar::stopSeeking()
 
 void WaveSeekBar::paintEvent(QPaintEvent* event)
 {
+    QElapsedTimer timer;
+    timer.start();
+
     QPainter painter{this};
-    painter.scale(m_scale, 1.0);
 
     if(m_data.empty()) {
         painter.setPen({m_colours.maxUnplayed, 1, Qt::SolidLine, Qt::FlatCap});
@@ -190,41 +182,53 @@ void WaveSeekBar::paintEvent(QPaintEvent* event)
         return;
     }
 
-    const int channels = m_data.channels;
-    QRect rect         = event->rect();
+    const bool renderedLayers = !m_layersValid || m_playedLayer.devicePixelRatio() != devicePixelRatioF();
+    if(renderedLayers) {
+        renderLayers();
+    }
+
+    QRect rect = event->rect();
     // Always repaint full height
     // Prevents clipping with seek tooltip and from other widgets
+    rect.setTop(0);
     rect.setHeight(contentsRect().height());
 
-    const auto first  = static_cast<int>(static_cast<double>(rect.left() / m_scale) / m_sampleWidth);
-    const auto last   = static_cast<int>(static_cast<double>(rect.right() + 1 / m_scale));
-    const double posX = positionFromValue(m_position) / m_scale;
+    const int posX = positionFromValue(m_position);
 
-    painter.fillRect(rect, m_colours.bgUnplayed);
-    painter.fillRect(QRect{first, 0, static_cast<int>(posX) - first, height()}, m_colours.bgPlayed);
+    const QRect playedRect   = rect.intersected({0, 0, posX, height()});
+    const QRect unplayedRect = rect.intersected({posX, 0, width() - posX, height()});
 
-    const int channelHeight     = rect.height() / channels;
-    const double waveformHeight = (channelHeight - m_centreGap) * m_channelScale;
-
-    int y = static_cast<int>((channelHeight - waveformHeight) / 2);
+    auto drawLayer = [&painter](const QRect& target, const QPixmap& layer) {
+        if(target.isEmpty()) {
+            return;
+        }
+        const qreal ratio = layer.devicePixelRatio();
+        const QRectF source{target.x() * ratio, target.y() * ratio, target.width() * ratio, target.height() * ratio};
+        painter.drawPixmap(QRectF{target}, layer, source);
+    };
 
-    for(int ch{0}; ch < channels; ++ch) {
-        drawChannel(painter, ch, waveformHeight, first, last, y);
-        y += channelHeight;
-    }
+    drawLayer(playedRect, m_playedLayer);
+    drawLayer(unplayedRect, m_unplayedLayer);
 
     if(m_showCursor && m_playState == Player::PlayState::Playing) {
         painter.setPen({m_colours.cursor, static_cast<double>(m_cursorWidth), Qt::SolidLine, Qt::FlatCap});
-        const QPointF pt1{posX, 0};
-        const QPointF pt2{posX, static_cast<double>(height())};
-        painter.drawLine(pt1, pt2);
+        painter.drawLine(posX, 0, posX, height());
     }
 
     if(isSeeking()) {
         painter.setPen({m_colours.seekingCursor, static_cast<double>(m_cursorWidth), Qt::SolidLine, Qt::FlatCap});
-        const int seekX = static_cast<int>(m_seekPos.x() / m_scale);
-        painter.drawLine(seekX, 0, seekX, height());
+        painter.drawLine(m_seekPos.x(), 0, m_seekPos.x(), height());
     }
+
+    qCDebug(WAVEBAR) << "Painted" << rect << (renderedLayers ? "(rendered layers)" : "") << "in"
+                     << timer.nsecsElapsed() / 1000 << "µs";
+}
+
+void WaveSeekBar::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+
+    invalidateLayers();
 }
 
 void WaveSeekBar::mouseMoveEvent(QMouseEvent* event)
@@ -346,9 +350,10 @@ void WaveSeekBar::updateRange(int first, int last)
         return;
     }
 
-    const auto cursorWidth = static_cast<int>(m_cursorWidth * m_scale);
-    const int left         = (first < last ? first : last) - cursorWidth - m_sampleWidth;
-    const int width        = (std::abs(last - first) + (2 * cursorWidth) + 1) * m_sampleWidth;
+    // Only the strip between the old and new cursor changes, plus half a cursor either side
+    const int margin = (m_cursorWidth / 2) + 1;
+    const int left   = std::min(first, last) - margin;
+    const int width  = std::abs(last - first) + (2 * margin);
 
     const QRect updateRect(left, 0, width, height());
     update(updateRect);
@@ -358,9 +363,59 @@ void WaveSeekBar::updateRange(int first, int last)
     }
 }
 
-void WaveSeekBar::drawChannel(QPainter& painter, int channel, double height, int first, int last, int y)
+void WaveSeekBar::invalidateLayers()
+{
+    m_layersValid = false;
+    update();
+}
+
+void WaveSeekBar::renderLayers()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    renderLayer(m_unplayedLayer, false);
+    renderLayer(m_playedLayer, true);
+
+    m_layersValid = true;
+
+    qCDebug(WAVEBAR) << "Rendered waveform layers in" << timer.nsecsElapsed() / 1000 << "µs";
+}
+
+void WaveSeekBar::renderLayer(QPixmap& layer, bool played)
+{
+    const qreal ratio = devicePixelRatioF();
+
+    layer = QPixmap{(QSizeF{size()} * ratio).toSize()};
+    layer.setDevicePixelRatio(ratio);
+    layer.fill(played ? m_colours.bgPlayed : m_colours.bgUnplayed);
+
+    QPainter painter{&layer};
+    painter.scale(m_scale, 1.0);
+
+    const int channels = m_data.channels;
+    if(channels <= 0) {
+        return;
+    }
+
+    const int channelHeight     = contentsRect().height() / channels;
+    const double waveformHeight = (channelHeight - m_centreGap) * m_channelScale;
+
+    int y = static_cast<int>((channelHeight - waveformHeight) / 2);
+
+    for(int ch{0}; ch < channels; ++ch) {
+        drawChannel(painter, ch, waveformHeight, y, played);
+        y += channelHeight;
+    }
+}
+
+void WaveSeekBar::drawChannel(QPainter& painter, int channel, double height, int y, bool played)
 {
-    const auto& [max, min, rms] = m_data.channelData.at(channel);
+    if(channel >= static_cast<int>(m_data.channelData.size())) {
+        return;
+    }
+
+    const auto& [max, min, rms] = m_data.channelData[channel];
 
     const double maxScale = (height / 2) * m_maxScale;
     const double minScale = height - maxScale;
@@ -371,49 +426,37 @@ void WaveSeekBar::drawChannel(QPainter& painter, int channel, double height, int
     const double centreGap = drawMax && drawMin ? m_centreGap : 0;
 
     double rmsScale{1.0};
-    if(m_mode & WaveMode::Rms && !(m_mode & WaveMode::MinMax)) {
+    if(m_mode & WaveMode::Rms && !(m_mode & WaveMode::MinMax) && !rms.empty()) {
         rmsScale = *std::ranges::max_element(rms);
     }
 
-    const auto total           = static_cast<int>(max.size());
-    const auto currentPosition = positionFromValue(m_position);
+    const auto total = static_cast<int>(max.size());
+    const int last   = static_cast<int>(std::ceil(width() / m_scale));
 
     if(!m_data.complete) {
         const auto finalX  = total * m_sampleWidth;
         const auto centreY = static_cast<double>(centre + (centreGap > 0 ? centreGap / 2 : 0));
-        drawSilence(painter, finalX, rect().width(), centreY);
+        drawSilence(painter, finalX, last, centreY, played);
     }
     else if(m_mode & WaveMode::Silence && drawMax && drawMin) {
         const auto centreY = static_cast<double>(centre + (centreGap > 0 ? centreGap / 2 : 0));
-        drawSilence(painter, first, last, centreY);
+        drawSilence(painter, 0, last, centreY, played);
     }
 
-    for(int i{first}; i <= last && i < total; ++i) {
-        const auto x        = static_cast<double>(i * m_sampleWidth);
-        const auto barWidth = static_cast<double>(m_barWidth);
-        const auto sampleX  = static_cast<int>(((i + 1) * m_sampleWidth) * m_scale);
+    const auto barWidth = static_cast<double>(m_barWidth);
 
-        double progress{0.0};
-        if(sampleX <= currentPosition) {
-            progress = 1.0;
-        }
-        else if(currentPosition < sampleX && currentPosition > (sampleX - m_sampleWidth)) {
-            progress = static_cast<double>(m_sampleWidth - std::abs(currentPosition - sampleX))
-                     / static_cast<double>(m_sampleWidth);
-        }
-
-        const bool isPlayed     = progress >= 1.0;
-        const bool isInProgress = !isPlayed && progress > 0.0;
+    for(int i{0}; i < total; ++i) {
+        const auto x = static_cast<double>(i * m_sampleWidth);
 
         if(m_mode & WaveMode::MinMax) {
             auto waveCentre = static_cast<double>(centre);
 
             if(drawMax) {
-                const QPointF pt1{x, waveCentre - (max.at(i) * maxScale)};
+                const QPointF pt1{x, waveCentre - (max[i] * maxScale)};
                 const QRectF rectMax{x, pt1.y(), barWidth, std::abs(pt1.y() - waveCentre)};
 
-                setupPainter(painter, isInProgress, isPlayed, m_barWidth, progress, m_colours.maxUnplayed,
-                             m_colours.maxPlayed, m_colours.maxBorder);
+                setupPainter(painter, played, m_barWidth, m_colours.maxUnplayed, m_colours.maxPlayed,
+                             m_colours.maxBorder);
 
                 painter.drawRect(rectMax);
             }
@@ -421,11 +464,11 @@ void WaveSeekBar::drawChannel(QPainter& painter, int channel, double height, int
             waveCentre += centreGap;
 
             if(drawMin) {
-                const QPointF pt2{x, waveCentre - (min.at(i) * minScale)};
+                const QPointF pt2{x, waveCentre - (min[i] * minScale)};
                 const QRectF rectMin{x, waveCentre, barWidth, std::abs(waveCentre - pt2.y())};
 
-                setupPainter(painter, isInProgress, isPlayed, m_barWidth, progress, m_colours.minUnplayed,
-                             m_colours.minPlayed, m_colours.minBorder);
+                setupPainter(painter, played, m_barWidth, m_colours.minUnplayed, m_colours.minPlayed,
+                             m_colours.minBorder);
 
                 painter.drawRect(rectMin);
             }
@@ -435,11 +478,11 @@ void WaveSeekBar::drawChannel(QPainter& painter, int channel, double height, int
             auto waveCentre = static_cast<double>(centre);
 
             if(drawMax) {
-                const QPointF pt1{x, waveCentre - (rms.at(i) / rmsScale * maxScale)};
+                const QPointF pt1{x, waveCentre - (rms[i] / rmsScale * maxScale)};
                 const QRectF rectMax{x, pt1.y(), barWidth, std::abs(pt1.y() - waveCentre)};
 
-                setupPainter(painter, isInProgress, isPlayed, m_barWidth, progress, m_colours.rmsMaxUnplayed,
-                             m_colours.rmsMaxPlayed, m_colours.rmsMaxBorder);
+                setupPainter(painter, played, m_barWidth, m_colours.rmsMaxUnplayed, m_colours.rmsMaxPlayed,
+                             m_colours.rmsMaxBorder);
 
                 painter.drawRect(rectMax);
             }
@@ -447,11 +490,11 @@ void WaveSeekBar::drawChannel(QPainter& painter, int channel, double height, int
             waveCentre += centreGap;
 
             if(drawMin) {
-                const QPointF pt2{x, waveCentre - (-rms.at(i) / rmsScale * minScale)};
+                const QPointF pt2{x, waveCentre - (-rms[i] / rmsScale * minScale)};
                 const QRectF rectMin{x, waveCentre, barWidth, std::abs(waveCentre - pt2.y())};
 
-                setupPainter(painter, isInProgress, isPlayed, m_barWidth, progress, m_colours.rmsMinUnplayed,
-                             m_colours.rmsMinPlayed, m_colours.rmsMinBorder);
+                setupPainter(painter, played, m_barWidth, m_colours.rmsMinUnplayed, m_colours.rmsMinPlayed,
+                             m_colours.rmsMinBorder);
 
                 painter.drawRect(rectMin);
             }
@@ -459,32 +502,19 @@ void WaveSeekBar::drawChannel(QPainter& painter, int channel, double height, int
     }
 }
 
-void WaveSeekBar::drawSilence(QPainter& painter, int first, int last, double y)
+void WaveSeekBar::drawSilence(QPainter& painter, int first, int last, double y, bool played)
 {
-    const auto currentPosition = static_cast<double>(positionFromValue(m_position));
-    const bool showRms         = m_data.complete && m_mode & WaveMode::Rms;
-    const auto unplayedColour  = showRms ? m_colours.rmsMaxUnplayed : m_colours.maxUnplayed;
-    const auto playedColour    = showRms ? m_colours.rmsMaxPlayed : m_colours.maxPlayed;
+    const bool showRms = m_data.complete && m_mode & WaveMode::Rms;
 
-    if(currentPosition <= first) {
-        painter.setPen(unplayedColour);
-        const QLineF unplayedLine{static_cast<double>(first), y, static_cast<double>(last), y};
-        painter.drawLine(unplayedLine);
-    }
-    else if(currentPosition >= last) {
-        painter.setPen(playedColour);
-        const QLineF playedLine{static_cast<double>(first), y, static_cast<double>(last), y};
-        painter.drawLine(playedLine);
+    if(played) {
+        painter.setPen(showRms ? m_colours.rmsMaxPlayed : m_colours.maxPlayed);
     }
     else {
-        painter.setPen(playedColour);
-        const QLineF unplayedLine{static_cast<double>(first), y, currentPosition, y};
-        painter.drawLine(unplayedLine);
-
-        painter.setPen(unplayedColour);
-        const QLineF playedLine{currentPosition, y, static_cast<double>(last), y};
-        painter.drawLine(playedLine);
+        painter.setPen(showRms ? m_colours.rmsMaxUnplayed : m_colours.maxUnplayed);
     }
+
+    const QLineF line{static_cast<double>(first), y, static_cast<double>(last), y};
+    painter.drawLine(line);
 }
 
 void WaveSeekBar::drawSeekTip()
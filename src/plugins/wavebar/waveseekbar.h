@@ -26,6 +26,7 @@
 #include <core/player/playerdefs.h>
 #include <utils/widgets/tooltip.h>
 
+#include <QPixmap>
 #include <QPointer>
 #include <QWidget>
 
@@ -54,6 +55,7 @@ signals:
 
 protected:
     void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
     void mousePressEvent(QMouseEvent* event) override;
     void mouseReleaseEvent(QMouseEvent* event) override;
@@ -66,8 +68,11 @@ private:
     void updateMousePosition(const QPoint& pos);
     void updateRange(int first, int last);
 
-    void drawChannel(QPainter& painter, int channel, double height, int first, int last, int y);
-    void drawSilence(QPainter& painter, int first, int last, double y);
+    void invalidateLayers();
+    void renderLayers();
+    void renderLayer(QPixmap& layer, bool played);
+    void drawChannel(QPainter& painter, int channel, double height, int y, bool played);
+    void drawSilence(QPainter& painter, int first, int last, double y, bool played);
     void drawSeekTip();
 
     SettingsManager* m_settings;
@@ -91,6 +96,11 @@ private:
 
     WaveModes m_mode;
     Colours m_colours;
+
+    // The full waveform rendered as unplayed and played, composited either side of the position when painting
+    QPixmap m_unplayedLayer;
+    QPixmap m_playedLayer;
+    bool m_layersValid;
 };
 } // namespace WaveBar
 } // namespace Fooyin
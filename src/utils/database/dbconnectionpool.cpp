@@ -20,18 +20,64 @@
 #include <utils/database/dbconnectionpool.h>
 
 #include <QLoggingCategory>
+#include <QSqlError>
 #include <QSqlQuery>
 
 Q_LOGGING_CATEGORY(DB_POOL, "fy.db")
 
 namespace {
-bool updatePragmas(Fooyin::DbConnection* connection)
+QString synchronousMode(Fooyin::DbConnectionProfile::Synchronous mode)
 {
-    QSqlQuery foreignKeys{connection->db()};
-    if(!foreignKeys.exec(QStringLiteral("PRAGMA foreign_keys = ON;"))) {
+    switch(mode) {
+        case(Fooyin::DbConnectionProfile::Synchronous::Off):
+            return QStringLiteral("OFF");
+        case(Fooyin::DbConnectionProfile::Synchronous::Full):
+            return QStringLiteral("FULL");
+        case(Fooyin::DbConnectionProfile::Synchronous::Normal):
+        default:
+            return QStringLiteral("NORMAL");
+    }
+}
+
+bool execPragma(const QSqlDatabase& db, const QString& pragma)
+{
+    QSqlQuery query{db};
+    if(!query.exec(QStringLiteral("PRAGMA %1;").arg(pragma))) {
+        qCWarning(DB_POOL) << "Failed to set" << pragma << ":" << query.lastError();
+        return false;
+    }
+    return true;
+}
+
+bool updatePragmas(Fooyin::DbConnection* connection, const Fooyin::DbConnectionProfile& profile)
+{
+    const QSqlDatabase db = connection->db();
+
+    if(!execPragma(db, QStringLiteral("foreign_keys = ON"))) {
         return false;
     }
 
+    // Set first so the remaining pragmas can wait on locks held by other connections
+    execPragma(db, QStringLiteral("busy_timeout = %1").arg(profile.busyTimeout.count()));
+
+    if(profile.walJournal) {
+        QSqlQuery query{db};
+        if(!query.exec(QStringLiteral("PRAGMA journal_mode = WAL;")) || !query.next()
+           || query.value(0).toString().compare(u"wal", Qt::CaseInsensitive) != 0) {
+            // Not fatal; the database just falls back to rollback journaling
+            qCInfo(DB_POOL) << "WAL journaling unavailable for" << connection->name();
+        }
+        execPragma(db, QStringLiteral("wal_autocheckpoint = %1").arg(profile.autoCheckpointPages));
+    }
+
+    execPragma(db, QStringLiteral("synchronous = %1").arg(synchronousMode(profile.synchronous)));
+    execPragma(db, QStringLiteral("mmap_size = %1").arg(profile.mmapSize));
+    // Negative values are interpreted as KiB rather than pages
+    execPragma(db, QStringLiteral("cache_size = -%1").arg(profile.cacheSize));
+    if(profile.tempStoreMemory) {
+        execPragma(db, QStringLiteral("temp_store = MEMORY"));
+    }
+
     return true;
 }
 } // namespace
@@ -44,14 +90,16 @@ struct DbConnectionPool::PrivateKey
 };
 
 DbConnectionPool::DbConnectionPool(PrivateKey /*key*/, const DbConnection::DbParams& params,
-                                   const QString& connectionName)
+                                   const QString& connectionName, const DbConnectionProfile& profile)
     : m_connectionCount{0}
     , m_prototype{params, connectionName}
+    , m_profile{profile}
 { }
 
-DbConnectionPoolPtr DbConnectionPool::create(const DbConnection::DbParams& params, const QString& connectionName)
+DbConnectionPoolPtr DbConnectionPool::create(const DbConnection::DbParams& params, const QString& connectionName,
+                                             const DbConnectionProfile& profile)
 {
-    return std::make_shared<DbConnectionPool>(PrivateKey{}, params, connectionName);
+    return std::make_shared<DbConnectionPool>(PrivateKey{}, params, connectionName, profile);
 }
 
 bool DbConnectionPool::hasThreadConnection() const
@@ -59,6 +107,26 @@ bool DbConnectionPool::hasThreadConnection() const
     return m_threadConnections.hasLocalData();
 }
 
+const DbConnectionProfile& DbConnectionPool::profile() const
+{
+    return m_profile;
+}
+
+bool DbConnectionPool::checkpoint()
+{
+    if(!m_profile.walJournal || !m_threadConnections.hasLocalData()) {
+        return false;
+    }
+
+    QSqlQuery query{m_threadConnections.localData()->db()};
+    if(!query.exec(QStringLiteral("PRAGMA wal_checkpoint(PASSIVE);"))) {
+        qCWarning(DB_POOL) << "Failed to checkpoint database:" << query.lastError();
+        return false;
+    }
+
+    return true;
+}
+
 bool DbConnectionPool::createThreadConnection()
 {
     if(m_threadConnections.hasLocalData()) {
@@ -75,7 +143,7 @@ bool DbConnectionPool::createThreadConnection()
         return false;
     }
 
-    if(!updatePragmas(connection.get())) {
+    if(!updatePragmas(connection.get(), m_profile)) {
         qCWarning(DB_POOL) << "Failed to set pragmas:" << connectionName;
         return false;
     }
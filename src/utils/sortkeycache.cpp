@@ -0,0 +1,50 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <utils/sortkeycache.h>
+
+namespace Fooyin {
+SortKeyCache::SortKeyCache(bool numericMode)
+{
+    m_collator.setNumericMode(numericMode);
+}
+
+const QCollatorSortKey& SortKeyCache::sortKey(const QString& str)
+{
+    if(const auto keyIt = m_keys.find(str); keyIt != m_keys.end()) {
+        return keyIt->second;
+    }
+    return m_keys.emplace(str, m_collator.sortKey(str)).first->second;
+}
+
+int SortKeyCache::compare(const QString& lhs, const QString& rhs)
+{
+    return sortKey(lhs).compare(sortKey(rhs));
+}
+
+size_t SortKeyCache::size() const
+{
+    return m_keys.size();
+}
+
+void SortKeyCache::clear()
+{
+    m_keys.clear();
+}
+} // namespace Fooyin
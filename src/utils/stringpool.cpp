@@ -0,0 +1,101 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <utils/stringpool.h>
+
+namespace Fooyin {
+QString StringPool::intern(const QString& str)
+{
+    if(str.isEmpty()) {
+        return str;
+    }
+
+    return internValue(str, &Shard::strings);
+}
+
+QStringList StringPool::intern(const QStringList& strs)
+{
+    if(strs.isEmpty()) {
+        return strs;
+    }
+
+    QStringList interned;
+    interned.reserve(strs.size());
+    for(const QString& str : strs) {
+        interned.append(intern(str));
+    }
+
+    return internValue(interned, &Shard::lists);
+}
+
+size_t StringPool::size() const
+{
+    size_t count{0};
+
+    for(const Shard& shard : m_shards) {
+        const std::scoped_lock lock{shard.mutex};
+        count += shard.strings.size() + shard.lists.size();
+    }
+
+    return count;
+}
+
+void StringPool::prune()
+{
+    // Copies can only be taken under the shard's lock, so a detached entry can't gain a reference while pruning
+    auto unused = [](const auto& value) {
+        return value.isDetached();
+    };
+
+    // Lists hold references to strings in any shard, so are all pruned first
+    for(Shard& shard : m_shards) {
+        const std::scoped_lock lock{shard.mutex};
+        shard.lists.removeIf(unused);
+    }
+    for(Shard& shard : m_shards) {
+        const std::scoped_lock lock{shard.mutex};
+        shard.strings.removeIf(unused);
+    }
+}
+
+void StringPool::clear()
+{
+    for(Shard& shard : m_shards) {
+        const std::scoped_lock lock{shard.mutex};
+        shard.strings.clear();
+        shard.lists.clear();
+    }
+}
+
+template <typename T>
+T StringPool::internValue(const T& value, QSet<T> Shard::*set)
+{
+    Shard& shard = m_shards.at(qHash(value) % ShardCount);
+
+    const std::scoped_lock lock{shard.mutex};
+
+    auto& values = shard.*set;
+    if(const auto valueIt = values.constFind(value); valueIt != values.cend()) {
+        return *valueIt;
+    }
+
+    values.insert(value);
+    return value;
+}
+} // namespace Fooyin
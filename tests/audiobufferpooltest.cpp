@@ -0,0 +1,158 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/engine/audiobufferpool.h"
+
+#include <core/engine/audiobuffer.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace Fooyin::Testing {
+TEST(AudioBufferPoolTest, ReusesReleasedStorage)
+{
+    AudioBufferPool pool;
+
+    auto storage = pool.acquire(3000);
+    EXPECT_EQ(4096, storage.capacity());
+    EXPECT_EQ(1, pool.allocations());
+
+    const auto* data = storage.data();
+    pool.release(std::move(storage));
+
+    // Any request in the same size class gets the same storage back
+    const auto reused = pool.acquire(2100);
+    EXPECT_EQ(data, reused.data());
+    EXPECT_TRUE(reused.empty());
+    EXPECT_EQ(1, pool.allocations());
+}
+
+TEST(AudioBufferPoolTest, SizeClasses)
+{
+    AudioBufferPool pool;
+
+    EXPECT_EQ(0, pool.acquire(0).capacity());
+    EXPECT_EQ(0, pool.allocations());
+
+    EXPECT_EQ(1024, pool.acquire(1).capacity());
+    EXPECT_EQ(8192, pool.acquire(8192).capacity());
+
+    // Storage smaller than its class is rounded down when released
+    AudioBufferPool::Storage storage;
+    storage.reserve(6000);
+    const auto* data = storage.data();
+    pool.release(std::move(storage));
+
+    EXPECT_EQ(data, pool.acquire(4096).data());
+}
+
+TEST(AudioBufferPoolTest, KeepsLimitedStoragePerClass)
+{
+    AudioBufferPool pool;
+
+    std::vector<AudioBufferPool::Storage> storages;
+    for(size_t i{0}; i <= AudioBufferPool::MaxPerClass; ++i) {
+        storages.push_back(pool.acquire(4096));
+    }
+    for(auto& storage : storages) {
+        pool.release(std::move(storage));
+    }
+
+    const uint64_t allocations = pool.allocations();
+    for(size_t i{0}; i <= AudioBufferPool::MaxPerClass; ++i) {
+        storages.at(i) = pool.acquire(4096);
+    }
+
+    // Only the storage which didn't fit in the class needs allocating again
+    EXPECT_EQ(allocations + 1, pool.allocations());
+
+    // Too large to be pooled
+    pool.acquire(size_t{1} << (AudioBufferPool::MaxClassShift + 1));
+    EXPECT_EQ(allocations + 2, pool.allocations());
+}
+
+TEST(AudioBufferPoolTest, SharedBetweenThreads)
+{
+    AudioBufferPool pool;
+
+    auto churn = [&pool]() {
+        for(int i{0}; i < 10000; ++i) {
+            auto storage = pool.acquire(2048);
+            storage.resize(2048, std::byte{1});
+            pool.release(std::move(storage));
+
+            void* object = pool.allocateObject();
+            pool.freeObject(object);
+        }
+    };
+
+    std::thread producer{churn};
+    churn();
+    producer.join();
+
+    // Each thread holds at most one block of each kind at a time
+    EXPECT_LE(pool.allocations(), 4);
+}
+
+TEST(AudioBufferPoolTest, ObjectsAreRecycled)
+{
+    AudioBufferPool pool;
+
+    void* object = pool.allocateObject();
+    pool.freeObject(object);
+
+    EXPECT_EQ(object, pool.allocateObject());
+    EXPECT_EQ(1, pool.allocations());
+
+    pool.freeObject(object);
+}
+
+TEST(AudioBufferPoolTest, SteadyStateBuffersDontAllocate)
+{
+    const AudioFormat format{SampleFormat::S16, 44100, 2};
+    const std::vector<std::byte> data(format.bytesForDuration(100));
+
+    auto decodeBuffer = [&]() {
+        AudioBuffer buffer{format, 0};
+        buffer.reserve(data.size());
+        buffer.append(data.data(), data.size() / 2);
+        buffer.append(data.data(), data.size() / 2);
+        return buffer;
+    };
+
+    auto process = [&]() {
+        const AudioBuffer buffer = decodeBuffer();
+        AudioBuffer copy{buffer};
+        copy.detach();
+    };
+
+    // Warm up the shared pool
+    process();
+
+    const uint64_t allocations = AudioBufferPool::instance().allocations();
+
+    for(int i{0}; i < 100; ++i) {
+        process();
+    }
+
+    EXPECT_EQ(allocations, AudioBufferPool::instance().allocations());
+}
+} // namespace Fooyin::Testing
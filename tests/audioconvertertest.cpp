@@ -0,0 +1,280 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "testutils.h"
+
+#include <core/engine/audioconverter.h>
+#include <core/engine/audioformat.h>
+#include <utils/math.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cfenv>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using Fooyin::AudioFormat;
+using Fooyin::SampleFormat;
+
+namespace {
+constexpr std::array KernelFormats{SampleFormat::S16, SampleFormat::S24, SampleFormat::S32, SampleFormat::F32};
+constexpr std::array FrameCounts{1, 7, 33, 1000};
+
+template <typename T>
+T readSample(const std::byte* data)
+{
+    T sample;
+    std::memcpy(&sample, data, sizeof(T));
+    return sample;
+}
+
+template <typename T>
+void writeSample(std::byte* data, T sample)
+{
+    std::memcpy(data, &sample, sizeof(T));
+}
+
+// Per-sample conversion as performed by the original implementation
+void referenceSample(SampleFormat inFormat, const std::byte* input, SampleFormat outFormat, std::byte* output)
+{
+    const int prevRoundingMode = std::fegetround();
+    std::fesetround(FE_TONEAREST);
+
+    const bool inIsS32  = inFormat == SampleFormat::S24 || inFormat == SampleFormat::S32;
+    const bool outIsS32 = outFormat == SampleFormat::S24 || outFormat == SampleFormat::S32;
+
+    if(inFormat == SampleFormat::S16) {
+        const auto sample = readSample<int16_t>(input);
+        if(outFormat == SampleFormat::S16) {
+            writeSample(output, sample);
+        }
+        else if(outIsS32) {
+            writeSample<int32_t>(output, sample << 16);
+        }
+        else {
+            writeSample(output, static_cast<float>(sample) / static_cast<float>(0x8000));
+        }
+    }
+    else if(inIsS32) {
+        const auto sample = readSample<int32_t>(input);
+        if(outFormat == SampleFormat::S16) {
+            writeSample(output, static_cast<int16_t>(sample >> 16));
+        }
+        else if(outIsS32) {
+            writeSample(output, sample);
+        }
+        else {
+            writeSample(output, static_cast<float>(sample) / static_cast<float>(0x80000000));
+        }
+    }
+    else {
+        const auto sample = readSample<float>(input);
+        if(outFormat == SampleFormat::S16) {
+            const int intSample = Fooyin::Math::fltToInt(sample * 0x8000);
+            writeSample(output, static_cast<int16_t>(std::clamp(intSample, -32768, 32767)));
+        }
+        else if(outIsS32) {
+            writeSample<int32_t>(output, Fooyin::Math::fltToInt(sample * static_cast<float>(0x80000000)));
+        }
+        else {
+            writeSample(output, sample);
+        }
+    }
+
+    std::fesetround(prevRoundingMode);
+}
+
+std::vector<std::byte> randomInput(const AudioFormat& format, int frames)
+{
+    auto input = Fooyin::Testing::randomAudio(format, frames, 1.2F);
+
+    if(format.sampleFormat() == SampleFormat::F32) {
+        // Include values which need clamping or land exactly between two integers
+        const std::array special{1.0F, -1.0F, 1.5F, -1.5F, 0.5F / 0x8000, 1.5F / 0x8000, 2.5F / 0x8000, 100.0F};
+
+        const auto samples = std::min(special.size(), static_cast<size_t>(frames) * format.channelCount());
+        for(size_t i{0}; i < samples; ++i) {
+            writeSample(input.data() + (i * sizeof(float)), special.at(i));
+        }
+    }
+
+    return input;
+}
+
+// Mono input is copied to every output channel, otherwise channels are matched by index
+std::vector<std::byte> referenceConvert(const AudioFormat& inFormat, const std::vector<std::byte>& input,
+                                        const AudioFormat& outFormat, int frames)
+{
+    std::vector<std::byte> output(outFormat.bytesForFrames(frames));
+
+    const int inBps  = inFormat.bytesPerSample();
+    const int outBps = outFormat.bytesPerSample();
+
+    for(int frame{0}; frame < frames; ++frame) {
+        for(int channel{0}; channel < outFormat.channelCount(); ++channel) {
+            const int inChannel = inFormat.channelCount() == 1 ? 0 : channel;
+            referenceSample(inFormat.sampleFormat(),
+                            input.data() + ((frame * inFormat.channelCount() + inChannel) * inBps),
+                            outFormat.sampleFormat(),
+                            output.data() + ((frame * outFormat.channelCount() + channel) * outBps));
+        }
+    }
+
+    return output;
+}
+
+void verifyConversion(int inChannels, int outChannels)
+{
+    for(const SampleFormat inSampleFormat : KernelFormats) {
+        for(const SampleFormat outSampleFormat : KernelFormats) {
+            for(const int frames : FrameCounts) {
+                const AudioFormat inFormat{inSampleFormat, 44100, inChannels};
+                const AudioFormat outFormat{outSampleFormat, 44100, outChannels};
+
+                SCOPED_TRACE(testing::Message() << "in: " << inFormat.prettyFormat().toStdString()
+                                                << ", out: " << outFormat.prettyFormat().toStdString()
+                                                << ", frames: " << frames);
+
+                const auto input    = randomInput(inFormat, frames);
+                const auto expected = referenceConvert(inFormat, input, outFormat, frames);
+
+                std::vector<std::byte> output(outFormat.bytesForFrames(frames));
+                ASSERT_TRUE(Fooyin::Audio::convert(inFormat, input.data(), outFormat, output.data(), frames));
+                EXPECT_TRUE(output == expected);
+            }
+        }
+    }
+}
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(AudioConverterTest, Stereo)
+{
+    verifyConversion(2, 2);
+}
+
+TEST(AudioConverterTest, Surround)
+{
+    verifyConversion(6, 6);
+}
+
+TEST(AudioConverterTest, StereoToMono)
+{
+    verifyConversion(2, 1);
+}
+
+TEST(AudioConverterTest, MonoToStereo)
+{
+    verifyConversion(1, 2);
+}
+
+TEST(AudioConverterTest, PreservesRoundingMode)
+{
+    const AudioFormat inFormat{SampleFormat::F32, 44100, 2};
+    const AudioFormat outFormat{SampleFormat::S16, 44100, 2};
+
+    const auto input = randomInput(inFormat, 64);
+    std::vector<std::byte> output(outFormat.bytesForFrames(64));
+
+    const int prevRoundingMode = std::fegetround();
+    std::fesetround(FE_UPWARD);
+
+    Fooyin::Audio::convert(inFormat, input.data(), outFormat, output.data(), 64);
+    EXPECT_EQ(FE_UPWARD, std::fegetround());
+
+    std::fesetround(prevRoundingMode);
+
+    EXPECT_TRUE(output == referenceConvert(inFormat, input, outFormat, 64));
+}
+
+TEST(AudioConverterTest, Interleave)
+{
+    uint32_t seed{RandomSeed};
+
+    for(const int bytesPerSample : {1, 2, 4, 8}) {
+        for(int channels{1}; channels <= 8; ++channels) {
+            for(const int frames : FrameCounts) {
+                SCOPED_TRACE(testing::Message() << "bps: " << bytesPerSample << ", channels: " << channels
+                                                << ", frames: " << frames);
+
+                const auto planeBytes = static_cast<size_t>(frames * bytesPerSample);
+
+                std::vector<std::vector<std::byte>> planes;
+                std::vector<const std::byte*> planeData;
+                for(int channel{0}; channel < channels; ++channel) {
+                    planeData.push_back(planes.emplace_back(randomBytes(planeBytes, seed++)).data());
+                }
+
+                std::vector<std::byte> expected(planeBytes * channels);
+                for(int frame{0}; frame < frames; ++frame) {
+                    for(int channel{0}; channel < channels; ++channel) {
+                        std::memcpy(expected.data() + ((frame * channels + channel) * bytesPerSample),
+                                    planes.at(channel).data() + (frame * bytesPerSample), bytesPerSample);
+                    }
+                }
+
+                std::vector<std::byte> output(expected.size());
+                Fooyin::Audio::interleave(planeData.data(), channels, bytesPerSample, frames, output.data());
+                EXPECT_TRUE(output == expected);
+            }
+        }
+    }
+}
+
+TEST(AudioConverterTest, ApplyGainSaturates)
+{
+    const AudioFormat format{SampleFormat::S16, 44100, 2};
+
+    // Enough samples to cover both the vectorised and scalar paths
+    std::vector<int16_t> samples(21);
+    for(size_t i{0}; i < samples.size(); ++i) {
+        samples.at(i) = static_cast<int16_t>((i % 2 == 0 ? 1 : -1) * static_cast<int>(i * 1000));
+    }
+
+    std::vector<std::byte> data(samples.size() * sizeof(int16_t));
+    std::memcpy(data.data(), samples.data(), data.size());
+
+    Fooyin::Audio::applyGain(format, data.data(), 10, 2.0F);
+
+    for(size_t i{0}; i < 20; ++i) {
+        const int expected = std::clamp(samples.at(i) * 2, -32768, 32767);
+        EXPECT_EQ(expected, readSample<int16_t>(data.data() + (i * sizeof(int16_t))));
+    }
+    // Frames past the count are left alone
+    EXPECT_EQ(samples.at(20), readSample<int16_t>(data.data() + (20 * sizeof(int16_t))));
+}
+
+TEST(AudioConverterTest, ApplyGainFloat)
+{
+    const AudioFormat format{SampleFormat::F32, 44100, 1};
+
+    const auto input = randomInput(format, 37);
+    auto output      = input;
+
+    Fooyin::Audio::applyGain(format, output.data(), 37, 0.5F);
+
+    for(size_t i{0}; i < 37; ++i) {
+        const auto offset = i * sizeof(float);
+        EXPECT_FLOAT_EQ(readSample<float>(input.data() + offset) * 0.5F, readSample<float>(output.data() + offset));
+    }
+}
+} // namespace Fooyin::Testing
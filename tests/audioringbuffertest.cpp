@@ -0,0 +1,286 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/engine/audioringbuffer.h"
+
+#include <core/engine/audiobuffer.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+// 1 frame per ms
+const Fooyin::AudioFormat Format{Fooyin::SampleFormat::S16, 1000, 1};
+
+Fooyin::AudioBuffer makeBuffer(int16_t firstSample, int frames, uint64_t startTime)
+{
+    Fooyin::AudioBuffer buffer{Format, startTime};
+    buffer.resize(static_cast<size_t>(Format.bytesForFrames(frames)));
+
+    for(int i{0}; i < frames; ++i) {
+        const auto sample = static_cast<int16_t>(firstSample + i);
+        std::memcpy(buffer.data() + (i * sizeof(int16_t)), &sample, sizeof(int16_t));
+    }
+
+    return buffer;
+}
+
+std::vector<int16_t> readSamples(Fooyin::AudioRingBuffer& ringBuffer, int frames,
+                                 Fooyin::AudioRingBuffer::ReadResult& result)
+{
+    std::vector<int16_t> samples(frames);
+    result = ringBuffer.read(reinterpret_cast<std::byte*>(samples.data()), Format.bytesForFrames(frames));
+    samples.resize(Format.framesForBytes(result.bytes));
+    return samples;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class AudioRingBufferTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_buffer.clear(static_cast<size_t>(Format.bytesForFrames(100)));
+        m_buffer.acknowledgeClear();
+    }
+
+    AudioRingBuffer m_buffer;
+};
+
+TEST_F(AudioRingBufferTest, BlockedUntilClearAcknowledged)
+{
+    AudioRingBuffer buffer;
+    EXPECT_EQ(0, buffer.freeBytes());
+
+    buffer.clear(64);
+    EXPECT_TRUE(buffer.clearPending());
+    EXPECT_EQ(0, buffer.freeBytes());
+    EXPECT_FALSE(buffer.write(makeBuffer(0, 10, 0)));
+
+    buffer.acknowledgeClear();
+    EXPECT_FALSE(buffer.clearPending());
+    EXPECT_EQ(64, buffer.freeBytes());
+}
+
+TEST_F(AudioRingBufferTest, ReadsWrittenData)
+{
+    ASSERT_TRUE(m_buffer.write(makeBuffer(0, 30, 500)));
+    EXPECT_EQ(Format.bytesForFrames(30), m_buffer.bufferedBytes());
+    EXPECT_EQ(Format.bytesForFrames(70), m_buffer.freeBytes());
+
+    AudioRingBuffer::ReadResult result;
+    const auto samples = readSamples(m_buffer, 10, result);
+
+    ASSERT_EQ(10, samples.size());
+    EXPECT_EQ(0, samples.front());
+    EXPECT_EQ(9, samples.back());
+    EXPECT_EQ(500, result.startTime);
+    EXPECT_EQ(Format, result.format);
+    EXPECT_FALSE(result.endOfTrack);
+    EXPECT_EQ(Format.bytesForFrames(20), m_buffer.bufferedBytes());
+}
+
+TEST_F(AudioRingBufferTest, LowWaterCallbackCalledOnce)
+{
+    int calls{0};
+    m_buffer.setLowWaterCallback([&calls]() { ++calls; });
+
+    ASSERT_TRUE(m_buffer.write(makeBuffer(0, 50, 0)));
+
+    // Already at or below the mark
+    EXPECT_FALSE(m_buffer.armLowWater(static_cast<size_t>(Format.bytesForFrames(50))));
+    EXPECT_TRUE(m_buffer.armLowWater(static_cast<size_t>(Format.bytesForFrames(20))));
+
+    AudioRingBuffer::ReadResult result;
+    readSamples(m_buffer, 20, result);
+    EXPECT_EQ(0, calls);
+
+    readSamples(m_buffer, 10, result);
+    EXPECT_EQ(1, calls);
+
+    readSamples(m_buffer, 10, result);
+    EXPECT_EQ(1, calls);
+
+    ASSERT_TRUE(m_buffer.write(makeBuffer(50, 50, 50)));
+    EXPECT_TRUE(m_buffer.armLowWater(static_cast<size_t>(Format.bytesForFrames(20))));
+    m_buffer.disarmLowWater();
+
+    readSamples(m_buffer, 100, result);
+    EXPECT_EQ(1, calls);
+}
+
+TEST_F(AudioRingBufferTest, LowWaterWaitsForPendingClear)
+{
+    int calls{0};
+    m_buffer.setLowWaterCallback([&calls]() { ++calls; });
+
+    ASSERT_TRUE(m_buffer.write(makeBuffer(0, 10, 0)));
+    m_buffer.clear();
+
+    // Nothing can be written until the clear is acknowledged, so the mark stays armed
+    EXPECT_TRUE(m_buffer.armLowWater(static_cast<size_t>(Format.bytesForFrames(50))));
+    EXPECT_EQ(0, calls);
+
+    m_buffer.acknowledgeClear();
+    EXPECT_EQ(1, calls);
+    EXPECT_FALSE(m_buffer.armLowWater(static_cast<size_t>(Format.bytesForFrames(50))));
+}
+
+TEST_F(AudioRingBufferTest, TimestampsFollowReadPosition)
+{
+    ASSERT_TRUE(m_buffer.write(makeBuffer(0, 20, 1000)));
+    ASSERT_TRUE(m_buffer.write(makeBuffer(20, 20, 2000)));
+
+    AudioRingBuffer::ReadResult result;
+
+    readSamples(m_buffer, 5, result);
+    EXPECT_EQ(1000, result.startTime);
+
+    // Reads stop at buffer boundaries so each timestamp is exact
+    auto samples = readSamples(m_buffer, 100, result);
+    EXPECT_EQ(15, samples.size());
+    EXPECT_EQ(1005, result.startTime);
+
+    samples = readSamples(m_buffer, 100, result);
+    ASSERT_EQ(20, samples.size());
+    EXPECT_EQ(20, samples.front());
+    EXPECT_EQ(2000, result.startTime);
+}
+
+TEST_F(AudioRingBufferTest, WrapsAround)
+{
+    AudioRingBuffer::ReadResult result;
+    int16_t next{0};
+
+    for(int i{0}; i < 10; ++i) {
+        ASSERT_TRUE(m_buffer.write(makeBuffer(next, 70, 0)));
+
+        for(const int frames : {40, 30}) {
+            const auto samples = readSamples(m_buffer, frames, result);
+            ASSERT_EQ(frames, samples.size());
+            for(const int16_t sample : samples) {
+                ASSERT_EQ(next++, sample);
+            }
+        }
+    }
+}
+
+TEST_F(AudioRingBufferTest, RejectsOversizedWrite)
+{
+    ASSERT_TRUE(m_buffer.write(makeBuffer(0, 60, 0)));
+    EXPECT_FALSE(m_buffer.write(makeBuffer(0, 50, 0)));
+    EXPECT_TRUE(m_buffer.write(makeBuffer(0, 40, 0)));
+    EXPECT_EQ(0, m_buffer.freeBytes());
+}
+
+TEST_F(AudioRingBufferTest, SignalsEndOfTrack)
+{
+    ASSERT_TRUE(m_buffer.write(makeBuffer(0, 10, 0)));
+    ASSERT_TRUE(m_buffer.writeEnd());
+    ASSERT_TRUE(m_buffer.write(makeBuffer(100, 10, 0)));
+
+    AudioRingBuffer::ReadResult result;
+
+    auto samples = readSamples(m_buffer, 100, result);
+    EXPECT_EQ(10, samples.size());
+    EXPECT_TRUE(result.endOfTrack);
+
+    samples = readSamples(m_buffer, 100, result);
+    ASSERT_EQ(10, samples.size());
+    EXPECT_EQ(100, samples.front());
+    EXPECT_FALSE(result.endOfTrack);
+
+    // An end marker is reported even with no data left
+    ASSERT_TRUE(m_buffer.writeEnd());
+    samples = readSamples(m_buffer, 100, result);
+    EXPECT_TRUE(samples.empty());
+    EXPECT_TRUE(result.endOfTrack);
+}
+
+TEST_F(AudioRingBufferTest, ClearDiscardsData)
+{
+    ASSERT_TRUE(m_buffer.write(makeBuffer(0, 50, 0)));
+    ASSERT_TRUE(m_buffer.writeEnd());
+
+    m_buffer.clear(static_cast<size_t>(Format.bytesForFrames(200)));
+    EXPECT_EQ(0, m_buffer.freeBytes());
+
+    AudioRingBuffer::ReadResult result;
+    auto samples = readSamples(m_buffer, 100, result);
+    EXPECT_TRUE(samples.empty());
+    EXPECT_FALSE(result.endOfTrack);
+    EXPECT_EQ(0, m_buffer.bufferedBytes());
+    EXPECT_EQ(Format.bytesForFrames(200), m_buffer.freeBytes());
+
+    ASSERT_TRUE(m_buffer.write(makeBuffer(7, 150, 3000)));
+    samples = readSamples(m_buffer, 200, result);
+    ASSERT_EQ(150, samples.size());
+    EXPECT_EQ(7, samples.front());
+    EXPECT_EQ(3000, result.startTime);
+}
+
+TEST_F(AudioRingBufferTest, ConcurrentProducerConsumer)
+{
+    constexpr int TotalFrames = 100'000;
+
+    std::thread producer{[this]() {
+        int written{0};
+        while(written < TotalFrames) {
+            const int freeFrames = Format.framesForBytes(static_cast<int>(m_buffer.freeBytes()));
+            const int frames     = std::min({37, TotalFrames - written, freeFrames});
+            if(frames == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            ASSERT_TRUE(m_buffer.write(makeBuffer(static_cast<int16_t>(written), frames, written)));
+            written += frames;
+        }
+        while(!m_buffer.writeEnd()) {
+            std::this_thread::yield();
+        }
+    }};
+
+    AudioRingBuffer::ReadResult result;
+    int read{0};
+    bool ended{false};
+
+    while(!ended) {
+        const auto samples = readSamples(m_buffer, 23, result);
+        if(samples.empty()) {
+            std::this_thread::yield();
+        }
+        else {
+            ASSERT_EQ(read, result.startTime);
+        }
+        for(const int16_t sample : samples) {
+            ASSERT_EQ(static_cast<int16_t>(read++), sample);
+        }
+        ended = result.endOfTrack;
+    }
+
+    producer.join();
+
+    EXPECT_EQ(TotalFrames, read);
+}
+} // namespace Fooyin::Testing
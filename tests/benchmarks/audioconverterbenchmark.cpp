@@ -0,0 +1,80 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/engine/audioconverter.h>
+#include <core/engine/audioformat.h>
+
+#include <benchmark/benchmark.h>
+
+#include <utility>
+#include <vector>
+
+namespace {
+// Roughly 100ms of audio at 44.1kHz, a typical decoder buffer size
+constexpr auto FrameCount = 4096;
+
+void convertSamples(benchmark::State& state)
+{
+    const auto inSampleFormat  = static_cast<Fooyin::SampleFormat>(state.range(0));
+    const auto outSampleFormat = static_cast<Fooyin::SampleFormat>(state.range(1));
+    const auto inChannels      = static_cast<int>(state.range(2));
+    const auto outChannels     = static_cast<int>(state.range(3));
+
+    const Fooyin::AudioFormat inFormat{inSampleFormat, 44100, inChannels};
+    const Fooyin::AudioFormat outFormat{outSampleFormat, 44100, outChannels};
+
+    const std::vector<std::byte> input(inFormat.bytesForFrames(FrameCount));
+    std::vector<std::byte> output(outFormat.bytesForFrames(FrameCount));
+
+    for(auto _ : state) {
+        Fooyin::Audio::convert(inFormat, input.data(), outFormat, output.data(), FrameCount);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * FrameCount);
+    state.SetBytesProcessed(state.iterations() * inFormat.bytesForFrames(FrameCount));
+}
+
+void conversionArgs(benchmark::internal::Benchmark* benchmark)
+{
+    using Fooyin::SampleFormat;
+
+    benchmark->ArgNames({"in", "out", "inChannels", "outChannels"});
+
+    // Specialised kernels
+    for(const auto& [in, out] : {std::pair{SampleFormat::F32, SampleFormat::S16},
+                                 std::pair{SampleFormat::F32, SampleFormat::S32},
+                                 std::pair{SampleFormat::S16, SampleFormat::F32},
+                                 std::pair{SampleFormat::S32, SampleFormat::F32},
+                                 std::pair{SampleFormat::S16, SampleFormat::S32},
+                                 std::pair{SampleFormat::S32, SampleFormat::S16},
+                                 std::pair{SampleFormat::F32, SampleFormat::F32}}) {
+        benchmark->Args({static_cast<int64_t>(in), static_cast<int64_t>(out), 2, 2});
+    }
+    benchmark->Args({static_cast<int64_t>(SampleFormat::S16), static_cast<int64_t>(SampleFormat::F32), 2, 1});
+    benchmark->Args({static_cast<int64_t>(SampleFormat::S16), static_cast<int64_t>(SampleFormat::F32), 1, 2});
+
+    // Generic path
+    benchmark->Args({static_cast<int64_t>(SampleFormat::U8), static_cast<int64_t>(SampleFormat::F32), 2, 2});
+    benchmark->Args({static_cast<int64_t>(SampleFormat::F32), static_cast<int64_t>(SampleFormat::U8), 2, 2});
+}
+} // namespace
+
+BENCHMARK(convertSamples)->Apply(conversionArgs);
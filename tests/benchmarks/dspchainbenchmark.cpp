@@ -0,0 +1,86 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/engine/dsp/crossfeed.h"
+#include "core/engine/dsp/dspchain.h"
+#include "core/engine/dsp/equaliser.h"
+
+#include <core/engine/audiobuffer.h>
+#include <core/engine/audioconverter.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+// A typical renderer write at 44.1kHz
+constexpr auto FrameCount = 4096;
+
+Fooyin::DspEntries referenceChain()
+{
+    return {{QStringLiteral("Equaliser"),
+             []() {
+                 return std::make_unique<Fooyin::Equaliser>(
+                     Fooyin::Equaliser::Gains{4.0, 3.0, 1.5, 0.0, -1.0, -1.5, 0.0, 1.0, 2.5, 3.0});
+             }},
+            {QStringLiteral("Crossfeed"), []() { return std::make_unique<Fooyin::Crossfeed>(); }}};
+}
+
+void processChain(benchmark::State& state)
+{
+    const auto sampleFormat = static_cast<Fooyin::SampleFormat>(state.range(0));
+    const Fooyin::AudioFormat format{sampleFormat, 44100, 2};
+
+    Fooyin::DspChain chain;
+    chain.update(referenceChain());
+    chain.prepare(format);
+
+    const Fooyin::AudioFormat floatFormat{Fooyin::SampleFormat::F32, 44100, 2};
+
+    std::mt19937 rng{1234};
+    std::uniform_real_distribution<float> dist{-0.5F, 0.5F};
+    std::vector<float> samples(static_cast<size_t>(FrameCount) * 2);
+    std::ranges::generate(samples, [&]() { return dist(rng); });
+
+    Fooyin::AudioBuffer buffer{format, 0};
+    buffer.resize(static_cast<size_t>(format.bytesForFrames(FrameCount)));
+    Fooyin::Audio::convert(floatFormat, reinterpret_cast<const std::byte*>(samples.data()), format, buffer.data(),
+                           FrameCount);
+
+    for(auto _ : state) {
+        chain.process(buffer);
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+
+    const int blocks = (FrameCount + chain.blockFrames() - 1) / chain.blockFrames();
+
+    state.SetItemsProcessed(state.iterations() * FrameCount);
+    // Time per block of the negotiated size
+    state.counters["per_block"] = benchmark::Counter(static_cast<double>(state.iterations()) * blocks,
+                                                     benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+} // namespace
+
+BENCHMARK(processChain)
+    ->ArgName("format")
+    ->Arg(static_cast<int64_t>(Fooyin::SampleFormat::F32))
+    ->Arg(static_cast<int64_t>(Fooyin::SampleFormat::S16));
@@ -0,0 +1,114 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/engine/ffmpeg/ffmpeginput.h"
+
+#include <core/engine/audiobuffer.h>
+#include <core/engine/audioconverter.h>
+
+#include <QBuffer>
+#include <QFile>
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace {
+// Decoded repeatedly, seeking back to the start, to stand in for a long file
+constexpr auto FlacFile   = ":/audio/audiotest.flac";
+constexpr auto PassCount  = 50;
+constexpr size_t ReadSize = 32768;
+
+// Decodes the file and discards the output, so only decoding and interleaving is measured
+void decodeFlac(benchmark::State& state)
+{
+    QFile file{QString::fromLatin1(FlacFile)};
+    if(!file.open(QIODevice::ReadOnly)) {
+        state.SkipWithError("Could not open test file");
+        return;
+    }
+
+    QByteArray data = file.readAll();
+    QBuffer device{&data};
+    device.open(QIODevice::ReadOnly);
+
+    Fooyin::FFmpegDecoder decoder;
+    const Fooyin::Track track{QString::fromLatin1(FlacFile)};
+    const auto format = decoder.init({QString::fromLatin1(FlacFile), &device, nullptr}, track,
+                                     Fooyin::AudioDecoder::NoLooping);
+    if(!format) {
+        state.SkipWithError("Could not initialise decoder");
+        return;
+    }
+
+    int64_t frames{0};
+
+    for(auto _ : state) {
+        for(int pass{0}; pass < PassCount; ++pass) {
+            decoder.seek(0);
+            decoder.start();
+            while(true) {
+                const auto buffer = decoder.readBuffer(ReadSize);
+                if(!buffer.isValid() || buffer.byteCount() == 0) {
+                    break;
+                }
+                frames += buffer.frameCount();
+                benchmark::DoNotOptimize(buffer.constData().data());
+            }
+        }
+    }
+
+    state.counters["frames_per_second"] = benchmark::Counter(static_cast<double>(frames), benchmark::Counter::kIsRate);
+}
+
+void interleaveFrames(benchmark::State& state)
+{
+    const auto channels       = static_cast<int>(state.range(0));
+    const auto bytesPerSample = static_cast<int>(state.range(1));
+    constexpr int frameCount  = 4608;
+
+    std::vector<std::vector<std::byte>> planes(channels, std::vector<std::byte>(frameCount * bytesPerSample));
+    std::vector<const std::byte*> planeData;
+    for(const auto& plane : planes) {
+        planeData.push_back(plane.data());
+    }
+
+    std::vector<std::byte> output(static_cast<size_t>(frameCount * bytesPerSample * channels));
+
+    for(auto _ : state) {
+        Fooyin::Audio::interleave(planeData.data(), channels, bytesPerSample, frameCount, output.data());
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * frameCount);
+}
+} // namespace
+
+BENCHMARK(decodeFlac)->Unit(benchmark::kMillisecond);
+// A FLAC frame holds 4608 samples per channel
+BENCHMARK(interleaveFrames)
+    ->ArgNames({"channels", "bps"})
+    ->Args({2, 2})
+    ->Args({2, 4})
+    ->Args({6, 2})
+    ->Args({6, 4})
+    ->Args({8, 2})
+    ->Args({8, 4})
+    ->Args({3, 4});
@@ -0,0 +1,116 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/scripting/scriptparser.h>
+#include <core/track.h>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+constexpr auto TrackCount = 100'000;
+
+// Scripts from scriptparsertest, plus a few typical playlist/sort scripts
+const QStringList& scripts()
+{
+    static const QStringList scripts{
+        QStringLiteral("I am a test."),
+        QStringLiteral(R"("I am a \% test.")"),
+        QStringLiteral(R"("I %am% a $test$.")"),
+        QStringLiteral("$num(1,2)"),
+        QStringLiteral("$replace(A replace test,t,c)"),
+        QStringLiteral("$slice(A slice test,2,5)"),
+        QStringLiteral("$if($stricmp(cmp,cMp),true,false)"),
+        QStringLiteral("$add(1,2)"),
+        QStringLiteral("$max(3,2,3,9,23,100,4)"),
+        QStringLiteral("$ifgreater(23,32,true,false)"),
+        QStringLiteral("%title%"),
+        QStringLiteral("%title%[ - %album%]"),
+        QStringLiteral("%genre%"),
+        QStringLiteral("%<genre>%"),
+        QStringLiteral("%genre% - %artist%"),
+        QStringLiteral("%<genre>% - %<artist>%"),
+        QStringLiteral("[%disc% - %track%]"),
+        QStringLiteral("%albumartist% - %year% - %album% - $num(%disc%,5) - $num(%track%,5) - %title%"),
+        QStringLiteral("[%disc%.]$num(%track%,2). %title%[ ($if2(%composer%,%performer%))]"),
+    };
+    return scripts;
+}
+
+Fooyin::TrackList generateTracks()
+{
+    Fooyin::TrackList tracks;
+    tracks.reserve(TrackCount);
+
+    for(int i{0}; i < TrackCount; ++i) {
+        Fooyin::Track track{QStringLiteral("/music/artist%1/album%2/%3.flac").arg(i / 100).arg(i / 10).arg(i)};
+        track.setId(i);
+        track.setTitle(QStringLiteral("Title %1").arg(i));
+        track.setAlbum(QStringLiteral("Album %1").arg(i / 10));
+        track.setArtists({QStringLiteral("Artist %1").arg(i / 100), QStringLiteral("Guest %1").arg(i % 7)});
+        track.setAlbumArtists({QStringLiteral("Artist %1").arg(i / 100)});
+        track.setGenres({QStringLiteral("Pop"), QStringLiteral("Rock")});
+        track.setTrackNumber(QString::number(i % 10 + 1));
+        if(i % 3 == 0) {
+            track.setDiscNumber(QString::number(i % 2 + 1));
+        }
+        track.setYear(1970 + (i % 50));
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+
+void evaluateScripts(benchmark::State& state, bool compiled)
+{
+    const auto tracks = generateTracks();
+
+    Fooyin::ScriptParser parser;
+    std::vector<Fooyin::ParsedScript> parsedScripts;
+    for(const QString& script : scripts()) {
+        auto parsed = parser.parse(script);
+        if(!compiled) {
+            parsed.program.reset();
+        }
+        parsedScripts.push_back(parsed);
+    }
+
+    for(auto _ : state) {
+        for(const auto& script : parsedScripts) {
+            for(const auto& track : tracks) {
+                benchmark::DoNotOptimize(parser.evaluate(script, track));
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * TrackCount * static_cast<int64_t>(parsedScripts.size()));
+}
+
+void interpretedScripts(benchmark::State& state)
+{
+    evaluateScripts(state, false);
+}
+
+void compiledScripts(benchmark::State& state)
+{
+    evaluateScripts(state, true);
+}
+} // namespace
+
+BENCHMARK(interpretedScripts)->Unit(benchmark::kMillisecond);
+BENCHMARK(compiledScripts)->Unit(benchmark::kMillisecond);
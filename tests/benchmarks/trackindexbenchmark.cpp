@@ -0,0 +1,157 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/library/librarytrackindex.h"
+
+#include <core/track.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+
+namespace {
+constexpr auto LookupCount = 5000;
+
+Fooyin::TrackList generateTracks(int count)
+{
+    Fooyin::TrackList tracks;
+    tracks.reserve(count);
+
+    for(int i{0}; i < count; ++i) {
+        Fooyin::Track track{QStringLiteral("/music/artist%1/album%2/%3.flac").arg(i / 100).arg(i / 10).arg(i)};
+        track.setId(i);
+        track.setArtists({QStringLiteral("Artist %1").arg(i / 100)});
+        track.setAlbum(QStringLiteral("Album %1").arg(i / 10));
+        track.setTitle(QStringLiteral("Title %1").arg(i));
+        track.generateHash();
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+
+Fooyin::TrackIds randomIds(int count)
+{
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> dist{0, count - 1};
+
+    Fooyin::TrackIds ids(LookupCount);
+    std::ranges::generate(ids, [&]() { return dist(gen); });
+    return ids;
+}
+
+void linearTracksForIds(benchmark::State& state)
+{
+    const auto count           = static_cast<int>(state.range(0));
+    const auto tracks          = generateTracks(count);
+    const Fooyin::TrackIds ids = randomIds(count);
+
+    for(auto _ : state) {
+        Fooyin::TrackList found;
+        found.reserve(ids.size());
+        for(const int id : ids) {
+            auto trackIt = std::ranges::find_if(tracks, [id](const Fooyin::Track& track) { return track.id() == id; });
+            if(trackIt != tracks.cend()) {
+                found.push_back(*trackIt);
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(state.iterations() * LookupCount);
+}
+
+void indexedTracksForIds(benchmark::State& state)
+{
+    const auto count           = static_cast<int>(state.range(0));
+    const auto tracks          = generateTracks(count);
+    const Fooyin::TrackIds ids = randomIds(count);
+
+    Fooyin::LibraryTrackIndex index;
+    index.rebuild(tracks);
+
+    for(auto _ : state) {
+        Fooyin::TrackList found;
+        found.reserve(ids.size());
+        for(const int id : ids) {
+            if(const auto position = index.position(id)) {
+                found.push_back(tracks.at(position.value()));
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(state.iterations() * LookupCount);
+}
+
+void linearTracksForHash(benchmark::State& state)
+{
+    const auto count   = static_cast<int>(state.range(0));
+    const auto tracks  = generateTracks(count);
+    const QString hash = tracks.at(count / 2).hash();
+
+    for(auto _ : state) {
+        Fooyin::TrackList found;
+        for(const auto& track : tracks) {
+            if(track.hash() == hash) {
+                found.push_back(track);
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+
+void indexedTracksForHash(benchmark::State& state)
+{
+    const auto count   = static_cast<int>(state.range(0));
+    const auto tracks  = generateTracks(count);
+    const QString hash = tracks.at(count / 2).hash();
+
+    Fooyin::LibraryTrackIndex index;
+    index.rebuild(tracks);
+
+    for(auto _ : state) {
+        Fooyin::TrackList found;
+        for(const int id : index.idsForHash(hash)) {
+            if(const auto position = index.position(id)) {
+                found.push_back(tracks.at(position.value()));
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+
+void rebuildIndex(benchmark::State& state)
+{
+    const auto tracks = generateTracks(static_cast<int>(state.range(0)));
+
+    for(auto _ : state) {
+        Fooyin::LibraryTrackIndex index;
+        index.rebuild(tracks);
+        benchmark::DoNotOptimize(index);
+    }
+}
+} // namespace
+
+BENCHMARK(linearTracksForIds)->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(indexedTracksForIds)->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(linearTracksForHash)->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(indexedTracksForHash)->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(rebuildIndex)->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
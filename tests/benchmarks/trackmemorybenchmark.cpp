@@ -0,0 +1,133 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/track.h>
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <unordered_set>
+
+namespace {
+constexpr auto TrackCount = 100'000;
+
+// Every value is built at runtime, as it would be when read from tags or the database
+Fooyin::TrackList generateTracks()
+{
+    static constexpr std::array codecs{"FLAC", "MP3", "Vorbis"};
+    static constexpr std::array genres{"Pop", "Rock", "Jazz", "Electronic", "Classical"};
+
+    Fooyin::TrackList tracks;
+    tracks.reserve(TrackCount);
+
+    for(int i{0}; i < TrackCount; ++i) {
+        const int album  = i / 12;
+        const int artist = album / 8;
+
+        Fooyin::Track track{QStringLiteral("/music/Artist %1/Album %2/%3.flac").arg(artist).arg(album).arg(i)};
+        track.setId(i);
+        track.setTitle(QStringLiteral("Title %1").arg(i));
+        track.setAlbum(QStringLiteral("Album %1").arg(album));
+        track.setArtists({QStringLiteral("Artist %1").arg(artist)});
+        track.setAlbumArtists({QStringLiteral("Artist %1").arg(artist)});
+        track.setGenres({QString::fromLatin1(genres.at(artist % genres.size()))});
+        track.setTrackNumber(QString::number(i % 12 + 1));
+        track.setTrackTotal(QString::number(12));
+        track.setDiscNumber(QString::number(1));
+        track.setDate(QString::number(1970 + (album % 50)));
+        track.setCodec(QString::fromLatin1(codecs.at(album % codecs.size())));
+        track.generateHash();
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+
+QStringList internedFields(const Fooyin::Track& track)
+{
+    QStringList fields{track.trackNumber(), track.trackTotal(), track.discNumber(), track.codec(),
+                       track.extension()};
+    fields.append(track.genres());
+    return fields;
+}
+
+size_t stringBytes(const QString& str)
+{
+    // Header plus allocated capacity (including the null terminator)
+    return str.isEmpty() ? 0 : sizeof(QArrayData) + (str.capacity() + 1) * sizeof(QChar);
+}
+
+// Reports the heap used by interned fields, both as stored and as if every track held its own copy
+void reportFootprint(benchmark::State& state, const Fooyin::TrackList& tracks)
+{
+    size_t unsharedBytes{0};
+    size_t sharedBytes{0};
+    std::unordered_set<const QChar*> seen;
+
+    for(const auto& track : tracks) {
+        for(const QString& field : internedFields(track)) {
+            const size_t bytes = stringBytes(field);
+            unsharedBytes += bytes;
+            if(seen.emplace(field.constData()).second) {
+                sharedBytes += bytes;
+            }
+        }
+    }
+
+    const auto count = static_cast<double>(tracks.size());
+
+    state.counters["unshared_bytes_per_track"] = static_cast<double>(unsharedBytes) / count;
+    state.counters["shared_bytes_per_track"]   = static_cast<double>(sharedBytes) / count;
+}
+
+void buildTracks(benchmark::State& state)
+{
+    Fooyin::TrackList tracks;
+
+    for(auto _ : state) {
+        tracks = generateTracks();
+        benchmark::DoNotOptimize(tracks);
+    }
+
+    reportFootprint(state, tracks);
+    state.SetItemsProcessed(state.iterations() * TrackCount);
+}
+
+void editHashedTracks(benchmark::State& state)
+{
+    auto tracks = generateTracks();
+
+    for(auto _ : state) {
+        for(auto& track : tracks) {
+            // Each setter only invalidates the hash, which is regenerated once here
+            track.setTitle(track.title());
+            track.setArtists(track.artists());
+            track.setAlbum(track.album());
+            track.setTrackNumber(track.trackNumber());
+            track.setDiscNumber(track.discNumber());
+            benchmark::DoNotOptimize(track.hash());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * TrackCount);
+}
+} // namespace
+
+BENCHMARK(buildTracks)->Unit(benchmark::kMillisecond);
+BENCHMARK(editHashedTracks)->Unit(benchmark::kMillisecond);
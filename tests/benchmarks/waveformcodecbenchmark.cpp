@@ -0,0 +1,88 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "wavebar/waveformcodec.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <numbers>
+#include <random>
+
+using Fooyin::WaveBar::WaveformData;
+
+namespace {
+constexpr auto Channels = 2;
+
+// A waveform shaped like a typical track: a slowly varying envelope with some per-sample noise
+WaveformData<int16_t> generateWaveform(int samplesPerChannel)
+{
+    std::mt19937 rng{1234};
+    std::uniform_real_distribution<float> noise{0.85F, 1.0F};
+
+    WaveformData<int16_t> data;
+    data.channelData.resize(Channels);
+
+    for(auto& [max, min, rms] : data.channelData) {
+        for(int i{0}; i < samplesPerChannel; ++i) {
+            const float position = static_cast<float>(i) / static_cast<float>(samplesPerChannel);
+            const float envelope
+                = 0.5F + (0.4F * std::sin(position * 6.0F * std::numbers::pi_v<float>) * std::sin(position * 40.0F));
+            const float peak = std::abs(envelope) * noise(rng);
+
+            max.push_back(static_cast<int16_t>(peak * 32767.0F));
+            min.push_back(static_cast<int16_t>(-peak * noise(rng) * 32767.0F));
+            rms.push_back(static_cast<int16_t>(peak * 0.7F * noise(rng) * 32767.0F));
+        }
+    }
+
+    return data;
+}
+
+void decodeLegacy(benchmark::State& state)
+{
+    const auto waveform   = generateWaveform(static_cast<int>(state.range(0)));
+    const QByteArray blob = Fooyin::WaveBar::WaveformCodec::encodeLegacy(waveform);
+
+    for(auto _ : state) {
+        WaveformData<int16_t> data;
+        Fooyin::WaveBar::WaveformCodec::decodeLegacy(blob, data);
+        benchmark::DoNotOptimize(data.channelData.data());
+    }
+
+    state.counters["bytes"] = static_cast<double>(blob.size());
+}
+
+void decodeCompact(benchmark::State& state)
+{
+    const auto waveform   = generateWaveform(static_cast<int>(state.range(0)));
+    const QByteArray blob = Fooyin::WaveBar::WaveformCodec::encode(waveform);
+
+    for(auto _ : state) {
+        WaveformData<int16_t> data;
+        Fooyin::WaveBar::WaveformCodec::decode(blob, data);
+        benchmark::DoNotOptimize(data.channelData.data());
+    }
+
+    state.counters["bytes"] = static_cast<double>(blob.size());
+}
+} // namespace
+
+BENCHMARK(decodeLegacy)->ArgName("samples")->Arg(2048)->Arg(4096);
+BENCHMARK(decodeCompact)->ArgName("samples")->Arg(2048)->Arg(4096);
@@ -0,0 +1,94 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "wavebar/waveformreducer.h"
+
+#include <core/engine/audioconverter.h>
+#include <core/engine/audioformat.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+namespace {
+// A 10 minute stereo track at 44.1kHz
+constexpr auto SampleRate   = 44100;
+constexpr auto Channels     = 2;
+constexpr auto TrackSeconds = 600;
+constexpr auto TrackFrames  = SampleRate * TrackSeconds;
+
+// The waveform generator reduces each track to this many points per channel
+constexpr auto SamplesPerChannel = 2048;
+
+std::vector<std::byte> generateTrack(const Fooyin::AudioFormat& format)
+{
+    std::vector<float> samples(static_cast<size_t>(TrackFrames) * Channels);
+    for(size_t i{0}; i < samples.size(); ++i) {
+        const auto frame = static_cast<float>(i / Channels);
+        samples[i]       = 0.8F * std::sin(2.0F * std::numbers::pi_v<float> * 440.0F * frame / SampleRate);
+    }
+
+    const Fooyin::AudioFormat floatFormat{Fooyin::SampleFormat::F32, SampleRate, Channels};
+
+    std::vector<std::byte> track(static_cast<size_t>(format.bytesForFrames(TrackFrames)));
+    Fooyin::Audio::convert(floatFormat, reinterpret_cast<const std::byte*>(samples.data()), format, track.data(),
+                           TrackFrames);
+    return track;
+}
+
+void reduceTrack(benchmark::State& state)
+{
+    const auto sampleFormat = static_cast<Fooyin::SampleFormat>(state.range(0));
+    const Fooyin::AudioFormat format{sampleFormat, SampleRate, Channels};
+
+    const auto track = generateTrack(format);
+
+    Fooyin::WaveBar::WaveformReducer reducer;
+    reducer.setFormat(format);
+
+    const int bufferFrames = TrackFrames / SamplesPerChannel;
+    const int bufferBytes  = format.bytesForFrames(bufferFrames);
+    const auto mayContinue = []() {
+        return true;
+    };
+
+    for(auto _ : state) {
+        for(int point{0}; point < SamplesPerChannel; ++point) {
+            reducer.reduce(track.data() + static_cast<ptrdiff_t>(point) * bufferBytes, bufferFrames, mayContinue);
+            auto sample = reducer.sample(0);
+            benchmark::DoNotOptimize(sample);
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(track.size()));
+    // Seconds of audio reduced per second
+    state.counters["audio_secs"]
+        = benchmark::Counter(static_cast<double>(state.iterations()) * TrackSeconds, benchmark::Counter::kIsRate);
+}
+} // namespace
+
+BENCHMARK(reduceTrack)
+    ->ArgName("format")
+    ->Arg(static_cast<int64_t>(Fooyin::SampleFormat::S16))
+    ->Arg(static_cast<int64_t>(Fooyin::SampleFormat::S32))
+    ->Arg(static_cast<int64_t>(Fooyin::SampleFormat::F32))
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,352 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/engine/dsp/crossfeed.h"
+#include "core/engine/dsp/dspchain.h"
+#include "core/engine/dsp/equaliser.h"
+
+#include <core/engine/audiobuffer.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numbers>
+#include <vector>
+
+namespace Fooyin::Testing {
+namespace {
+class GainNode : public DspNode
+{
+public:
+    GainNode(float gain, int maxFrames, std::vector<int>* blocks)
+        : m_gain{gain}
+        , m_maxFrames{maxFrames}
+        , m_blocks{blocks}
+    { }
+
+    [[nodiscard]] QString name() const override
+    {
+        return QStringLiteral("Gain");
+    }
+
+    [[nodiscard]] int maxBlockFrames() const override
+    {
+        return m_maxFrames;
+    }
+
+    bool prepare(const AudioFormat& format, int /*blockFrames*/) override
+    {
+        m_channels = format.channelCount();
+        return format.sampleFormat() == SampleFormat::F32;
+    }
+
+    void process(float* data, int frameCount) override
+    {
+        if(m_blocks) {
+            m_blocks->push_back(frameCount);
+        }
+        for(int i{0}; i < frameCount * m_channels; ++i) {
+            data[i] *= m_gain;
+        }
+    }
+
+    [[nodiscard]] int latency() const override
+    {
+        return 10;
+    }
+
+private:
+    float m_gain;
+    int m_maxFrames;
+    std::vector<int>* m_blocks;
+    int m_channels{0};
+};
+
+class CountingNode : public DspNode
+{
+public:
+    CountingNode(int maxFrames, int* prepares)
+        : m_maxFrames{maxFrames}
+        , m_prepares{prepares}
+    { }
+
+    [[nodiscard]] QString name() const override
+    {
+        return QStringLiteral("Counting");
+    }
+
+    [[nodiscard]] int maxBlockFrames() const override
+    {
+        return m_maxFrames;
+    }
+
+    bool prepare(const AudioFormat& /*format*/, int /*blockFrames*/) override
+    {
+        ++(*m_prepares);
+        return true;
+    }
+
+    void process(float* /*data*/, int /*frameCount*/) override { }
+
+private:
+    int m_maxFrames;
+    int* m_prepares;
+};
+
+AudioBuffer floatBuffer(const AudioFormat& format, const std::vector<float>& samples)
+{
+    AudioBuffer buffer{format, 0};
+    buffer.resize(samples.size() * sizeof(float));
+    std::memcpy(buffer.data(), samples.data(), samples.size() * sizeof(float));
+    return buffer;
+}
+
+float sampleAt(const AudioBuffer& buffer, size_t index)
+{
+    float sample;
+    std::memcpy(&sample, buffer.constData().data() + (index * sizeof(float)), sizeof(float));
+    return sample;
+}
+} // namespace
+
+TEST(DspChainTest, ProcessesInNegotiatedBlocks)
+{
+    std::vector<int> blocks;
+
+    DspChain chain;
+    chain.update({{QStringLiteral("Gain"), [&blocks]() { return std::make_unique<GainNode>(2.0F, 100, &blocks); }}});
+
+    const AudioFormat format{SampleFormat::F32, 44100, 1};
+    chain.prepare(format);
+    EXPECT_EQ(100, chain.blockFrames());
+    EXPECT_EQ(10, chain.latency());
+
+    AudioBuffer buffer = floatBuffer(format, std::vector<float>(250, 0.25F));
+    chain.process(buffer);
+
+    EXPECT_EQ((std::vector<int>{100, 100, 50}), blocks);
+    for(size_t i{0}; i < 250; ++i) {
+        EXPECT_FLOAT_EQ(0.5F, sampleAt(buffer, i));
+    }
+}
+
+TEST(DspChainTest, ConvertsIntegerSamples)
+{
+    DspChain chain;
+    chain.update({{QStringLiteral("Gain"), []() { return std::make_unique<GainNode>(0.5F, 0, nullptr); }}});
+
+    const AudioFormat format{SampleFormat::S16, 44100, 2};
+    chain.prepare(format);
+
+    const std::vector<int16_t> samples{16384, -16384, 8192, -8192};
+
+    AudioBuffer buffer{format, 0};
+    buffer.resize(samples.size() * sizeof(int16_t));
+    std::memcpy(buffer.data(), samples.data(), samples.size() * sizeof(int16_t));
+
+    chain.process(buffer);
+
+    std::vector<int16_t> output(samples.size());
+    std::memcpy(output.data(), buffer.constData().data(), output.size() * sizeof(int16_t));
+    EXPECT_EQ((std::vector<int16_t>{8192, -8192, 4096, -4096}), output);
+}
+
+TEST(DspChainTest, UnityGainPassesIntegerSamplesThrough)
+{
+    DspChain chain;
+    chain.update({{QStringLiteral("Gain"), []() { return std::make_unique<GainNode>(1.0F, 0, nullptr); }}});
+
+    const AudioFormat format{SampleFormat::S16, 44100, 2};
+    chain.prepare(format);
+
+    const std::vector<int16_t> samples{-32768, -30000, -1, 0, 1, 12345, 30000, 32767};
+
+    AudioBuffer buffer{format, 0};
+    buffer.resize(samples.size() * sizeof(int16_t));
+    std::memcpy(buffer.data(), samples.data(), samples.size() * sizeof(int16_t));
+
+    chain.process(buffer);
+
+    std::vector<int16_t> output(samples.size());
+    std::memcpy(output.data(), buffer.constData().data(), output.size() * sizeof(int16_t));
+    EXPECT_EQ(samples, output);
+}
+
+TEST(DspChainTest, ClampsIntegerOutput)
+{
+    DspChain chain;
+    chain.update({{QStringLiteral("Gain"), []() { return std::make_unique<GainNode>(4.0F, 0, nullptr); }}});
+
+    const AudioFormat format{SampleFormat::S32, 44100, 1};
+    chain.prepare(format);
+
+    // Pushed well past full scale, which would wrap around if converted back unclamped
+    // Enough samples to use the vectorised conversions as well as the scalar tail
+    std::vector<int32_t> samples;
+    for(int i{0}; i < 11; ++i) {
+        samples.insert(samples.end(), {1 << 30, -(1 << 30), 1 << 20});
+    }
+
+    AudioBuffer buffer{format, 0};
+    buffer.resize(samples.size() * sizeof(int32_t));
+    std::memcpy(buffer.data(), samples.data(), samples.size() * sizeof(int32_t));
+
+    chain.process(buffer);
+
+    std::vector<int32_t> output(samples.size());
+    std::memcpy(output.data(), buffer.constData().data(), output.size() * sizeof(int32_t));
+    for(size_t i{0}; i < output.size(); i += 3) {
+        EXPECT_GT(output.at(i), std::numeric_limits<int32_t>::max() - 1024);
+        EXPECT_LT(output.at(i + 1), std::numeric_limits<int32_t>::min() + 1024);
+        EXPECT_NEAR(1 << 22, output.at(i + 2), 2);
+    }
+}
+
+TEST(DspChainTest, OnlyPreparesWhenNeeded)
+{
+    int firstPrepares{0};
+    int secondPrepares{0};
+    const DspEntry first{QStringLiteral("First"),
+                         [&firstPrepares]() { return std::make_unique<CountingNode>(0, &firstPrepares); }};
+    const DspEntry second{QStringLiteral("Second"),
+                          [&secondPrepares]() { return std::make_unique<CountingNode>(0, &secondPrepares); }};
+    const DspEntry smallBlocks{QStringLiteral("SmallBlocks"),
+                               [&secondPrepares]() { return std::make_unique<CountingNode>(64, &secondPrepares); }};
+
+    const AudioFormat format{SampleFormat::F32, 44100, 2};
+
+    DspChain chain;
+    chain.prepare(format);
+    chain.update({first});
+    EXPECT_EQ(1, firstPrepares);
+
+    // Adding a processor doesn't reset those already prepared
+    chain.update({first, second});
+    EXPECT_EQ(1, firstPrepares);
+    EXPECT_EQ(1, secondPrepares);
+
+    chain.prepare(format);
+    EXPECT_EQ(1, firstPrepares);
+
+    // A smaller block size affects every processor
+    chain.update({first, smallBlocks});
+    EXPECT_EQ(64, chain.blockFrames());
+    EXPECT_EQ(2, firstPrepares);
+
+    chain.prepare({SampleFormat::F32, 48000, 2});
+    EXPECT_EQ(3, firstPrepares);
+}
+
+TEST(DspChainTest, KeepsExistingNodesOnUpdate)
+{
+    int created{0};
+    const DspEntry gain{QStringLiteral("Gain"), [&created]() {
+                            ++created;
+                            return std::make_unique<GainNode>(1.0F, 0, nullptr);
+                        }};
+    const DspEntry crossfeed{QStringLiteral("Crossfeed"), []() { return std::make_unique<Crossfeed>(); }};
+
+    DspChain chain;
+    chain.prepare({SampleFormat::F32, 44100, 1});
+
+    chain.update({gain});
+    chain.update({crossfeed, gain});
+    EXPECT_EQ(1, created);
+
+    // Crossfeed only supports stereo
+    EXPECT_EQ(1, chain.activeCount());
+
+    chain.prepare({SampleFormat::F32, 44100, 2});
+    EXPECT_EQ(2, chain.activeCount());
+
+    chain.update({});
+    EXPECT_TRUE(chain.isEmpty());
+}
+
+TEST(DspChainTest, FlatEqualiserIsTransparent)
+{
+    DspChain chain;
+    chain.update({{QStringLiteral("Equaliser"), []() { return std::make_unique<Equaliser>(); }}});
+
+    const AudioFormat format{SampleFormat::F32, 44100, 2};
+    chain.prepare(format);
+
+    std::vector<float> samples(64);
+    for(size_t i{0}; i < samples.size(); ++i) {
+        samples.at(i) = static_cast<float>(i % 7) / 7.0F - 0.5F;
+    }
+
+    AudioBuffer buffer = floatBuffer(format, samples);
+    chain.process(buffer);
+
+    for(size_t i{0}; i < samples.size(); ++i) {
+        EXPECT_FLOAT_EQ(samples.at(i), sampleAt(buffer, i));
+    }
+}
+
+TEST(DspChainTest, EqualiserFollowsSettings)
+{
+    int created{0};
+    const auto creator = [&created]() {
+        ++created;
+        return std::make_unique<Equaliser>();
+    };
+
+    QVariantList boost;
+    for(size_t i{0}; i < Equaliser::BandCount; ++i) {
+        boost.append(6.0);
+    }
+
+    DspChain chain;
+    chain.update({{QStringLiteral("Equaliser"), creator, boost}});
+
+    const AudioFormat format{SampleFormat::F32, 44100, 1};
+    chain.prepare(format);
+
+    std::vector<float> samples(512);
+    for(size_t i{0}; i < samples.size(); ++i) {
+        const double phase = 2.0 * std::numbers::pi * 1000.0 * static_cast<double>(i) / 44100.0;
+        samples.at(i)      = 0.25F * static_cast<float>(std::sin(phase));
+    }
+
+    auto energy = [](const AudioBuffer& buffer, size_t count) {
+        double total{0.0};
+        for(size_t i{0}; i < count; ++i) {
+            total += std::pow(sampleAt(buffer, i), 2);
+        }
+        return total;
+    };
+
+    AudioBuffer boosted = floatBuffer(format, samples);
+    chain.process(boosted);
+    EXPECT_GT(energy(boosted, samples.size()), energy(floatBuffer(format, samples), samples.size()) * 2.0);
+
+    // New settings are applied to the existing processor
+    chain.update({{QStringLiteral("Equaliser"), creator, QVariantList{}}});
+    EXPECT_EQ(1, created);
+
+    AudioBuffer flat = floatBuffer(format, samples);
+    chain.process(flat);
+    for(size_t i{0}; i < samples.size(); ++i) {
+        EXPECT_FLOAT_EQ(samples.at(i), sampleAt(flat, i));
+    }
+}
+} // namespace Fooyin::Testing
@@ -0,0 +1,187 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "libarchive/libarchiveinput.h"
+
+#include <archive_entry.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using Fooyin::LibArchive::ArchivePtr;
+using Fooyin::LibArchive::LibArchiveIODevice;
+
+namespace {
+// Matches the device's ring buffer size
+constexpr qint64 WindowSize = 4LL * 1024 * 1024;
+constexpr qint64 EntrySize  = (2 * WindowSize) + 12345;
+
+const char* const EntryName = "track.bin";
+
+QByteArray randomData(qint64 size)
+{
+    std::mt19937 rng{1234};
+    QByteArray data(size, Qt::Uninitialized);
+    std::ranges::generate(data, [&rng]() { return static_cast<char>(rng()); });
+    return data;
+}
+
+// gzip'd tar can't seek within an entry, so seeking before the window has to reopen the archive
+QByteArray createArchive(const QByteArray& contents)
+{
+    QByteArray buffer(contents.size() + (1024 * 1024), Qt::Uninitialized);
+    size_t used{0};
+
+    archive* writer = archive_write_new();
+    archive_write_add_filter_gzip(writer);
+    archive_write_set_format_pax_restricted(writer);
+    archive_write_open_memory(writer, buffer.data(), static_cast<size_t>(buffer.size()), &used);
+
+    archive_entry* entry = archive_entry_new();
+    archive_entry_set_pathname(entry, EntryName);
+    archive_entry_set_filetype(entry, AE_IFREG);
+    archive_entry_set_perm(entry, 0644);
+    archive_entry_set_size(entry, contents.size());
+    archive_write_header(writer, entry);
+    archive_write_data(writer, contents.constData(), static_cast<size_t>(contents.size()));
+    archive_entry_free(entry);
+
+    archive_write_close(writer);
+    archive_write_free(writer);
+
+    buffer.resize(static_cast<qsizetype>(used));
+    return buffer;
+}
+
+ArchivePtr openArchive(const QByteArray& data, archive_entry** entry)
+{
+    ArchivePtr archive{archive_read_new()};
+    archive_read_support_filter_all(archive.get());
+    archive_read_support_format_all(archive.get());
+
+    if(archive_read_open_memory(archive.get(), data.constData(), static_cast<size_t>(data.size())) != ARCHIVE_OK
+       || archive_read_next_header(archive.get(), entry) != ARCHIVE_OK) {
+        return nullptr;
+    }
+
+    return archive;
+}
+
+QByteArray readExactly(QIODevice& device, qint64 size)
+{
+    QByteArray result;
+    while(result.size() < size) {
+        const QByteArray chunk = device.read(size - result.size());
+        if(chunk.isEmpty()) {
+            break;
+        }
+        result.append(chunk);
+    }
+    return result;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class LibArchiveIODeviceTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_contents = randomData(EntrySize);
+        m_archive  = createArchive(m_contents);
+
+        archive_entry* entry{nullptr};
+        ArchivePtr archive = openArchive(m_archive, &entry);
+        ASSERT_TRUE(archive);
+
+        m_device = std::make_unique<LibArchiveIODevice>(std::move(archive), entry, [this](archive_entry** reopened) {
+            ++m_reopens;
+            return openArchive(m_archive, reopened);
+        });
+    }
+
+    void expectRead(qint64 pos, qint64 size)
+    {
+        ASSERT_TRUE(m_device->seek(pos));
+        EXPECT_EQ(readExactly(*m_device, size), m_contents.mid(pos, size));
+        EXPECT_EQ(m_device->pos(), pos + size);
+    }
+
+    QByteArray m_contents;
+    QByteArray m_archive;
+    std::unique_ptr<LibArchiveIODevice> m_device;
+    int m_reopens{0};
+};
+
+TEST_F(LibArchiveIODeviceTest, SequentialReadMatchesEntry)
+{
+    EXPECT_EQ(m_device->size(), EntrySize);
+
+    QByteArray result;
+    while(!m_device->atEnd()) {
+        const QByteArray chunk = m_device->read(100000);
+        ASSERT_FALSE(chunk.isEmpty());
+        result.append(chunk);
+    }
+
+    EXPECT_EQ(result, m_contents);
+    EXPECT_EQ(m_reopens, 0);
+}
+
+TEST_F(LibArchiveIODeviceTest, SeekBackWithinWindowAcrossWrap)
+{
+    expectRead(0, WindowSize + (WindowSize / 2));
+
+    // Window now covers [WindowSize / 2, WindowSize * 1.5), stored wrapped around the end of the buffer
+    expectRead((WindowSize / 2) + 1, WindowSize - 2);
+    expectRead(WindowSize - 100, 200);
+    EXPECT_EQ(m_reopens, 0);
+}
+
+TEST_F(LibArchiveIODeviceTest, SeekForwardPastWindow)
+{
+    expectRead(0, 1000);
+    expectRead(WindowSize + 5000, 70000);
+    expectRead(EntrySize - 3000, 3000);
+    EXPECT_EQ(m_reopens, 0);
+
+    EXPECT_TRUE(m_device->seek(EntrySize));
+    EXPECT_TRUE(m_device->read(10).isEmpty());
+    EXPECT_FALSE(m_device->seek(EntrySize + 1));
+}
+
+TEST_F(LibArchiveIODeviceTest, RewindBeforeWindowReopens)
+{
+    expectRead(WindowSize + 7000, 1000);
+    EXPECT_EQ(m_reopens, 0);
+
+    expectRead(10, 5000);
+    EXPECT_EQ(m_reopens, 1);
+
+    // The reopened stream has to carry on correctly, including across the wrap point
+    expectRead(WindowSize - 10, 20);
+    expectRead(EntrySize - WindowSize, WindowSize);
+    EXPECT_EQ(m_reopens, 1);
+
+    expectRead(0, 100);
+    EXPECT_EQ(m_reopens, 2);
+}
+} // namespace Fooyin::Testing
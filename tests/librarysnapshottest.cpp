@@ -0,0 +1,119 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/library/librarysnapshot.h"
+
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+namespace {
+Fooyin::Track makeTrack(int id)
+{
+    Fooyin::Track track{QStringLiteral("/music/album/%1.flac").arg(id)};
+    track.setId(id);
+    track.setLibraryId(1);
+    track.setTitle(QStringLiteral("Title %1").arg(id));
+    track.setArtists({QStringLiteral("Artist"), QStringLiteral("Guest %1").arg(id)});
+    track.setAlbum(QStringLiteral("Album"));
+    track.setTrackNumber(QString::number(id));
+    track.setDate(QStringLiteral("2001-02-03"));
+    track.setDuration(180000 + id);
+    track.setPlayCount(id);
+    track.addExtraTag(QStringLiteral("MOOD"), QStringLiteral("Calm"));
+    track.generateHash();
+    track.setSort(QStringLiteral("%1").arg(id, 5, 10, QChar{u'0'}));
+    return track;
+}
+
+Fooyin::TrackDatabase::State makeState(const Fooyin::TrackList& tracks)
+{
+    Fooyin::TrackDatabase::State state;
+    state.trackCount    = static_cast<int64_t>(tracks.size());
+    state.maxTrackId    = tracks.empty() ? 0 : tracks.back().id();
+    state.modifiedTotal = 1234;
+    return state;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class LibrarySnapshotTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+        m_tracks = {makeTrack(1), makeTrack(2), makeTrack(3)};
+    }
+
+    [[nodiscard]] LibrarySnapshot snapshot() const
+    {
+        return LibrarySnapshot{m_dir.filePath(QStringLiteral("library.snapshot"))};
+    }
+
+    QTemporaryDir m_dir;
+    TrackList m_tracks;
+};
+
+TEST_F(LibrarySnapshotTest, RoundTrip)
+{
+    const auto state = makeState(m_tracks);
+    ASSERT_TRUE(snapshot().write(m_tracks, QStringLiteral("%title%"), state));
+
+    const auto tracks = snapshot().read(QStringLiteral("%title%"), state);
+    ASSERT_TRUE(tracks);
+    ASSERT_EQ(m_tracks.size(), tracks->size());
+
+    for(size_t i{0}; i < m_tracks.size(); ++i) {
+        EXPECT_TRUE(LibrarySnapshot::tracksEqual(m_tracks.at(i), tracks->at(i)));
+        EXPECT_EQ(m_tracks.at(i).sort(), tracks->at(i).sort());
+        EXPECT_FALSE(tracks->at(i).isNewTrack());
+    }
+}
+
+TEST_F(LibrarySnapshotTest, RejectsStaleSnapshot)
+{
+    const auto state = makeState(m_tracks);
+    ASSERT_TRUE(snapshot().write(m_tracks, QStringLiteral("%title%"), state));
+
+    EXPECT_FALSE(snapshot().read(QStringLiteral("%album%"), state));
+
+    auto changedState       = state;
+    changedState.statsTotal = 1;
+    EXPECT_FALSE(snapshot().read(QStringLiteral("%title%"), changedState));
+
+    snapshot().remove();
+    EXPECT_FALSE(snapshot().read(QStringLiteral("%title%"), state));
+}
+
+TEST_F(LibrarySnapshotTest, Changes)
+{
+    TrackList dbTracks{m_tracks.at(0), makeTrack(3), makeTrack(4)};
+    dbTracks.at(1).setPlayCount(10);
+
+    const auto changes = LibrarySnapshot::changes(m_tracks, dbTracks);
+
+    ASSERT_EQ(1U, changes.added.size());
+    EXPECT_EQ(4, changes.added.front().id());
+    ASSERT_EQ(1U, changes.updated.size());
+    EXPECT_EQ(3, changes.updated.front().id());
+    ASSERT_EQ(1U, changes.removed.size());
+    EXPECT_EQ(2, changes.removed.front().id());
+}
+} // namespace Fooyin::Testing
@@ -0,0 +1,121 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/playlist/playlistdiff.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+// Checks the diff matches entries in order and accounts for every old entry
+void verifyDiff(const Fooyin::TrackIds& oldIds, const Fooyin::TrackIds& newIds, const Fooyin::PlaylistDiff& diff)
+{
+    ASSERT_EQ(newIds.size(), diff.newToOld.size());
+
+    std::vector<bool> used(oldIds.size(), false);
+    int lastIndex{-1};
+
+    for(size_t i{0}; i < newIds.size(); ++i) {
+        const int oldIndex = diff.newToOld.at(i);
+        if(oldIndex < 0) {
+            continue;
+        }
+        EXPECT_GT(oldIndex, lastIndex);
+        EXPECT_EQ(oldIds.at(oldIndex), newIds.at(i));
+        used.at(oldIndex) = true;
+        lastIndex         = oldIndex;
+    }
+
+    for(const int removed : diff.removed) {
+        EXPECT_FALSE(used.at(removed));
+        used.at(removed) = true;
+    }
+
+    EXPECT_TRUE(std::ranges::all_of(used, [](bool isUsed) { return isUsed; }));
+}
+
+int insertedCount(const Fooyin::PlaylistDiff& diff)
+{
+    return static_cast<int>(std::ranges::count(diff.newToOld, -1));
+}
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(PlaylistDiffTest, Unchanged)
+{
+    const TrackIds ids{1, 2, 3, 4};
+
+    const auto diff = diffPlaylistTracks(ids, ids, 0);
+    ASSERT_TRUE(diff);
+    verifyDiff(ids, ids, *diff);
+    EXPECT_EQ(0, insertedCount(*diff));
+    EXPECT_TRUE(diff->removed.empty());
+}
+
+TEST(PlaylistDiffTest, AppendAndRemove)
+{
+    const TrackIds oldIds{1, 2, 3, 4, 5};
+    const TrackIds newIds{1, 3, 4, 5, 6, 7};
+
+    const auto diff = diffPlaylistTracks(oldIds, newIds, 10);
+    ASSERT_TRUE(diff);
+    verifyDiff(oldIds, newIds, *diff);
+    EXPECT_EQ(2, insertedCount(*diff));
+    EXPECT_EQ(std::vector<int>{1}, diff->removed);
+}
+
+TEST(PlaylistDiffTest, MoveInLargePlaylist)
+{
+    TrackIds oldIds(50000);
+    std::iota(oldIds.begin(), oldIds.end(), 0);
+
+    TrackIds newIds = oldIds;
+    newIds.erase(newIds.begin() + 10);
+    newIds.insert(newIds.begin() + 40000, 10);
+
+    const auto diff = diffPlaylistTracks(oldIds, newIds, 512);
+    ASSERT_TRUE(diff);
+    verifyDiff(oldIds, newIds, *diff);
+    EXPECT_EQ(1, insertedCount(*diff));
+    EXPECT_EQ(std::vector<int>{10}, diff->removed);
+}
+
+TEST(PlaylistDiffTest, DuplicateTracks)
+{
+    const TrackIds oldIds{1, 1, 2, 1, 3};
+    const TrackIds newIds{1, 2, 1, 1, 3, 1};
+
+    const auto diff = diffPlaylistTracks(oldIds, newIds, 10);
+    ASSERT_TRUE(diff);
+    verifyDiff(oldIds, newIds, *diff);
+}
+
+TEST(PlaylistDiffTest, TooManyEdits)
+{
+    TrackIds oldIds(100);
+    std::iota(oldIds.begin(), oldIds.end(), 0);
+
+    TrackIds newIds = oldIds;
+    std::ranges::reverse(newIds);
+
+    EXPECT_FALSE(diffPlaylistTracks(oldIds, newIds, 10));
+}
+} // namespace Fooyin::Testing
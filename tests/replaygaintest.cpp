@@ -0,0 +1,74 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "core/engine/replaygain.h"
+
+#include <core/track.h>
+
+#include <gtest/gtest.h>
+
+using Fooyin::ReplayGain::Mode;
+
+namespace Fooyin::Testing {
+namespace {
+Track taggedTrack()
+{
+    Track track;
+    track.addExtraTag(QStringLiteral("REPLAYGAIN_TRACK_GAIN"), QStringLiteral("-6.02 dB"));
+    track.addExtraTag(QStringLiteral("REPLAYGAIN_TRACK_PEAK"), QStringLiteral("0.5"));
+    track.addExtraTag(QStringLiteral("REPLAYGAIN_ALBUM_GAIN"), QStringLiteral("+6.02 dB"));
+    track.addExtraTag(QStringLiteral("REPLAYGAIN_ALBUM_PEAK"), QStringLiteral("0.8"));
+    return track;
+}
+} // namespace
+
+TEST(ReplayGainTest, Disabled)
+{
+    EXPECT_FLOAT_EQ(1.0F, ReplayGain::trackGain(taggedTrack(), Mode::Off, 0.0, false));
+}
+
+TEST(ReplayGainTest, Untagged)
+{
+    EXPECT_FLOAT_EQ(1.0F, ReplayGain::trackGain({}, Mode::Track, 6.0, false));
+}
+
+TEST(ReplayGainTest, TrackAndAlbum)
+{
+    const Track track = taggedTrack();
+
+    EXPECT_NEAR(0.5, ReplayGain::trackGain(track, Mode::Track, 0.0, false), 0.001);
+    EXPECT_NEAR(2.0, ReplayGain::trackGain(track, Mode::Album, 0.0, false), 0.001);
+    EXPECT_NEAR(1.0, ReplayGain::trackGain(track, Mode::Track, 6.02, false), 0.001);
+}
+
+TEST(ReplayGainTest, PreventClipping)
+{
+    // Album gain of +6.02 dB would take the 0.8 peak past full scale
+    EXPECT_NEAR(1.25, ReplayGain::trackGain(taggedTrack(), Mode::Album, 0.0, true), 0.001);
+}
+
+TEST(ReplayGainTest, FallsBackToTrackGain)
+{
+    Track track;
+    track.addExtraTag(QStringLiteral("REPLAYGAIN_TRACK_GAIN"), QStringLiteral("-6.02 dB"));
+
+    EXPECT_NEAR(0.5, ReplayGain::trackGain(track, Mode::Album, 0.0, true), 0.001);
+}
+} // namespace Fooyin::Testing
@@ -126,4 +126,47 @@ TEST_F(ScriptParserTest, TrackListTest)
     EXPECT_EQ(u"00:05", m_parser.evaluate(QStringLiteral("%playtime%"), tracks));
     EXPECT_EQ(u"Pop / Rock", m_parser.evaluate(QStringLiteral("%genres%"), tracks));
 }
+
+TEST_F(ScriptParserTest, CompiledMatchesInterpreted)
+{
+    Track track;
+    track.setTitle(QStringLiteral("A Test"));
+    track.setAlbum(QStringLiteral("A Test Album"));
+    track.setGenres({QStringLiteral("Pop"), QStringLiteral("Rock")});
+    track.setArtists({QStringLiteral("Me"), QStringLiteral("You")});
+    track.setTrackNumber(QStringLiteral("3"));
+
+    const QStringList scripts{
+        QStringLiteral("I am a test."),
+        QStringLiteral(R"("I %am% a $test$.")"),
+        QStringLiteral("$num(1,2)"),
+        QStringLiteral("$if($stricmp(cmp,cMp),true,false)"),
+        QStringLiteral("$add(1,$mul(2,3))"),
+        QStringLiteral("%title%[ - %album%]"),
+        QStringLiteral("[%disc% - ]%track%. %title%"),
+        QStringLiteral("[[%disc%.]%track%]"),
+        QStringLiteral("[constant]/[%disc%]"),
+        QStringLiteral("%genre% - %artist%"),
+        QStringLiteral("%<genre>% - %<artist>%"),
+        QStringLiteral("[%<genre>%: ]%title%"),
+        QStringLiteral("$upper(%<artist>%)"),
+        QStringLiteral("$if2(%disc%,%title%)"),
+        QStringLiteral("$num(%track%,2) $left(%title%,1)"),
+        QStringLiteral("$meta(title)"),
+        QStringLiteral("%nonexistent%"),
+    };
+
+    for(const QString& input : scripts) {
+        const auto compiled = m_parser.parse(input);
+        ASSERT_TRUE(compiled.program) << input.toStdString();
+
+        auto interpreted = compiled;
+        interpreted.program.reset();
+
+        const QString compiledResult    = m_parser.evaluate(compiled, track);
+        const QString interpretedResult = m_parser.evaluate(interpreted, track);
+        EXPECT_EQ(interpretedResult, compiledResult) << input.toStdString();
+        EXPECT_EQ(interpretedResult.isNull(), compiledResult.isNull()) << input.toStdString();
+    }
+}
 } // namespace Fooyin::Testing
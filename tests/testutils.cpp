@@ -23,7 +23,38 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace Fooyin::Testing {
+std::vector<std::byte> randomBytes(size_t size, uint32_t seed)
+{
+    std::mt19937 rng{seed};
+    std::vector<std::byte> bytes(size);
+    std::ranges::generate(bytes, [&rng]() { return static_cast<std::byte>(rng()); });
+    return bytes;
+}
+
+std::vector<std::byte> randomAudio(const AudioFormat& format, int frames, float floatRange)
+{
+    if(format.sampleFormat() != SampleFormat::F32) {
+        return randomBytes(static_cast<size_t>(format.bytesForFrames(frames)));
+    }
+
+    std::mt19937 rng{RandomSeed};
+    std::uniform_real_distribution<float> dist{-floatRange, floatRange};
+
+    const int samples = frames * format.channelCount();
+    std::vector<std::byte> audio(static_cast<size_t>(samples) * sizeof(float));
+
+    for(int i{0}; i < samples; ++i) {
+        const float value = dist(rng);
+        std::memcpy(audio.data() + (i * sizeof(float)), &value, sizeof(float));
+    }
+
+    return audio;
+}
+
 TempResource::TempResource(const QString& filename, QObject* parent)
     : QTemporaryFile{parent}
     , m_file{filename}
@@ -19,9 +19,53 @@
 
 #pragma once
 
+#include <core/engine/audioformat.h>
+
 #include <QTemporaryFile>
 
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
 namespace Fooyin::Testing {
+// Fixed so failures in tests using random data are reproducible
+constexpr uint32_t RandomSeed = 1234;
+
+/** Returns @p size random bytes. */
+std::vector<std::byte> randomBytes(size_t size, uint32_t seed = RandomSeed);
+/*!
+ * Returns @p frames frames of random audio in @p format.
+ * Float samples are uniformly distributed within ±@p floatRange, and integer samples cover the full range.
+ */
+std::vector<std::byte> randomAudio(const AudioFormat& format, int frames, float floatRange = 1.0F);
+
+/*!
+ * Returns waveform data (e.g. WaveBar::WaveformData) with @p samplesPerChannel samples for each of
+ * @p channels channels. Max and rms values are drawn from @p dist, and min values are negated draws.
+ */
+template <typename Data, typename Distribution>
+Data randomWaveform(int channels, int samplesPerChannel, Distribution dist)
+{
+    Data data;
+    data.channels = channels;
+    data.channelData.resize(channels);
+
+    using Value = typename decltype(data.channelData.front().max)::value_type;
+
+    std::mt19937 rng{RandomSeed};
+
+    for(auto& [max, min, rms] : data.channelData) {
+        for(int i{0}; i < samplesPerChannel; ++i) {
+            max.push_back(static_cast<Value>(dist(rng)));
+            min.push_back(static_cast<Value>(-dist(rng)));
+            rms.push_back(static_cast<Value>(dist(rng)));
+        }
+    }
+
+    return data;
+}
+
 class TempResource : public QTemporaryFile
 {
 public:
@@ -0,0 +1,135 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "testutils.h"
+#include "wavebar/waveformcodec.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+using Fooyin::WaveBar::WaveformData;
+
+namespace {
+constexpr auto Channels = 2;
+constexpr std::array SampleCounts{1, 7, 1000, 2048, 4097};
+
+WaveformData<int16_t> randomWaveform(int samplesPerChannel, int16_t peak = 32767)
+{
+    return Fooyin::Testing::randomWaveform<WaveformData<int16_t>>(Channels, samplesPerChannel,
+                                                                  std::uniform_int_distribution<int>{0, peak});
+}
+
+// Samples are quantised to one of 128 steps on a log curve, so the error grows with the sample
+void expectWithinQuantisation(const std::vector<int16_t>& expected, const std::vector<int16_t>& decoded, int peak)
+{
+    ASSERT_EQ(expected.size(), decoded.size());
+
+    for(size_t i{0}; i < expected.size(); ++i) {
+        const double tolerance = (0.025 * std::abs(expected.at(i))) + (0.0001 * peak) + 1.0;
+        EXPECT_NEAR(expected.at(i), decoded.at(i), tolerance) << "sample: " << i;
+    }
+}
+
+void expectRoundTrip(const WaveformData<int16_t>& waveform, int peak)
+{
+    WaveformData<int16_t> data;
+    ASSERT_TRUE(Fooyin::WaveBar::WaveformCodec::decode(Fooyin::WaveBar::WaveformCodec::encode(waveform), data));
+    ASSERT_EQ(waveform.channelData.size(), data.channelData.size());
+
+    for(size_t ch{0}; ch < data.channelData.size(); ++ch) {
+        SCOPED_TRACE(testing::Message() << "channel: " << ch);
+
+        expectWithinQuantisation(waveform.channelData.at(ch).max, data.channelData.at(ch).max, peak);
+        expectWithinQuantisation(waveform.channelData.at(ch).min, data.channelData.at(ch).min, peak);
+        expectWithinQuantisation(waveform.channelData.at(ch).rms, data.channelData.at(ch).rms, peak);
+    }
+}
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(WaveformCodecTest, RoundTrip)
+{
+    for(const int samples : SampleCounts) {
+        SCOPED_TRACE(testing::Message() << "samples: " << samples);
+        expectRoundTrip(randomWaveform(samples), 32767);
+    }
+}
+
+TEST(WaveformCodecTest, RoundTripQuietTrack)
+{
+    // Samples are scaled to the loudest in the track, so quiet tracks keep their detail
+    expectRoundTrip(randomWaveform(2048, 1000), 1000);
+}
+
+TEST(WaveformCodecTest, LegacyRoundTrip)
+{
+    const auto waveform = randomWaveform(2048);
+
+    WaveformData<int16_t> data;
+    ASSERT_TRUE(WaveBar::WaveformCodec::decodeLegacy(WaveBar::WaveformCodec::encodeLegacy(waveform), data));
+    EXPECT_TRUE(data.channelData == waveform.channelData);
+}
+
+TEST(WaveformCodecTest, IsCompact)
+{
+    const auto waveform = randomWaveform(2048);
+
+    EXPECT_TRUE(WaveBar::WaveformCodec::isCompact(WaveBar::WaveformCodec::encode(waveform)));
+    EXPECT_FALSE(WaveBar::WaveformCodec::isCompact(WaveBar::WaveformCodec::encodeLegacy(waveform)));
+    EXPECT_FALSE(WaveBar::WaveformCodec::isCompact({}));
+    EXPECT_FALSE(WaveBar::WaveformCodec::isCompact(QByteArrayLiteral("FYW")));
+}
+
+TEST(WaveformCodecTest, RejectsTruncatedBlobs)
+{
+    const QByteArray blob = WaveBar::WaveformCodec::encode(randomWaveform(1000));
+
+    for(qsizetype size{0}; size < blob.size(); ++size) {
+        WaveformData<int16_t> data;
+        EXPECT_FALSE(WaveBar::WaveformCodec::decode(blob.first(size), data)) << "size: " << size;
+    }
+}
+
+TEST(WaveformCodecTest, RejectsCorruptBlobs)
+{
+    const QByteArray blob = WaveBar::WaveformCodec::encode(randomWaveform(1000));
+
+    // Header: magic (4 bytes), version, channels, scale (2) and samples (4), followed by the compressed data
+    auto corrupt = [&blob](qsizetype pos, const QByteArray& bytes) {
+        QByteArray corrupted{blob};
+        corrupted.replace(pos, bytes.size(), bytes);
+        return corrupted;
+    };
+
+    WaveformData<int16_t> data;
+    EXPECT_FALSE(WaveBar::WaveformCodec::decode(corrupt(0, "FYWX"), data));
+    // Version 1 blobs also stored reduced levels
+    EXPECT_FALSE(WaveBar::WaveformCodec::decode(corrupt(4, QByteArray(1, 1)), data));
+    EXPECT_FALSE(WaveBar::WaveformCodec::decode(corrupt(5, QByteArray(1, 3)), data));
+    EXPECT_FALSE(WaveBar::WaveformCodec::decode(corrupt(6, QByteArray(2, 0)), data));
+    EXPECT_FALSE(WaveBar::WaveformCodec::decode(corrupt(11, QByteArray(1, static_cast<char>(blob.at(11) + 1))), data));
+    // The last byte is part of the zlib checksum
+    EXPECT_FALSE(
+        WaveBar::WaveformCodec::decode(corrupt(blob.size() - 1, QByteArray(1, static_cast<char>(~blob.back()))), data));
+}
+} // namespace Fooyin::Testing
@@ -0,0 +1,125 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "testutils.h"
+#include "wavebar/waveformpyramid.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+using Fooyin::WaveBar::WaveformData;
+using Fooyin::WaveBar::WaveformPyramid;
+
+namespace {
+constexpr auto Channels = 2;
+constexpr std::array SampleCounts{1, 2, 3, 5, 17, 255, 1001, 2049};
+
+WaveformData<float> randomWaveform(int samplesPerChannel)
+{
+    return Fooyin::Testing::randomWaveform<WaveformData<float>>(Channels, samplesPerChannel,
+                                                                std::uniform_real_distribution<float>{0.0F, 1.0F});
+}
+
+// Visits every sample in [start, end), clipped to the available samples
+WaveformPyramid::Summary bruteForce(const WaveformData<float>& data, int channel, int start, int end)
+{
+    const auto& [max, min, rms] = data.channelData.at(channel);
+
+    WaveformPyramid::Summary summary;
+    for(int i{std::max(start, 0)}; i < std::min(end, data.sampleCount()); ++i) {
+        summary.max = std::max(summary.max, max.at(i));
+        summary.min = std::min(summary.min, min.at(i));
+        summary.sumSquares += static_cast<double>(rms.at(i)) * rms.at(i);
+        ++summary.count;
+    }
+    return summary;
+}
+
+void expectSummary(const WaveformData<float>& data, const WaveformPyramid& pyramid, int channel, int start, int end)
+{
+    SCOPED_TRACE(testing::Message() << "channel: " << channel << ", range: [" << start << ", " << end << ")");
+
+    const auto expected = bruteForce(data, channel, start, end);
+    const auto summary  = pyramid.summarise(channel, start, end);
+
+    EXPECT_EQ(expected.count, summary.count);
+    EXPECT_EQ(expected.max, summary.max);
+    EXPECT_EQ(expected.min, summary.min);
+    EXPECT_NEAR(expected.sumSquares, summary.sumSquares, 1e-9 * std::max(1.0, expected.sumSquares));
+}
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(WaveformPyramidTest, RandomRanges)
+{
+    std::mt19937 rng{4321};
+
+    for(const int samples : SampleCounts) {
+        SCOPED_TRACE(testing::Message() << "samples: " << samples);
+
+        const auto data    = randomWaveform(samples);
+        const auto pyramid = WaveBar::WaveformPyramid::build(data);
+
+        EXPECT_EQ(Channels, pyramid->channels());
+        EXPECT_EQ(samples, pyramid->sampleCount());
+
+        std::uniform_int_distribution<int> dist{0, samples};
+        for(int i{0}; i < 200; ++i) {
+            const int a = dist(rng);
+            const int b = dist(rng);
+            expectSummary(data, *pyramid, i % Channels, std::min(a, b), std::max(a, b));
+        }
+    }
+}
+
+TEST(WaveformPyramidTest, RangesTouchingTail)
+{
+    for(const int samples : SampleCounts) {
+        SCOPED_TRACE(testing::Message() << "samples: " << samples);
+
+        const auto data    = randomWaveform(samples);
+        const auto pyramid = WaveBar::WaveformPyramid::build(data);
+
+        for(int start{0}; start <= samples; ++start) {
+            expectSummary(data, *pyramid, 0, start, samples);
+        }
+        for(int end{0}; end <= samples; ++end) {
+            expectSummary(data, *pyramid, 1, 0, end);
+        }
+    }
+}
+
+TEST(WaveformPyramidTest, ClipsRanges)
+{
+    const auto data    = randomWaveform(1001);
+    const auto pyramid = WaveBar::WaveformPyramid::build(data);
+
+    expectSummary(data, *pyramid, 0, -10, 20);
+    expectSummary(data, *pyramid, 0, 990, 2000);
+    expectSummary(data, *pyramid, 1, -5, 5000);
+    expectSummary(data, *pyramid, 1, 1001, 1010);
+    expectSummary(data, *pyramid, 1, 20, 10);
+
+    EXPECT_EQ(0, pyramid->summarise(Channels, 0, 1001).count);
+    EXPECT_EQ(0, pyramid->summarise(-1, 0, 1001).count);
+}
+} // namespace Fooyin::Testing
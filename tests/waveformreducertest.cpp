@@ -0,0 +1,157 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "testutils.h"
+#include "wavebar/waveformreducer.h"
+
+#include <core/engine/audioformat.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using Fooyin::AudioFormat;
+using Fooyin::SampleFormat;
+using Fooyin::WaveBar::WaveformSample;
+
+namespace {
+constexpr std::array ReduceFormats{SampleFormat::S16, SampleFormat::S24, SampleFormat::S32, SampleFormat::F32};
+constexpr std::array ChannelCounts{1, 2, 3, 4, 6};
+// Chosen so vector loops and cancellation blocks all leave a remainder
+constexpr std::array FrameCounts{1, 3, 7, 13, 1001, 4097, 8195};
+
+double readSample(SampleFormat format, const std::byte* data)
+{
+    switch(format) {
+        case(SampleFormat::S16): {
+            int16_t sample;
+            std::memcpy(&sample, data, sizeof(sample));
+            return static_cast<double>(sample) / std::numeric_limits<int16_t>::max();
+        }
+        case(SampleFormat::S24):
+        case(SampleFormat::S32): {
+            int32_t sample;
+            std::memcpy(&sample, data, sizeof(sample));
+            return static_cast<double>(sample) / std::numeric_limits<int32_t>::max();
+        }
+        default: {
+            float sample;
+            std::memcpy(&sample, data, sizeof(sample));
+            return sample;
+        }
+    }
+}
+
+// One sample at a time in double precision
+WaveformSample referenceReduce(const AudioFormat& format, const std::vector<std::byte>& input, int frames,
+                               int channel)
+{
+    double min{std::numeric_limits<double>::max()};
+    double max{std::numeric_limits<double>::lowest()};
+    double sumSquares{0.0};
+
+    for(int frame{0}; frame < frames; ++frame) {
+        const auto offset = static_cast<size_t>((frame * format.channelCount()) + channel) * format.bytesPerSample();
+        const double value = readSample(format.sampleFormat(), input.data() + offset);
+
+        min = std::min(min, value);
+        max = std::max(max, value);
+        sumSquares += value * value;
+    }
+
+    WaveformSample sample;
+    sample.min = static_cast<float>(min);
+    sample.max = static_cast<float>(max);
+    sample.rms = static_cast<float>(std::sqrt(sumSquares / frames));
+    return sample;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(WaveformReducerTest, MatchesScalarReference)
+{
+    WaveBar::WaveformReducer reducer;
+
+    for(const SampleFormat sampleFormat : ReduceFormats) {
+        for(const int channels : ChannelCounts) {
+            for(const int frames : FrameCounts) {
+                const AudioFormat format{sampleFormat, 44100, channels};
+
+                SCOPED_TRACE(testing::Message() << "format: " << format.prettyFormat().toStdString()
+                                                << ", frames: " << frames);
+
+                const auto input = randomAudio(format, frames);
+
+                reducer.setFormat(format);
+                ASSERT_TRUE(reducer.reduce(input.data(), frames));
+
+                for(int channel{0}; channel < channels; ++channel) {
+                    const auto expected = referenceReduce(format, input, frames, channel);
+                    const auto sample   = reducer.sample(channel);
+
+                    // S32 is reduced as float and sums are accumulated per vector lane
+                    EXPECT_NEAR(expected.min, sample.min, 1e-6);
+                    EXPECT_NEAR(expected.max, sample.max, 1e-6);
+                    EXPECT_NEAR(expected.rms, sample.rms, 1e-4);
+                }
+            }
+        }
+    }
+}
+
+TEST(WaveformReducerTest, ReplacesPreviousResult)
+{
+    const AudioFormat format{SampleFormat::F32, 44100, 2};
+    const auto input = randomAudio(format, 1001);
+
+    WaveBar::WaveformReducer reducer;
+    reducer.setFormat(format);
+    reducer.reduce(input.data(), 1001);
+
+    // Only the final frame counts towards the second result
+    const auto offset = static_cast<ptrdiff_t>(format.bytesForFrames(1000));
+    reducer.reduce(input.data() + offset, 1);
+
+    const auto expected = referenceReduce(format, {input.begin() + offset, input.end()}, 1, 0);
+    const auto sample   = reducer.sample(0);
+
+    EXPECT_FLOAT_EQ(expected.min, sample.min);
+    EXPECT_FLOAT_EQ(expected.max, sample.max);
+    EXPECT_FLOAT_EQ(expected.rms, sample.rms);
+}
+
+TEST(WaveformReducerTest, StopsWhenCancelled)
+{
+    const AudioFormat format{SampleFormat::S16, 44100, 2};
+    const int frames = (WaveBar::WaveformReducer::BlockFrames * 2) + 1;
+    const auto input = randomAudio(format, frames);
+
+    int blocks{0};
+    WaveBar::WaveformReducer reducer;
+    reducer.setFormat(format);
+
+    EXPECT_FALSE(reducer.reduce(input.data(), frames, [&blocks]() { return ++blocks < 2; }));
+    EXPECT_EQ(2, blocks);
+}
+} // namespace Fooyin::Testing